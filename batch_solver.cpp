@@ -0,0 +1,327 @@
+#include "batch_solver.h"
+#include "numerical_solver.h"
+#include "heat_exchanger_geometry.h"
+#include "parallel_utils.h"
+#include "thermal_calculations.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace BatchSolver {
+
+    namespace {
+        // Cases per block; a compile-time width lets the lane loops vectorise without alias checks
+        constexpr int LANES = 64;
+
+        /**
+         * March one block of cases through every segment. Store is the storage and
+         * segment-coefficient type, Acc the type the temperatures and the duty
+         * are accumulated in.
+         */
+        template <typename Store, typename Acc>
+        void marchBlock(int count, int segments, const Store* p_in, const Store* q_in, const Store* rise_in,
+                        Acc* hot_out, Acc* cold_out, Acc* drop_out,
+                        Store* hot_profile, Store* cold_profile, long long stride) {
+            Store p[LANES], q[LANES];
+            Acc h[LANES], c[LANES], drop[LANES];
+            for (int j = 0; j < LANES; ++j) {
+                p[j] = (j < count) ? p_in[j] : Store(0);
+                q[j] = (j < count) ? q_in[j] : Store(0);
+                h[j] = (j < count) ? Acc(rise_in[j]) : Acc(0);
+                c[j] = Acc(0);
+                drop[j] = Acc(0);
+            }
+
+            if (hot_profile) {
+                for (int j = 0; j < count; ++j) {
+                    hot_profile[j] = Store(h[j]);
+                    cold_profile[j] = Store(c[j]);
+                }
+            }
+            for (int s = 1; s <= segments; ++s) {
+                for (int j = 0; j < LANES; ++j) {
+                    Acc d = h[j] - c[j];
+                    Acc dh = Acc(p[j]) * d;
+                    h[j] -= dh;
+                    c[j] += Acc(q[j]) * d;
+                    drop[j] += dh;
+                }
+                if (hot_profile) {
+                    Store* hot_row = hot_profile + s * stride;
+                    Store* cold_row = cold_profile + s * stride;
+                    for (int j = 0; j < count; ++j) {
+                        hot_row[j] = Store(h[j]);
+                        cold_row[j] = Store(c[j]);
+                    }
+                }
+            }
+
+            for (int j = 0; j < count; ++j) {
+                hot_out[j] = h[j];
+                cold_out[j] = c[j];
+                drop_out[j] = drop[j];
+            }
+        }
+
+        bool sameRatios(const UserCorrelations::GeometryRatios& ratios, const GeometryProperties& geometry) {
+            UserCorrelations::GeometryRatios other = UserCorrelations::GeometryRatios::fromGeometry(geometry);
+            return ratios.diameter_over_length == other.diameter_over_length &&
+                   ratios.outer_over_inner == other.outer_over_inner &&
+                   ratios.shell_over_tube == other.shell_over_tube &&
+                   ratios.tube_count == other.tube_count;
+        }
+
+        /**
+         * Nusselt numbers of a lane block from a user correlation, one batch call per
+         * run of cases that share geometry ratios (one call if the correlation ignores them)
+         */
+        void userNusselt(const UserCorrelations::Correlation& correlation, const BatchCase* cases, int count,
+                         const double* reynolds, const double* prandtl, double* nusselt) {
+            bool per_geometry = correlation.usesGeometry();
+            int begin = 0;
+            while (begin < count) {
+                UserCorrelations::GeometryRatios ratios =
+                    UserCorrelations::GeometryRatios::fromGeometry(cases[begin].geometry);
+                int end = begin + 1;
+                while (end < count && (!per_geometry || sameRatios(ratios, cases[end].geometry))) {
+                    ++end;
+                }
+                correlation.evaluate(reynolds + begin, prandtl + begin, static_cast<std::size_t>(end - begin),
+                                     ratios, nusselt + begin);
+                begin = end;
+            }
+        }
+
+        /**
+         * Replace the built-in Nusselt numbers of a lane block with the user correlations
+         * and re-form the film and overall coefficients as NumericalSolver does
+         */
+        void applyUserCorrelations(const BatchSettings& settings, const BatchCase* cases, int count,
+                                   NumericalSolver::SolutionResults* rated) {
+            double reynolds[LANES] = {}, prandtl[LANES] = {}, nusselt[LANES] = {};
+            if (settings.tube_correlation) {
+                for (int j = 0; j < count; ++j) {
+                    reynolds[j] = rated[j].cold_reynolds;
+                    prandtl[j] = cases[j].cold.prandtl;
+                }
+                userNusselt(*settings.tube_correlation, cases, count, reynolds, prandtl, nusselt);
+                for (int j = 0; j < count; ++j) {
+                    rated[j].cold_nusselt = nusselt[j];
+                }
+            }
+            if (settings.shell_correlation) {
+                for (int j = 0; j < count; ++j) {
+                    reynolds[j] = rated[j].hot_reynolds;
+                    prandtl[j] = cases[j].hot.prandtl;
+                }
+                userNusselt(*settings.shell_correlation, cases, count, reynolds, prandtl, nusselt);
+                for (int j = 0; j < count; ++j) {
+                    rated[j].hot_nusselt = nusselt[j];
+                }
+            }
+            for (int j = 0; j < count; ++j) {
+                const GeometryProperties& geometry = cases[j].geometry;
+                rated[j].cold_htc = rated[j].cold_nusselt * cases[j].cold.thermal_cond / geometry.tube_diameter;
+                rated[j].hot_htc = rated[j].hot_nusselt * cases[j].hot.thermal_cond / geometry.shell_diameter;
+                double inner_radius = geometry.tube_diameter / 2.0;
+                double outer_radius = inner_radius + geometry.tube_thickness;
+                rated[j].overall_htc = ThermalCalculations::overallHTC(
+                    rated[j].cold_htc, rated[j].hot_htc, inner_radius, outer_radius, geometry.wall_thermal_cond);
+            }
+        }
+
+        template <typename Store, typename Acc>
+        void solveBlocks(const std::vector<BatchCase>& cases, const BatchSettings& settings,
+                         BatchResults& results, std::vector<Store>& hot_profile, std::vector<Store>& cold_profile) {
+            long long n = static_cast<long long>(cases.size());
+            int N = settings.segments;
+            if (settings.store_profiles) {
+                hot_profile.assign(static_cast<size_t>(N + 1) * n, Store(0));
+                cold_profile.assign(static_cast<size_t>(N + 1) * n, Store(0));
+            }
+
+            long long blocks = (n + LANES - 1) / LANES;
+            ParallelUtils::parallelFor(0, blocks, settings.num_threads, [&](long long block) {
+                long long first = block * LANES;
+                int count = static_cast<int>(std::min<long long>(LANES, n - first));
+                Store p[LANES], q[LANES], rise[LANES];
+                double C_hot[LANES];
+                NumericalSolver::SolutionResults rated[LANES];
+                for (int j = 0; j < count; ++j) {
+                    const BatchCase& bc = cases[first + j];
+                    rated[j] = NumericalSolver(1, bc.geometry, bc.hot, bc.cold).ratingCoefficients();
+                }
+                if (settings.tube_correlation || settings.shell_correlation) {
+                    applyUserCorrelations(settings, cases.data() + first, count, rated);
+                }
+                for (int j = 0; j < count; ++j) {
+                    const BatchCase& bc = cases[first + j];
+                    const NumericalSolver::SolutionResults& coefficients = rated[j];
+                    double area = HeatExchangerGeometry::totalTubeArea(
+                        bc.geometry.tube_diameter, bc.geometry.length, bc.geometry.num_tubes);
+                    double UA_segment = coefficients.overall_htc * area / N;
+                    C_hot[j] = bc.hot.mass_flow * bc.hot.specific_heat;
+                    double C_cold = bc.cold.mass_flow * bc.cold.specific_heat;
+
+                    // Off-diagonal entries of the closed-form segment map (rows sum to one)
+                    double a = UA_segment / C_hot[j];
+                    double b = UA_segment / C_cold;
+                    double det = 1.0 - a * b / 4.0;
+                    p[j] = Store((a / 2.0 + (a / 2.0) * (1.0 - b)) / det);
+                    q[j] = Store(((b / 2.0) * (1.0 - a) + b / 2.0) / det);
+                    rise[j] = Store(bc.hot.inlet_temp - bc.cold.inlet_temp);
+
+                    results.overall_htc[first + j] = coefficients.overall_htc;
+                    results.reference_temperature[first + j] = bc.cold.inlet_temp;
+                }
+
+                Acc hot[LANES], cold[LANES], drop[LANES];
+                marchBlock<Store, Acc>(count, N, p, q, rise, hot, cold, drop,
+                                       settings.store_profiles ? hot_profile.data() + first : nullptr,
+                                       settings.store_profiles ? cold_profile.data() + first : nullptr, n);
+                for (int j = 0; j < count; ++j) {
+                    double reference = results.reference_temperature[first + j];
+                    results.hot_outlet[first + j] = reference + static_cast<double>(hot[j]);
+                    results.cold_outlet[first + j] = reference + static_cast<double>(cold[j]);
+                    results.duty[first + j] = C_hot[j] * static_cast<double>(drop[j]);
+                }
+            });
+        }
+
+        const char* precisionName(Precision precision) {
+            switch (precision) {
+                case Precision::Double: return "double";
+                case Precision::Single: return "single";
+                case Precision::Mixed:  return "mixed";
+            }
+            return "unknown";
+        }
+    }
+
+    BatchSettings::BatchSettings()
+        : segments(100), precision(Precision::Mixed), store_profiles(false), num_threads(0) {}
+
+    double BatchResults::hotTemperature(int index, int station) const {
+        size_t k = static_cast<size_t>(station) * cases + index;
+        return reference_temperature[index] +
+               (precision == Precision::Double ? hot_profile_double.at(k) : hot_profile_single.at(k));
+    }
+
+    double BatchResults::coldTemperature(int index, int station) const {
+        size_t k = static_cast<size_t>(station) * cases + index;
+        return reference_temperature[index] +
+               (precision == Precision::Double ? cold_profile_double.at(k) : cold_profile_single.at(k));
+    }
+
+    BatchResults solve(const std::vector<BatchCase>& cases, const BatchSettings& settings) {
+        if (settings.segments < 1) {
+            throw std::invalid_argument("Number of segments must be at least 1");
+        }
+        if (settings.tube_correlation && settings.tube_correlation->side() != UserCorrelations::Side::Tube) {
+            throw std::invalid_argument("Correlation " + settings.tube_correlation->name() +
+                                        " is not a tube-side correlation");
+        }
+        if (settings.shell_correlation && settings.shell_correlation->side() != UserCorrelations::Side::Shell) {
+            throw std::invalid_argument("Correlation " + settings.shell_correlation->name() +
+                                        " is not a shell-side correlation");
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        BatchResults results;
+        results.precision = settings.precision;
+        results.cases = static_cast<int>(cases.size());
+        results.segments = settings.segments;
+        results.hot_outlet.assign(cases.size(), 0.0);
+        results.cold_outlet.assign(cases.size(), 0.0);
+        results.duty.assign(cases.size(), 0.0);
+        results.overall_htc.assign(cases.size(), 0.0);
+        results.reference_temperature.assign(cases.size(), 0.0);
+
+        switch (settings.precision) {
+            case Precision::Double:
+                solveBlocks<double, double>(cases, settings, results,
+                                            results.hot_profile_double, results.cold_profile_double);
+                break;
+            case Precision::Single:
+                solveBlocks<float, float>(cases, settings, results,
+                                          results.hot_profile_single, results.cold_profile_single);
+                break;
+            case Precision::Mixed:
+                solveBlocks<float, double>(cases, settings, results,
+                                           results.hot_profile_single, results.cold_profile_single);
+                break;
+        }
+
+        results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return results;
+    }
+
+    void precisionStudy(const std::vector<BatchCase>& cases, int segments, int replicas) {
+        std::cout << "Performing precision study (" << cases.size() << " cases, " << segments << " segments)...\n";
+        std::cout << std::setw(10) << "Precision" << std::setw(18) << "Max |dT_out| (K)"
+                  << std::setw(18) << "Max |dT| (K)" << std::setw(16) << "Max dQ/Q"
+                  << std::setw(14) << "ns/case" << std::endl;
+        std::cout << std::string(76, '-') << std::endl;
+
+        std::ofstream file("precision_study.csv");
+        file << "Precision,Max_Outlet_Deviation_K,Max_Profile_Deviation_K,Max_Relative_Duty_Error,Time_ns_per_case\n";
+
+        BatchSettings settings;
+        settings.segments = segments;
+        settings.store_profiles = true;
+        settings.precision = Precision::Double;
+        BatchResults reference = solve(cases, settings);
+
+        std::vector<BatchCase> replicated;
+        replicated.reserve(cases.size() * std::max(1, replicas));
+        for (int r = 0; r < std::max(1, replicas); ++r) {
+            replicated.insert(replicated.end(), cases.begin(), cases.end());
+        }
+
+        for (Precision precision : {Precision::Double, Precision::Mixed, Precision::Single}) {
+            settings.precision = precision;
+            settings.store_profiles = true;
+            BatchResults run = solve(cases, settings);
+
+            double outlet_deviation = 0.0, profile_deviation = 0.0, duty_error = 0.0;
+            for (int c = 0; c < run.cases; ++c) {
+                if (!std::isfinite(reference.hot_outlet[c]) || !std::isfinite(reference.cold_outlet[c])) {
+                    continue;   // Invalid input (e.g. tubes filling the shell)
+                }
+                outlet_deviation = std::max(outlet_deviation, std::abs(run.hot_outlet[c] - reference.hot_outlet[c]));
+                outlet_deviation = std::max(outlet_deviation, std::abs(run.cold_outlet[c] - reference.cold_outlet[c]));
+                duty_error = std::max(duty_error, std::abs(run.duty[c] - reference.duty[c]) /
+                                                  std::max(std::abs(reference.duty[c]), 1e-300));
+                for (int s = 0; s <= segments; ++s) {
+                    profile_deviation = std::max(profile_deviation,
+                        std::abs(run.hotTemperature(c, s) - reference.hotTemperature(c, s)));
+                    profile_deviation = std::max(profile_deviation,
+                        std::abs(run.coldTemperature(c, s) - reference.coldTemperature(c, s)));
+                }
+            }
+
+            settings.store_profiles = false;
+            BatchResults timed = solve(replicated, settings);
+            double ns_per_case = 1e9 * timed.elapsed_seconds / std::max(1, timed.cases);
+
+            std::cout << std::setw(10) << precisionName(precision)
+                      << std::scientific << std::setprecision(2)
+                      << std::setw(18) << outlet_deviation
+                      << std::setw(18) << profile_deviation
+                      << std::setw(16) << duty_error
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << ns_per_case << std::endl;
+
+            file << precisionName(precision) << "," << outlet_deviation << "," << profile_deviation << ","
+                 << duty_error << "," << ns_per_case << "\n";
+        }
+
+        file.close();
+        std::cout << "Precision study results written to precision_study.csv\n";
+    }
+
+} // namespace BatchSolver
@@ -0,0 +1,99 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <memory>
+#include <vector>
+#include "fluid_properties.h"
+#include "user_correlations.h"
+
+/**
+ * @file batch_solver.h
+ * @brief High-throughput rating of many independent exchangers in single, mixed or double precision
+ *
+ * Each case is marched with the same segment recurrence that
+ * NumericalSolver::solveTemperatureDistributionScan() solves. That
+ * recurrence is the fixed point of solveTemperatureDistribution(), so no
+ * convergence loop is needed. The recurrence is written in increment form:
+ *   d = H - C,  H -= p d,  C += q d
+ * and temperatures are stored relative to the cold inlet. As a result,
+ * float keeps its 24 bits for the temperature rise rather than the absolute
+ * kelvin value. Cases are processed in fixed-width lane blocks with
+ * structure-of-arrays storage so the segment loop vectorises across cases.
+ * Film coefficients are computed once per case in double precision through
+ * NumericalSolver::ratingCoefficients(). When user correlations are set, the
+ * Reynolds and Prandtl numbers of a lane block are collected and passed to
+ * the correlation's batch interpreter in one call (one call per run of cases
+ * with equal geometry ratios if the correlation reads them). The Nusselt
+ * numbers it returns replace the built-in ones before U is formed.
+ */
+
+namespace BatchSolver {
+
+    enum class Precision {
+        Double,     // double storage and arithmetic (reference)
+        Single,     // float storage, arithmetic and accumulation
+        Mixed       // float storage and segment coefficients, double temperatures and duty accumulation
+    };
+
+    struct BatchCase {
+        GeometryProperties geometry;
+        FluidProperties hot;        // Shell side
+        FluidProperties cold;       // Tube side
+    };
+
+    struct BatchSettings {
+        int segments;
+        Precision precision;
+        bool store_profiles;        // Keep every station (segments + 1 values per case and stream)
+        int num_threads;            // 0 = hardware concurrency
+        std::shared_ptr<const UserCorrelations::Correlation> tube_correlation;   // Optional, replaces the tube-side Nusselt number
+        std::shared_ptr<const UserCorrelations::Correlation> shell_correlation;  // Optional, replaces the shell-side Nusselt number
+
+        BatchSettings();
+    };
+
+    struct BatchResults {
+        Precision precision;
+        int cases;
+        int segments;
+        std::vector<double> hot_outlet;         // K
+        std::vector<double> cold_outlet;        // K
+        std::vector<double> duty;               // W, sum of segment duties on the hot side
+        std::vector<double> overall_htc;        // W/m²·K
+        double elapsed_seconds;
+
+        /**
+         * Profile temperature (requires store_profiles)
+         * @param index Case index
+         * @param station Station 0..segments
+         * @return Temperature (K)
+         */
+        double hotTemperature(int index, int station) const;
+        double coldTemperature(int index, int station) const;
+
+        // Station-major profiles relative to the cold inlet; only the vectors of the run's precision are filled
+        std::vector<float> hot_profile_single, cold_profile_single;
+        std::vector<double> hot_profile_double, cold_profile_double;
+        std::vector<double> reference_temperature;  // Cold inlet per case
+    };
+
+    /**
+     * Rate every case
+     * @param cases Geometries and fluids
+     * @param settings Segments, precision, profile storage and threads
+     * @return Outlets, duties and optional profiles
+     */
+    BatchResults solve(const std::vector<BatchCase>& cases, const BatchSettings& settings = BatchSettings());
+
+    /**
+     * Compare single and mixed precision against double on the given cases
+     * (maximum outlet and profile deviation, duty error and time; written to precision_study.csv)
+     * @param cases Cases to rate
+     * @param segments Segments per case
+     * @param replicas Each case is repeated this many times for the timings
+     */
+    void precisionStudy(const std::vector<BatchCase>& cases, int segments = 100, int replicas = 10000);
+
+} // namespace BatchSolver
+
+#endif // BATCH_SOLVER_H
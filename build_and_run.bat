@@ -1,23 +1,36 @@
 @echo off
+setlocal
 echo Building Heat Exchanger Program...
 echo Compiling source files...
-g++ -std=c++17 -Wall -Wextra -c main.cpp
-if %errorlevel% neq 0 goto buildfailed
-g++ -std=c++17 -Wall -Wextra -c fluid_properties.cpp
-if %errorlevel% neq 0 goto buildfailed
-g++ -std=c++17 -Wall -Wextra -c dimensionless_numbers.cpp
-if %errorlevel% neq 0 goto buildfailed
-g++ -std=c++17 -Wall -Wextra -c heat_transfer_correlations.cpp
-if %errorlevel% neq 0 goto buildfailed
-g++ -std=c++17 -Wall -Wextra -c heat_exchanger_geometry.cpp
-if %errorlevel% neq 0 goto buildfailed
-g++ -std=c++17 -Wall -Wextra -c thermal_calculations.cpp
-if %errorlevel% neq 0 goto buildfailed
-g++ -std=c++17 -Wall -Wextra -c numerical_solver.cpp
-if %errorlevel% neq 0 goto buildfailed
+rem Keep this list in step with SOURCES in the Makefile
+set SOURCES=main.cpp fluid_properties.cpp dimensionless_numbers.cpp heat_transfer_correlations.cpp
+set SOURCES=%SOURCES% heat_exchanger_geometry.cpp thermal_calculations.cpp numerical_solver.cpp
+set SOURCES=%SOURCES% linear_solvers.cpp conjugate_model.cpp shell_side_model.cpp
+set SOURCES=%SOURCES% exchanger_network.cpp mapped_file.cpp historian_replay.cpp
+set SOURCES=%SOURCES% correlation_fitting.cpp fluid_database.cpp tube_layout.cpp
+set SOURCES=%SOURCES% design_optimizer.cpp pareto_search.cpp surrogate_model.cpp batch_solver.cpp
+set SOURCES=%SOURCES% solver_variants.cpp profile_stream.cpp checkpoint_journal.cpp sweep_runner.cpp
+set SOURCES=%SOURCES% results_store.cpp sharded_sweep.cpp
+set SOURCES=%SOURCES% phase_change_solver.cpp profile_codec.cpp results_ring.cpp user_correlations.cpp
+set SOURCES=%SOURCES% pinch_analysis.cpp
+for %%f in (%SOURCES%) do (
+    g++ -std=c++17 -Wall -Wextra -c %%f
+    if errorlevel 1 goto buildfailed
+)
 echo Linking executable...
-g++ -std=c++17 -Wall -Wextra -o heat_exchanger.exe *.o
-if %errorlevel% neq 0 goto buildfailed
+g++ -std=c++17 -Wall -Wextra -o heat_exchanger.exe %SOURCES:.cpp=.o%
+if %errorlevel% neq 0 goto buildfailed
+echo Building libthermocore...
+set LIB_OBJECTS=%SOURCES:.cpp=.o%
+set LIB_OBJECTS=%LIB_OBJECTS:main.o =%
+g++ -std=c++17 -Wall -Wextra -c thermocore.cpp -o thermocore.o
+if errorlevel 1 goto buildfailed
+ar rcs libthermocore.a %LIB_OBJECTS% thermocore.o
+if errorlevel 1 goto buildfailed
+g++ -std=c++17 -Wall -Wextra -DTHERMOCORE_BUILD -c thermocore.cpp -o thermocore.dll.o
+if errorlevel 1 goto buildfailed
+g++ -shared -o thermocore.dll %LIB_OBJECTS% thermocore.dll.o -Wl,--out-implib,libthermocore.dll.a
+if errorlevel 1 goto buildfailed
 echo Build successful!
 echo.
 echo Running Heat Exchanger Program...
@@ -0,0 +1,30 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+
+/**
+ * @file cancellation_token.h
+ * @brief Flag one thread sets to stop long-running work on another
+ *
+ * Solvers poll the token at short intervals (see NumericalSolver::solveAnytime)
+ * and return their best result so far once it is set. A token can be shared
+ * by any number of solves and reused after reset().
+ */
+
+class CancellationToken {
+public:
+    CancellationToken() : flag(false) {}
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    void cancel() { flag.store(true, std::memory_order_release); }
+    void reset() { flag.store(false, std::memory_order_release); }
+    bool cancelled() const { return flag.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<bool> flag;
+};
+
+#endif // CANCELLATION_TOKEN_H
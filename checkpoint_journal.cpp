@@ -0,0 +1,235 @@
+#include "checkpoint_journal.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    const char JOURNAL_MAGIC[8] = {'T', 'C', 'J', 'O', 'U', 'R', 'N', '1'};
+    constexpr std::uint32_t RECORD_MARKER = 0x5243454aU;       // "JECR"
+    constexpr size_t HEADER_BYTES = 8 + 8 + 4;
+    constexpr size_t RECORD_HEAD_BYTES = 4 + 4 + 8 + 8;
+
+    // 64-bit size of an open file (ftell is 32-bit on Windows); -1 on failure
+    long long fileSize(std::FILE* file) {
+#if defined(_WIN32)
+        if (_fseeki64(file, 0, SEEK_END) != 0) {
+            return -1;
+        }
+        long long bytes = _ftelli64(file);
+        return _fseeki64(file, 0, SEEK_SET) == 0 ? bytes : -1;
+#else
+        if (fseeko(file, 0, SEEK_END) != 0) {
+            return -1;
+        }
+        long long bytes = static_cast<long long>(ftello(file));
+        return fseeko(file, 0, SEEK_SET) == 0 ? bytes : -1;
+#endif
+    }
+
+    // Slicing-by-8 tables: entries[k][b] is the CRC of byte b followed by k zero bytes
+    struct CrcTable {
+        std::uint32_t entries[8][256];
+
+        CrcTable() {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1U) ? 0xedb88320U ^ (c >> 1) : c >> 1;
+                }
+                entries[0][i] = c;
+            }
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                for (int k = 1; k < 8; ++k) {
+                    entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xffU];
+                }
+            }
+        }
+    };
+
+    bool syncFile(std::FILE* file) {
+        if (std::fflush(file) != 0) {
+            return false;
+        }
+#if defined(_WIN32)
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+}
+
+CheckpointJournal::CheckpointJournal() : file(nullptr), replayed_records(0), discarded_bytes(0) {}
+
+CheckpointJournal::~CheckpointJournal() {
+    close();
+}
+
+std::uint32_t CheckpointJournal::crc32(const void* data, size_t bytes, std::uint32_t crc) {
+    static const CrcTable table;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    // Eight bytes per step (little-endian word order); the byte loop handles the rest
+    const std::uint16_t probe = 1;
+    unsigned char first_byte;
+    std::memcpy(&first_byte, &probe, 1);
+    if (first_byte == 1) {
+        for (; bytes >= 8; bytes -= 8, p += 8) {
+            std::uint32_t low, high;
+            std::memcpy(&low, p, 4);
+            std::memcpy(&high, p + 4, 4);
+            low ^= crc;
+            crc = table.entries[7][low & 0xffU] ^ table.entries[6][(low >> 8) & 0xffU] ^
+                  table.entries[5][(low >> 16) & 0xffU] ^ table.entries[4][low >> 24] ^
+                  table.entries[3][high & 0xffU] ^ table.entries[2][(high >> 8) & 0xffU] ^
+                  table.entries[1][(high >> 16) & 0xffU] ^ table.entries[0][high >> 24];
+        }
+    }
+    for (; bytes > 0; --bytes, ++p) {
+        crc = table.entries[0][(crc ^ *p) & 0xffU] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::uint64_t CheckpointJournal::fnv1a(const void* data, size_t bytes, std::uint64_t hash) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool CheckpointJournal::open(const std::string& path, std::uint64_t fingerprint, const ReplayCallback& replay) {
+    close();
+    replayed_records = 0;
+    discarded_bytes = 0;
+
+    unsigned char header[HEADER_BYTES];
+    std::memcpy(header, JOURNAL_MAGIC, 8);
+    std::memcpy(header + 8, &fingerprint, 8);
+    std::uint32_t header_crc = crc32(header, 16);
+    std::memcpy(header + 16, &header_crc, 4);
+
+    // Replay the intact prefix of an existing journal
+    long long good_bytes = 0;
+    long long file_bytes = 0;
+    if (std::FILE* input = std::fopen(path.c_str(), "rb")) {
+        file_bytes = fileSize(input);
+        if (file_bytes < 0) {
+            std::fclose(input);
+            std::cerr << "Error: Could not read the size of journal " << path << "\n";
+            return false;
+        }
+
+        unsigned char existing[HEADER_BYTES];
+        if (std::fread(existing, 1, HEADER_BYTES, input) == HEADER_BYTES) {
+            if (std::memcmp(existing, header, HEADER_BYTES) != 0) {
+                std::fclose(input);
+                std::cerr << "Error: " << path << " is not a checkpoint journal for this job\n";
+                return false;
+            }
+            good_bytes = HEADER_BYTES;
+
+            std::vector<char> payload;
+            unsigned char head[RECORD_HEAD_BYTES];
+            while (std::fread(head, 1, RECORD_HEAD_BYTES, input) == RECORD_HEAD_BYTES) {
+                std::uint32_t marker, bytes, stored_crc;
+                Record record;
+                std::memcpy(&marker, head, 4);
+                std::memcpy(&bytes, head + 4, 4);
+                std::memcpy(&record.begin, head + 8, 8);
+                std::memcpy(&record.end, head + 16, 8);
+                if (marker != RECORD_MARKER ||
+                    static_cast<long long>(bytes) > file_bytes - good_bytes - static_cast<long long>(RECORD_HEAD_BYTES)) {
+                    break;
+                }
+                payload.resize(bytes);
+                if (std::fread(payload.data(), 1, bytes, input) != bytes ||
+                    std::fread(&stored_crc, 1, 4, input) != 4 ||
+                    crc32(payload.data(), bytes, crc32(head, RECORD_HEAD_BYTES)) != stored_crc) {
+                    break;
+                }
+                record.payload = payload.data();
+                record.bytes = bytes;
+                replay(record);
+                ++replayed_records;
+                good_bytes += static_cast<long long>(RECORD_HEAD_BYTES + bytes + 4);
+            }
+        }
+        std::fclose(input);
+    }
+
+    // Cut a torn tail so new records follow the last good one
+    std::error_code error;
+    if (good_bytes < file_bytes) {
+        discarded_bytes = file_bytes - good_bytes;
+        std::filesystem::resize_file(path, static_cast<std::uintmax_t>(good_bytes), error);
+        if (error) {
+            std::cerr << "Error: Could not truncate journal " << path << "\n";
+            return false;
+        }
+    }
+
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        std::cerr << "Error: Could not open journal " << path << " for writing\n";
+        return false;
+    }
+    if (good_bytes == 0 && (std::fwrite(header, 1, HEADER_BYTES, file) != HEADER_BYTES || !syncFile(file))) {
+        std::cerr << "Error: Could not write journal header to " << path << "\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointJournal::append(long long begin, long long end, const void* payload, size_t bytes) {
+    Span part{payload, bytes};
+    return append(begin, end, &part, 1);
+}
+
+bool CheckpointJournal::append(long long begin, long long end, const Span* parts, int count) {
+    size_t bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        bytes += parts[i].bytes;
+    }
+    if (!file || bytes > 0xffffffffULL) {
+        return false;
+    }
+    unsigned char head[RECORD_HEAD_BYTES];
+    std::uint32_t marker = RECORD_MARKER;
+    std::uint32_t size = static_cast<std::uint32_t>(bytes);
+    std::memcpy(head, &marker, 4);
+    std::memcpy(head + 4, &size, 4);
+    std::memcpy(head + 8, &begin, 8);
+    std::memcpy(head + 16, &end, 8);
+    std::uint32_t crc = crc32(head, RECORD_HEAD_BYTES);
+    for (int i = 0; i < count; ++i) {
+        crc = crc32(parts[i].data, parts[i].bytes, crc);
+    }
+
+    // After a failed write nothing more is appended behind the partial record
+    bool written = std::fwrite(head, 1, RECORD_HEAD_BYTES, file) == RECORD_HEAD_BYTES;
+    for (int i = 0; i < count && written; ++i) {
+        written = parts[i].bytes == 0 || std::fwrite(parts[i].data, 1, parts[i].bytes, file) == parts[i].bytes;
+    }
+    if (!written || std::fwrite(&crc, 1, 4, file) != 4 || !syncFile(file)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CheckpointJournal::close() {
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
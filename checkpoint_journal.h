@@ -0,0 +1,104 @@
+#ifndef CHECKPOINT_JOURNAL_H
+#define CHECKPOINT_JOURNAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+/**
+ * @file checkpoint_journal.h
+ * @brief Append-only, checksummed progress journal for resumable jobs
+ *
+ * File layout (native byte order):
+ *   header:  "TCJOURN1", uint64 job fingerprint, uint32 CRC-32 of the preceding 16 bytes
+ *   records: uint32 marker, uint32 payload bytes, int64 begin, int64 end,
+ *            payload, uint32 CRC-32 of everything before it in the record
+ * Each record states that work items [begin, end) are complete and carries
+ * the job's data for them. append() returns only after fsync, so a crash
+ * can leave at most one torn record at the tail. open() stops at the first
+ * record that is incomplete or fails its checksum and cuts the file back to
+ * the last good record.
+ */
+
+class CheckpointJournal {
+public:
+    struct Record {
+        long long begin;
+        long long end;
+        const char* payload;    // Valid only during the replay callback
+        size_t bytes;
+    };
+
+    struct Span {
+        const void* data;
+        size_t bytes;
+    };
+
+    using ReplayCallback = std::function<void(const Record&)>;
+
+    CheckpointJournal();
+    ~CheckpointJournal();
+
+    CheckpointJournal(const CheckpointJournal&) = delete;
+    CheckpointJournal& operator=(const CheckpointJournal&) = delete;
+
+    /**
+     * Open an existing journal and replay its records, or create a new one
+     * @param path Journal file
+     * @param fingerprint Identifies the job; a journal written for another job is rejected
+     * @param replay Called for every intact record in file order
+     * @return false if the file cannot be used (I/O error or fingerprint mismatch)
+     */
+    bool open(const std::string& path, std::uint64_t fingerprint, const ReplayCallback& replay);
+
+    /**
+     * Durably append one record (returns after fsync)
+     * @param begin First completed item
+     * @param end One past the last completed item
+     * @param payload Job data for the range
+     * @param bytes Payload size
+     * @return false on a write error (the journal is closed)
+     */
+    bool append(long long begin, long long end, const void* payload, size_t bytes);
+
+    /**
+     * Append one record whose payload is the concatenation of several spans
+     * (written in place, without assembling a copy)
+     * @param begin First completed item
+     * @param end One past the last completed item
+     * @param parts Payload pieces in order
+     * @param count Number of pieces
+     * @return false on a write error (the journal is closed)
+     */
+    bool append(long long begin, long long end, const Span* parts, int count);
+
+    void close();
+
+    bool isOpen() const { return file != nullptr; }
+    long long recordsReplayed() const { return replayed_records; }
+    long long bytesDiscarded() const { return discarded_bytes; }   // Torn or corrupt tail cut by open()
+
+    /**
+     * CRC-32 (IEEE 802.3 polynomial)
+     * @param data Bytes to checksum
+     * @param bytes Number of bytes
+     * @param crc Running value from a previous call (0 to start)
+     */
+    static std::uint32_t crc32(const void* data, size_t bytes, std::uint32_t crc = 0);
+
+    /**
+     * 64-bit FNV-1a hash for building job fingerprints
+     * @param data Bytes to hash
+     * @param bytes Number of bytes
+     * @param hash Running value from a previous call
+     */
+    static std::uint64_t fnv1a(const void* data, size_t bytes, std::uint64_t hash = 14695981039346656037ULL);
+
+private:
+    std::FILE* file;
+    long long replayed_records;
+    long long discarded_bytes;
+};
+
+#endif // CHECKPOINT_JOURNAL_H
@@ -0,0 +1,168 @@
+#include "conjugate_model.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+ConjugateHeatTransferModel::ConjugateHeatTransferModel(int axial, int layers,
+                                                       const GeometryProperties& geom,
+                                                       const FluidProperties& hot,
+                                                       const FluidProperties& cold)
+    : axial_cells(axial), wall_layers(layers), geometry(geom), hot_fluid(hot), cold_fluid(cold) {
+    if (axial_cells < 1 || wall_layers < 1) {
+        throw std::invalid_argument("Conjugate model needs at least one axial cell and one wall layer");
+    }
+    settings.tolerance = 1e-8;
+    settings.max_iterations = 2000;
+    settings.preconditioner = LinearSolvers::Preconditioner::LineGaussSeidel;
+}
+
+void ConjugateHeatTransferModel::setSolverSettings(const LinearSolvers::IterativeSettings& solver_settings) {
+    settings = solver_settings;
+}
+
+int ConjugateHeatTransferModel::unknownCount() const {
+    return axial_cells * (wall_layers + 2);
+}
+
+ConjugateHeatTransferModel::ConjugateResults ConjugateHeatTransferModel::solve(bool use_1d_initial_guess) {
+    ConjugateResults results;
+    const int N = axial_cells;
+    const int R = wall_layers;
+    const int block = R + 2;
+
+    // The 1-D scan solve supplies the film coefficients and the initial guess
+    NumericalSolver one_d(N, geometry, hot_fluid, cold_fluid);
+    NumericalSolver::SolutionResults guess = one_d.solveTemperatureDistributionScan(settings.num_threads);
+
+    // Ring boundaries are spaced geometrically so every ring has equal radial resistance
+    double dx = geometry.length / N;
+    double r_in = geometry.tube_diameter / 2.0;
+    double r_out = r_in + geometry.tube_thickness;
+    double k_wall = geometry.wall_thermal_cond;
+
+    std::vector<double> rho(R + 1), r_center(R);
+    for (int k = 0; k <= R; ++k) {
+        rho[k] = r_in * std::pow(r_out / r_in, static_cast<double>(k) / R);
+    }
+    for (int k = 0; k < R; ++k) {
+        r_center[k] = std::sqrt(rho[k] * rho[k + 1]);
+    }
+
+    // Conductances per tube and per axial cell (W/K)
+    double G_inner = 1.0 / (1.0 / (guess.cold_htc * 2.0 * M_PI * r_in * dx) +
+                            std::log(r_center[0] / r_in) / (2.0 * M_PI * k_wall * dx));
+    double G_outer = 1.0 / (std::log(r_out / r_center[R - 1]) / (2.0 * M_PI * k_wall * dx) +
+                            1.0 / (guess.hot_htc * 2.0 * M_PI * r_out * dx));
+    std::vector<double> G_radial(R > 1 ? R - 1 : 0), G_axial(R);
+    for (int k = 0; k + 1 < R; ++k) {
+        G_radial[k] = 2.0 * M_PI * k_wall * dx / std::log(r_center[k + 1] / r_center[k]);
+    }
+    for (int k = 0; k < R; ++k) {
+        G_axial[k] = k_wall * M_PI * (rho[k + 1] * rho[k + 1] - rho[k] * rho[k]) / dx;
+    }
+
+    double C_cold = cold_fluid.mass_flow * cold_fluid.specific_heat / geometry.num_tubes;
+    double C_hot = hot_fluid.mass_flow * hot_fluid.specific_heat / geometry.num_tubes;
+
+    // Assemble in line-major ordering [cold line, wall ring lines, hot line]: every
+    // axial line is a contiguous tridiagonal block, so the line preconditioner
+    // resolves advection and axial conduction exactly and only sweeps radially
+    int n = N * block;
+    auto index = [N](int line, int j) { return line * N + j; };
+    SparseMatrix A(n, 5);
+    std::vector<double> b(n, 0.0);
+
+    // Tube-side fluid: upwind advection plus film exchange with the inner ring
+    for (int j = 0; j < N; ++j) {
+        int row = index(0, j);
+        A.addEntry(row, C_cold + G_inner);
+        A.addEntry(index(1, j), -G_inner);
+        if (j > 0) {
+            A.addEntry(row - 1, -C_cold);
+        } else {
+            b[row] = C_cold * cold_fluid.inlet_temp;
+        }
+        A.finishRow();
+    }
+
+    // Wall rings: radial and axial conduction (adiabatic tube ends)
+    for (int k = 0; k < R; ++k) {
+        double G_lower = (k == 0) ? G_inner : G_radial[k - 1];
+        double G_upper = (k == R - 1) ? G_outer : G_radial[k];
+        for (int j = 0; j < N; ++j) {
+            int row = index(k + 1, j);
+            double diag = G_lower + G_upper;
+
+            A.addEntry(index(k, j), -G_lower);
+            A.addEntry(index(k + 2, j), -G_upper);
+            if (j > 0) {
+                A.addEntry(row - 1, -G_axial[k]);
+                diag += G_axial[k];
+            }
+            if (j < N - 1) {
+                A.addEntry(row + 1, -G_axial[k]);
+                diag += G_axial[k];
+            }
+
+            A.addEntry(row, diag);
+            A.finishRow();
+        }
+    }
+
+    // Shell-side fluid: upwind advection plus film exchange with the outer ring
+    for (int j = 0; j < N; ++j) {
+        int row = index(R + 1, j);
+        A.addEntry(row, C_hot + G_outer);
+        A.addEntry(index(R, j), -G_outer);
+        if (j > 0) {
+            A.addEntry(row - 1, -C_hot);
+        } else {
+            b[row] = C_hot * hot_fluid.inlet_temp;
+        }
+        A.finishRow();
+    }
+
+    // Initial guess
+    std::vector<double> x(n);
+    for (int j = 0; j < N; ++j) {
+        double T_cold = use_1d_initial_guess ? guess.cold_temperatures[N - (j + 1)] : cold_fluid.inlet_temp;
+        double T_hot = use_1d_initial_guess ? guess.hot_temperatures[j + 1] : hot_fluid.inlet_temp;
+        x[index(0, j)] = T_cold;
+        x[index(R + 1, j)] = T_hot;
+        for (int k = 0; k < R; ++k) {
+            double ratio = (k + 0.5) / R;
+            x[index(k + 1, j)] = T_cold + ratio * (T_hot - T_cold);
+        }
+    }
+
+    LinearSolvers::IterativeSettings line_settings = settings;
+    line_settings.line_length = N;
+    LinearSolvers::IterativeResult solve_info = LinearSolvers::biCGStab(A, b, x, line_settings);
+
+    // Unpack into the NumericalSolver layout (cold stored in reverse station order)
+    results.profile = guess;
+    results.profile.hot_temperatures[0] = hot_fluid.inlet_temp;
+    results.profile.cold_temperatures[N] = cold_fluid.inlet_temp;
+    results.wall_temperatures.resize(static_cast<size_t>(N) * R);
+    for (int j = 0; j < N; ++j) {
+        results.profile.cold_temperatures[N - (j + 1)] = x[index(0, j)];
+        results.profile.hot_temperatures[j + 1] = x[index(R + 1, j)];
+        for (int k = 0; k < R; ++k) {
+            results.wall_temperatures[static_cast<size_t>(j) * R + k] = x[index(k + 1, j)];
+        }
+    }
+
+    results.wall_layers = R;
+    results.unknowns = n;
+    results.iterations = solve_info.iterations;
+    results.relative_residual = solve_info.relative_residual;
+    results.converged = solve_info.converged;
+    results.heat_duty = hot_fluid.mass_flow * hot_fluid.specific_heat *
+                        (hot_fluid.inlet_temp - results.profile.hot_temperatures[N]);
+
+    return results;
+}
@@ -0,0 +1,60 @@
+#ifndef CONJUGATE_MODEL_H
+#define CONJUGATE_MODEL_H
+
+#include <vector>
+#include "fluid_properties.h"
+#include "numerical_solver.h"
+#include "linear_solvers.h"
+
+/**
+ * @file conjugate_model.h
+ * @brief Two-dimensional (axial x radial) conjugate fluid/wall/fluid model
+ *
+ * Each axial station holds the tube-side bulk temperature, wall_layers
+ * radial wall rings and the shell-side bulk temperature of one tube's unit
+ * cell. The wall conducts both radially and axially, so axial wall conduction
+ * and radial wall gradients are resolved; the films use the same correlations
+ * as NumericalSolver. Flow directions follow solveTemperatureDistribution().
+ */
+
+class ConjugateHeatTransferModel {
+private:
+    int axial_cells;
+    int wall_layers;
+    GeometryProperties geometry;
+    FluidProperties hot_fluid;
+    FluidProperties cold_fluid;
+    LinearSolvers::IterativeSettings settings;
+
+public:
+    struct ConjugateResults {
+        NumericalSolver::SolutionResults profile;  // Bulk profiles, same layout as NumericalSolver
+        std::vector<double> wall_temperatures;     // axial_cells x wall_layers, inner ring first
+        int wall_layers;
+        int unknowns;
+        int iterations;
+        double relative_residual;
+        bool converged;
+        double heat_duty;                          // Hot-side duty (W)
+    };
+
+    ConjugateHeatTransferModel(int axial, int layers, const GeometryProperties& geom,
+                               const FluidProperties& hot, const FluidProperties& cold);
+
+    /**
+     * Set linear solver options (tolerance, threads, preconditioner)
+     * @param solver_settings Iterative solver settings
+     */
+    void setSolverSettings(const LinearSolvers::IterativeSettings& solver_settings);
+
+    /**
+     * Assemble and solve the conjugate system with BiCGSTAB
+     * @param use_1d_initial_guess Start from the 1-D scan solution instead of inlet temperatures
+     * @return Bulk and wall temperatures plus solver statistics
+     */
+    ConjugateResults solve(bool use_1d_initial_guess = true);
+
+    int unknownCount() const;
+};
+
+#endif // CONJUGATE_MODEL_H
@@ -0,0 +1,326 @@
+#include "correlation_fitting.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace CorrelationFitting {
+
+    namespace {
+        // Log-transformed data shared by every start
+        struct FitData {
+            std::vector<double> log_re;
+            std::vector<double> log_pr;
+            std::vector<double> inv_nu;
+            std::vector<double> log_nu;
+        };
+
+        struct StartResult {
+            double params[3];   // C, m, n
+            double cost;
+            int iterations;
+            bool converged;
+        };
+
+        // Accumulate 0.5 * sum(r^2) and, when requested, J^T J and J^T r
+        double evaluate(const FitData& data, const double* p, double* JtJ, double* Jtr) {
+            double cost = 0.0;
+            size_t n_points = data.log_re.size();
+            if (JtJ) {
+                std::fill(JtJ, JtJ + 9, 0.0);
+                std::fill(Jtr, Jtr + 3, 0.0);
+            }
+            for (size_t i = 0; i < n_points; ++i) {
+                double power = std::exp(p[1] * data.log_re[i] + p[2] * data.log_pr[i]);
+                double model = p[0] * power * data.inv_nu[i];
+                double r = model - 1.0;
+                cost += r * r;
+                if (JtJ) {
+                    // dr/dC = power / Nu, dr/dm = model * ln Re, dr/dn = model * ln Pr
+                    double J[3] = {power * data.inv_nu[i], model * data.log_re[i], model * data.log_pr[i]};
+                    for (int a = 0; a < 3; ++a) {
+                        Jtr[a] += J[a] * r;
+                        for (int b = a; b < 3; ++b) {
+                            JtJ[3 * a + b] += J[a] * J[b];
+                        }
+                    }
+                }
+            }
+            if (JtJ) {
+                JtJ[3] = JtJ[1];
+                JtJ[6] = JtJ[2];
+                JtJ[7] = JtJ[5];
+            }
+            return 0.5 * cost;
+        }
+
+        // Solve a 3x3 system by Gaussian elimination with partial pivoting
+        bool solve3(double A[9], double b[3], double x[3]) {
+            int order[3] = {0, 1, 2};
+            for (int col = 0; col < 3; ++col) {
+                int pivot = col;
+                for (int r = col + 1; r < 3; ++r) {
+                    if (std::abs(A[3 * order[r] + col]) > std::abs(A[3 * order[pivot] + col])) {
+                        pivot = r;
+                    }
+                }
+                std::swap(order[col], order[pivot]);
+                double diag = A[3 * order[col] + col];
+                if (std::abs(diag) < 1e-300) {
+                    return false;
+                }
+                for (int r = col + 1; r < 3; ++r) {
+                    double factor = A[3 * order[r] + col] / diag;
+                    for (int c = col; c < 3; ++c) {
+                        A[3 * order[r] + c] -= factor * A[3 * order[col] + c];
+                    }
+                    b[order[r]] -= factor * b[order[col]];
+                }
+            }
+            for (int col = 2; col >= 0; --col) {
+                double sum = b[order[col]];
+                for (int c = col + 1; c < 3; ++c) {
+                    sum -= A[3 * order[col] + c] * x[c];
+                }
+                x[col] = sum / A[3 * order[col] + col];
+            }
+            return true;
+        }
+
+        StartResult levenbergMarquardt(const FitData& data, const double* start, const FitSettings& settings) {
+            StartResult result;
+            std::copy(start, start + 3, result.params);
+            result.iterations = 0;
+            result.converged = false;
+
+            double JtJ[9], Jtr[3];
+            double cost = evaluate(data, result.params, JtJ, Jtr);
+            double lambda = 1e-3;
+
+            for (int iter = 0; iter < settings.max_iterations; ++iter) {
+                result.iterations = iter + 1;
+                bool accepted = false;
+
+                // Raise damping until the step reduces the cost
+                while (lambda < 1e12) {
+                    double A[9], b[3], step[3];
+                    for (int k = 0; k < 9; ++k) {
+                        A[k] = JtJ[k];
+                    }
+                    for (int a = 0; a < 3; ++a) {
+                        A[4 * a] += lambda * std::max(JtJ[4 * a], 1e-12);
+                        b[a] = -Jtr[a];
+                    }
+                    if (settings.fix_prandtl_exponent) {
+                        A[2] = A[5] = A[6] = A[7] = 0.0;
+                        A[8] = 1.0;
+                        b[2] = 0.0;
+                    }
+                    if (!solve3(A, b, step)) {
+                        lambda *= 10.0;
+                        continue;
+                    }
+
+                    double trial[3] = {result.params[0] + step[0], result.params[1] + step[1],
+                                       result.params[2] + step[2]};
+                    double trial_cost = (trial[0] > 0.0) ? evaluate(data, trial, nullptr, nullptr) : HUGE_VAL;
+                    if (trial_cost < cost) {
+                        double reduction = (cost - trial_cost) / std::max(cost, 1e-300);
+                        std::copy(trial, trial + 3, result.params);
+                        cost = evaluate(data, result.params, JtJ, Jtr);
+                        lambda = std::max(lambda / 10.0, 1e-12);
+                        accepted = true;
+                        if (reduction < settings.tolerance) {
+                            result.converged = true;
+                        }
+                        break;
+                    }
+                    lambda *= 10.0;
+                }
+
+                if (!accepted) {
+                    // No descent step left: the start sits at a minimum to working precision
+                    result.converged = true;
+                }
+                if (result.converged) {
+                    break;
+                }
+            }
+
+            result.cost = cost;
+            return result;
+        }
+    } // anonymous namespace
+
+    FitSettings::FitSettings()
+        : starts(16), max_iterations(100), tolerance(1e-12), min_reynolds(2300.0),
+          fix_prandtl_exponent(false), initial_guess{0.023, 0.8, 0.4}, num_threads(0) {}
+
+    FitSettings FitSettings::shellSide() {
+        FitSettings settings;
+        settings.min_reynolds = 2000.0;
+        settings.initial_guess = HeatTransferCorrelations::textbookPowerLawSet().shell;
+        return settings;
+    }
+
+    FitResult fitPowerLaw(const std::vector<OperatingPoint>& points, const FitSettings& settings) {
+        auto start_time = std::chrono::steady_clock::now();
+        FitResult fit;
+        fit.coefficients = settings.initial_guess;
+        fit.rms_relative_error = 0.0;
+        fit.max_relative_error = 0.0;
+        fit.points_used = 0;
+        fit.iterations = 0;
+        fit.starts_converged = 0;
+        fit.converged = false;
+
+        FitData data;
+        data.log_re.reserve(points.size());
+        data.log_pr.reserve(points.size());
+        data.inv_nu.reserve(points.size());
+        data.log_nu.reserve(points.size());
+        for (const OperatingPoint& point : points) {
+            if (point.reynolds <= 0.0 || point.prandtl <= 0.0 || point.nusselt <= 0.0 ||
+                point.reynolds < settings.min_reynolds) {
+                continue;
+            }
+            data.log_re.push_back(std::log(point.reynolds));
+            data.log_pr.push_back(std::log(point.prandtl));
+            data.inv_nu.push_back(1.0 / point.nusselt);
+            data.log_nu.push_back(std::log(point.nusselt));
+        }
+        fit.points_used = static_cast<long long>(data.log_re.size());
+        if (fit.points_used < 3) {
+            fit.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            return fit;
+        }
+
+        // Starts: the initial guess, then exponents spread over a lattice with C
+        // set to its log-space optimum for those exponents
+        int starts = std::max(1, settings.starts);
+        std::vector<std::vector<double>> start_points(starts, std::vector<double>(3));
+        for (int s = 0; s < starts; ++s) {
+            double m = settings.initial_guess.m;
+            double n = settings.initial_guess.n;
+            if (s > 0) {
+                m = 0.4 + 0.6 * std::fmod(s * 0.6180339887498949, 1.0);
+                if (!settings.fix_prandtl_exponent) {
+                    n = 0.25 + 0.25 * std::fmod(s * 0.7548776662466927, 1.0);
+                }
+            }
+            double log_c = 0.0;
+            for (size_t i = 0; i < data.log_re.size(); ++i) {
+                log_c += data.log_nu[i] - m * data.log_re[i] - n * data.log_pr[i];
+            }
+            double C = (s == 0) ? settings.initial_guess.C : std::exp(log_c / data.log_re.size());
+            start_points[s] = {C, m, n};
+        }
+
+        std::vector<StartResult> results(starts);
+        ParallelUtils::parallelFor(0, starts, settings.num_threads, [&](long long s) {
+            results[s] = levenbergMarquardt(data, start_points[s].data(), settings);
+        });
+
+        int best = 0;
+        for (int s = 0; s < starts; ++s) {
+            if (results[s].converged) {
+                ++fit.starts_converged;
+            }
+            if (results[s].cost < results[best].cost) {
+                best = s;
+            }
+        }
+
+        const StartResult& winner = results[best];
+        fit.coefficients = {winner.params[0], winner.params[1], winner.params[2]};
+        fit.iterations = winner.iterations;
+        fit.converged = winner.converged;
+        fit.rms_relative_error = std::sqrt(2.0 * winner.cost / fit.points_used);
+        for (size_t i = 0; i < data.log_re.size(); ++i) {
+            double model = fit.coefficients.C *
+                std::exp(fit.coefficients.m * data.log_re[i] + fit.coefficients.n * data.log_pr[i]);
+            fit.max_relative_error = std::max(fit.max_relative_error, std::abs(model * data.inv_nu[i] - 1.0));
+        }
+        fit.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return fit;
+    }
+
+    bool loadOperatingPoints(const std::string& filename, std::vector<OperatingPoint>& points) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        std::getline(file, line);  // Header
+        while (std::getline(file, line)) {
+            const char* cursor = line.c_str();
+            char* end = nullptr;
+            OperatingPoint point;
+            double* fields[3] = {&point.reynolds, &point.prandtl, &point.nusselt};
+            bool parsed = true;
+            for (int f = 0; f < 3 && parsed; ++f) {
+                *fields[f] = std::strtod(cursor, &end);
+                parsed = (end != cursor);
+                cursor = end;
+                if (f < 2) {
+                    parsed = parsed && (*cursor == ',');
+                    ++cursor;
+                }
+            }
+            if (parsed) {
+                points.push_back(point);
+            }
+        }
+        return true;
+    }
+
+    bool saveCorrelationSet(const std::string& filename, const HeatTransferCorrelations::CorrelationSet& set) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << "# Nu = C * Re^m * Pr^n\n";
+        file << std::setprecision(17);
+        file << "tube_C " << set.tube.C << "\n";
+        file << "tube_m " << set.tube.m << "\n";
+        file << "tube_n " << set.tube.n << "\n";
+        file << "shell_C " << set.shell.C << "\n";
+        file << "shell_m " << set.shell.m << "\n";
+        file << "shell_n " << set.shell.n << "\n";
+        return file.good();
+    }
+
+    bool loadCorrelationSet(const std::string& filename, HeatTransferCorrelations::CorrelationSet& set) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        set = HeatTransferCorrelations::textbookPowerLawSet();
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string key;
+            double value;
+            if (!(fields >> key >> value)) {
+                continue;
+            }
+            if (key == "tube_C") set.tube.C = value;
+            else if (key == "tube_m") set.tube.m = value;
+            else if (key == "tube_n") set.tube.n = value;
+            else if (key == "shell_C") set.shell.C = value;
+            else if (key == "shell_m") set.shell.m = value;
+            else if (key == "shell_n") set.shell.n = value;
+        }
+        return true;
+    }
+
+} // namespace CorrelationFitting
@@ -0,0 +1,90 @@
+#ifndef CORRELATION_FITTING_H
+#define CORRELATION_FITTING_H
+
+#include <string>
+#include <vector>
+#include "heat_transfer_correlations.h"
+
+/**
+ * @file correlation_fitting.h
+ * @brief Calibration of power-law Nusselt correlations against measured operating points
+ *
+ * Fits Nu = C * Re^m * Pr^n by Levenberg-Marquardt on the relative residuals
+ * (Nu_model - Nu_measured) / Nu_measured with the analytic Jacobian. Several
+ * starting points are run concurrently and the lowest-cost fit is kept. The
+ * fitted sets are saved as plain text and loaded at runtime by
+ * NumericalSolver::setCorrelationSet().
+ */
+
+namespace CorrelationFitting {
+
+    struct OperatingPoint {
+        double reynolds;
+        double prandtl;
+        double nusselt;         // Measured, e.g. h * D / k from a plant film coefficient
+    };
+
+    struct FitSettings {
+        int starts;                 // Multi-start count
+        int max_iterations;         // Per start
+        double tolerance;           // Relative cost reduction that ends a start
+        double min_reynolds;        // Points below are excluded (laminar range of the side)
+        bool fix_prandtl_exponent;  // Keep n at initial_guess.n when Pr barely varies in the data
+        HeatTransferCorrelations::PowerLawCoefficients initial_guess;
+        int num_threads;            // 0 = hardware concurrency
+
+        /** Tube side: points below Re 2300 excluded, Dittus-Boelter initial guess */
+        FitSettings();
+
+        /** Shell side: points below Re 2000 excluded, staggered-bundle initial guess */
+        static FitSettings shellSide();
+    };
+
+    struct FitResult {
+        HeatTransferCorrelations::PowerLawCoefficients coefficients;
+        double rms_relative_error;
+        double max_relative_error;
+        long long points_used;
+        int iterations;             // Of the best start
+        int starts_converged;
+        bool converged;
+        double elapsed_seconds;
+    };
+
+    /**
+     * Fit C, m and n to measured operating points
+     * @param points Measured Reynolds, Prandtl and Nusselt numbers
+     * @param settings Starts, iteration limits and thread count
+     * @return Best coefficients and error statistics
+     */
+    FitResult fitPowerLaw(const std::vector<OperatingPoint>& points,
+                          const FitSettings& settings = FitSettings());
+
+    /**
+     * Read operating points from CSV (reynolds,prandtl,nusselt with one header line)
+     * @param filename Input file
+     * @param points Parsed points (non-numeric rows are skipped)
+     * @return false if the file cannot be opened
+     */
+    bool loadOperatingPoints(const std::string& filename, std::vector<OperatingPoint>& points);
+
+    /**
+     * Write a coefficient set as "key value" lines (tube_C, tube_m, tube_n, shell_C, ...)
+     * @param filename Output file
+     * @param set Coefficient set
+     * @return false if the file cannot be written
+     */
+    bool saveCorrelationSet(const std::string& filename, const HeatTransferCorrelations::CorrelationSet& set);
+
+    /**
+     * Read a coefficient set written by saveCorrelationSet; missing keys keep the
+     * textbookPowerLawSet() values
+     * @param filename Input file
+     * @param set Loaded coefficient set
+     * @return false if the file cannot be opened
+     */
+    bool loadCorrelationSet(const std::string& filename, HeatTransferCorrelations::CorrelationSet& set);
+
+} // namespace CorrelationFitting
+
+#endif // CORRELATION_FITTING_H
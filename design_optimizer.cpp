@@ -0,0 +1,218 @@
+#include "design_optimizer.h"
+#include "numerical_solver.h"
+#include "thermal_calculations.h"
+#include "tube_layout.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace DesignOptimizer {
+
+    namespace {
+        // Cross-section: everything except the length
+        struct Section {
+            int shell;
+            int tube;
+            int pitch;
+            int passes;
+            int layout;
+            int num_tubes;
+            double overall_htc;
+            double ua_per_length;   // W/K per metre (inner tube surface, as in NumericalSolver)
+        };
+
+        struct Candidate {
+            int section;
+            int length;
+            double cost;
+            double duty_bound;
+        };
+
+        // Same checks as TubeLayoutGenerator::generate(), made before any worker starts
+        void validateCatalogue(const DesignCatalogue& catalogue) {
+            for (double shell_diameter : catalogue.shell_diameters)
+                for (const TubeSize& tube : catalogue.tube_sizes)
+                    for (double pitch_ratio : catalogue.pitch_ratios) {
+                        if (shell_diameter <= 0.0 || tube.outer_diameter <= 0.0 || pitch_ratio < 1.0) {
+                            throw std::invalid_argument("Tube layout needs positive diameters and a pitch ratio of at least 1");
+                        }
+                    }
+            for (int passes : catalogue.tube_passes) {
+                if (passes < 1 || (passes > 1 && passes % 2 != 0)) {
+                    throw std::invalid_argument("Tube passes must be 1 or an even number");
+                }
+            }
+        }
+    }
+
+    DesignCatalogue::DesignCatalogue()
+        : layouts{HeatExchangerGeometry::TubeLayout::Triangular30}, wall_thermal_cond(50.0) {}
+
+    CostModel::CostModel()
+        : fixed(5000.0), per_tube_area(250.0), per_shell_area(400.0), per_extra_pass(800.0) {}
+
+    double CostModel::cost(double tube_area, double shell_diameter, double length, int tube_passes) const {
+        return fixed + per_tube_area * tube_area + per_shell_area * M_PI * shell_diameter * length +
+               per_extra_pass * (tube_passes - 1);
+    }
+
+    OptimizerSettings::OptimizerSettings()
+        : top_k(10), segments(40), bound_margin(1.01), num_threads(0) {}
+
+    OptimizationReport optimize(const DesignCatalogue& catalogue, const Service& service,
+                                const CostModel& cost_model, const OptimizerSettings& settings) {
+        validateCatalogue(catalogue);
+        auto start = std::chrono::steady_clock::now();
+        OptimizationReport report;
+        report.pruned_no_tubes = 0;
+        report.pruned_by_bound = 0;
+        report.pruned_by_cost = 0;
+        report.solved = 0;
+        report.infeasible = 0;
+
+        std::vector<double> lengths = catalogue.lengths;
+        std::sort(lengths.begin(), lengths.end());
+        long long num_lengths = static_cast<long long>(lengths.size());
+
+        std::vector<Section> sections;
+        for (int s = 0; s < static_cast<int>(catalogue.shell_diameters.size()); ++s)
+            for (int t = 0; t < static_cast<int>(catalogue.tube_sizes.size()); ++t)
+                for (int p = 0; p < static_cast<int>(catalogue.pitch_ratios.size()); ++p)
+                    for (int n = 0; n < static_cast<int>(catalogue.tube_passes.size()); ++n)
+                        for (int l = 0; l < static_cast<int>(catalogue.layouts.size()); ++l)
+                            sections.push_back({s, t, p, n, l, 0, 0.0, 0.0});
+        report.candidates = static_cast<long long>(sections.size()) * num_lengths;
+
+        double C_hot = ThermalCalculations::heatCapacityRate(service.hot.mass_flow, service.hot.specific_heat);
+        double C_cold = ThermalCalculations::heatCapacityRate(service.cold.mass_flow, service.cold.specific_heat);
+        double C_min = std::min(C_hot, C_cold);
+        double C_ratio = C_min / std::max(C_hot, C_cold);
+        double Q_max = ThermalCalculations::maximumHeatTransfer(C_min, service.hot.inlet_temp, service.cold.inlet_temp);
+
+        auto geometryFor = [&](const Section& section, double length) {
+            const TubeSize& tube = catalogue.tube_sizes[section.tube];
+            return GeometryProperties(length, catalogue.shell_diameters[section.shell],
+                                      tube.outer_diameter - 2.0 * tube.wall_thickness, tube.wall_thickness,
+                                      section.num_tubes, catalogue.wall_thermal_cond);
+        };
+        auto dutyBound = [&](const Section& section, double length) {
+            int passes = catalogue.tube_passes[section.passes];
+            double ntu = ThermalCalculations::calculateNTU(section.ua_per_length * length, C_min);
+            double eff = ThermalCalculations::effectiveness_NTU(ntu, C_ratio, passes > 1 ? 3 : 0);
+            return settings.bound_margin * eff * Q_max;
+        };
+
+        // Tube counts and film coefficients once per cross-section
+        ParallelUtils::parallelFor(0, static_cast<long long>(sections.size()), settings.num_threads,
+            [&](long long i) {
+                Section& section = sections[i];
+                const TubeSize& tube = catalogue.tube_sizes[section.tube];
+                TubeLayoutSpec spec(catalogue.shell_diameters[section.shell], tube.outer_diameter,
+                                    catalogue.pitch_ratios[section.pitch], catalogue.layouts[section.layout]);
+                spec.tube_passes = catalogue.tube_passes[section.passes];
+                section.num_tubes = TubeLayoutGenerator::countTubes(spec);
+                if (section.num_tubes < spec.tube_passes || tube.outer_diameter <= 2.0 * tube.wall_thickness) {
+                    section.num_tubes = 0;
+                    return;
+                }
+                NumericalSolver solver(1, geometryFor(section, 1.0), service.hot, service.cold);
+                section.overall_htc = solver.ratingCoefficients(spec.tube_passes).overall_htc;
+                section.ua_per_length = section.overall_htc *
+                    HeatExchangerGeometry::totalTubeArea(tube.outer_diameter - 2.0 * tube.wall_thickness,
+                                                         1.0, section.num_tubes);
+            });
+
+        // Bound pruning: the shortest length whose bound reaches the duty, per cross-section
+        std::vector<Candidate> survivors;
+        for (int i = 0; i < static_cast<int>(sections.size()); ++i) {
+            const Section& section = sections[i];
+            if (section.num_tubes == 0) {
+                report.pruned_no_tubes += num_lengths;
+                continue;
+            }
+            long long first = 0;
+            while (first < num_lengths && dutyBound(section, lengths[first]) < service.required_duty) {
+                ++first;
+            }
+            report.pruned_by_bound += first;
+            for (long long l = first; l < num_lengths; ++l) {
+                double tube_area = HeatExchangerGeometry::totalTubeArea(
+                    catalogue.tube_sizes[section.tube].outer_diameter, lengths[l], section.num_tubes);
+                double cost = cost_model.cost(tube_area, catalogue.shell_diameters[section.shell], lengths[l],
+                                              catalogue.tube_passes[section.passes]);
+                survivors.push_back({i, static_cast<int>(l), cost, dutyBound(section, lengths[l])});
+            }
+        }
+        std::sort(survivors.begin(), survivors.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.cost < b.cost; });
+
+        // Solve survivors cheapest first until the top-k can no longer change
+        int top_k = std::max(1, settings.top_k);
+        int threads = ParallelUtils::resolveThreadCount(settings.num_threads);
+        size_t batch_size = static_cast<size_t>(std::max(top_k, 2 * threads));
+        std::vector<Design> batch_designs;
+        std::vector<char> batch_feasible;
+        size_t next = 0;
+        while (next < survivors.size()) {
+            double cutoff = (static_cast<int>(report.designs.size()) >= top_k) ? report.designs.back().cost : HUGE_VAL;
+            size_t end = next;
+            while (end < survivors.size() && end - next < batch_size && survivors[end].cost < cutoff) {
+                ++end;
+            }
+            if (end == next) {
+                break;
+            }
+
+            batch_designs.assign(end - next, Design());
+            batch_feasible.assign(end - next, 0);
+            ParallelUtils::parallelFor(0, static_cast<long long>(end - next), settings.num_threads,
+                [&](long long b) {
+                    const Candidate& candidate = survivors[next + b];
+                    const Section& section = sections[candidate.section];
+                    int passes = catalogue.tube_passes[section.passes];
+                    double length = lengths[candidate.length];
+
+                    Design& design = batch_designs[b];
+                    design.geometry = geometryFor(section, length);
+                    design.pitch_ratio = catalogue.pitch_ratios[section.pitch];
+                    design.layout = catalogue.layouts[section.layout];
+                    design.tube_passes = passes;
+                    design.tube_area = HeatExchangerGeometry::totalTubeArea(
+                        catalogue.tube_sizes[section.tube].outer_diameter, length, section.num_tubes);
+                    design.cost = candidate.cost;
+                    design.duty_bound = candidate.duty_bound;
+                    design.overall_htc = section.overall_htc;
+
+                    NumericalSolver solver(settings.segments, design.geometry, service.hot, service.cold);
+                    design.duty = solver.solveMultiPass(passes).heat_duty;
+                    batch_feasible[b] = design.duty >= service.required_duty;
+                });
+
+            report.solved += static_cast<long long>(end - next);
+            for (size_t b = 0; b < end - next; ++b) {
+                if (batch_feasible[b]) {
+                    report.designs.push_back(batch_designs[b]);
+                } else {
+                    ++report.infeasible;
+                }
+            }
+            std::sort(report.designs.begin(), report.designs.end(),
+                      [](const Design& a, const Design& b) { return a.cost < b.cost; });
+            if (static_cast<int>(report.designs.size()) > top_k) {
+                report.designs.resize(top_k);
+            }
+            next = end;
+        }
+        report.pruned_by_cost = static_cast<long long>(survivors.size() - next);
+
+        report.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+} // namespace DesignOptimizer
@@ -0,0 +1,108 @@
+#ifndef DESIGN_OPTIMIZER_H
+#define DESIGN_OPTIMIZER_H
+
+#include <vector>
+#include "fluid_properties.h"
+#include "heat_exchanger_geometry.h"
+
+/**
+ * @file design_optimizer.h
+ * @brief Cheapest catalogue exchangers meeting a duty, with bound-based pruning
+ *
+ * Every combination of shell diameter, tube size, pitch, layout, pass count and
+ * length is a candidate. Tube counts (TubeLayoutGenerator) and film
+ * coefficients depend only on the cross-section, so they are computed once
+ * per cross-section and shared by all lengths. The ε-NTU effectiveness of the
+ * arrangement (counter-current for one pass, 1-2N otherwise) bounds the
+ * NumericalSolver duty from above and grows with length. Any length whose
+ * bound misses the duty is pruned with all shorter lengths. A cross-section
+ * whose longest length misses it is pruned as a whole. Survivors are solved
+ * in parallel in order of increasing cost. The search stops once the
+ * cheapest k feasible designs are known.
+ */
+
+namespace DesignOptimizer {
+
+    struct TubeSize {
+        double outer_diameter;      // m
+        double wall_thickness;      // m (gauge)
+    };
+
+    struct DesignCatalogue {
+        std::vector<double> shell_diameters;    // m
+        std::vector<TubeSize> tube_sizes;
+        std::vector<double> lengths;            // m
+        std::vector<double> pitch_ratios;
+        std::vector<int> tube_passes;
+        std::vector<HeatExchangerGeometry::TubeLayout> layouts;
+        double wall_thermal_cond;               // W/m·K
+
+        DesignCatalogue();
+    };
+
+    struct CostModel {
+        double fixed;               // Per unit
+        double per_tube_area;       // Per m² of outside tube surface
+        double per_shell_area;      // Per m² of shell wall (π D L)
+        double per_extra_pass;      // Per tube pass beyond the first
+
+        CostModel();
+
+        double cost(double tube_area, double shell_diameter, double length, int tube_passes) const;
+    };
+
+    struct Service {
+        FluidProperties hot;        // Shell side; inlet_temp, mass_flow and properties are used
+        FluidProperties cold;       // Tube side
+        double required_duty;       // W
+    };
+
+    struct OptimizerSettings {
+        int top_k;
+        int segments;               // NumericalSolver segments per survivor
+        double bound_margin;        // Multiplies the ε-NTU bound to cover discretisation error
+        int num_threads;            // 0 = hardware concurrency
+
+        OptimizerSettings();
+    };
+
+    struct Design {
+        GeometryProperties geometry;
+        double pitch_ratio;
+        HeatExchangerGeometry::TubeLayout layout;
+        int tube_passes;
+        double tube_area;           // Outside surface (m²)
+        double cost;
+        double duty;                // NumericalSolver duty (W)
+        double duty_bound;          // ε-NTU upper bound (W)
+        double overall_htc;         // W/m²·K
+    };
+
+    struct OptimizationReport {
+        std::vector<Design> designs;    // Cheapest feasible, ascending cost
+        long long candidates;
+        long long pruned_no_tubes;      // Cross-section holds no tubes
+        long long pruned_by_bound;      // Duty bound below the requirement
+        long long pruned_by_cost;       // Costlier than the k-th feasible design, never solved
+        long long solved;
+        long long infeasible;           // Solved but short of the duty
+        double elapsed_seconds;
+    };
+
+    /**
+     * Search the catalogue for the cheapest designs meeting the duty (throws
+     * std::invalid_argument for a non-positive diameter, a pitch ratio below 1
+     * or an odd pass count other than 1, before any candidate is rated)
+     * @param catalogue Discrete design options
+     * @param service Fluids, flows, inlet temperatures and required duty
+     * @param cost_model Capital cost estimate
+     * @param settings Top-k, solver resolution and threads
+     * @return Ranked designs and pruning statistics
+     */
+    OptimizationReport optimize(const DesignCatalogue& catalogue, const Service& service,
+                                const CostModel& cost_model = CostModel(),
+                                const OptimizerSettings& settings = OptimizerSettings());
+
+} // namespace DesignOptimizer
+
+#endif // DESIGN_OPTIMIZER_H
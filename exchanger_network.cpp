@@ -0,0 +1,318 @@
+#include "exchanger_network.h"
+#include "numerical_solver.h"
+#include "thermal_calculations.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+ExchangerNetwork::NetworkSettings::NetworkSettings()
+    : tolerance(1e-6), flow_tolerance(1e-9), htc_tolerance(1e-6), max_iterations(200), num_threads(0), use_wegstein(true),
+      q_min(-5.0), q_max(0.0) {}
+
+int ExchangerNetwork::addStream(const std::string& name, int producer) {
+    streams.push_back({name, FluidProperties(), producer, -1});
+    return static_cast<int>(streams.size()) - 1;
+}
+
+int ExchangerNetwork::addFeed(const std::string& name, const FluidProperties& fluid) {
+    int id = addStream(name, -1);
+    streams[id].state = fluid;
+    return id;
+}
+
+int ExchangerNetwork::addTearStream(const std::string& name, const FluidProperties& initial_guess) {
+    return addFeed(name, initial_guess);
+}
+
+void ExchangerNetwork::closeTear(int tear_stream, int source_stream) {
+    if (tear_stream < 0 || tear_stream >= static_cast<int>(streams.size()) ||
+        source_stream < 0 || source_stream >= static_cast<int>(streams.size())) {
+        throw std::out_of_range("Unknown stream id in closeTear");
+    }
+    if (streams[tear_stream].producer != -1) {
+        throw std::invalid_argument("Only tear streams can be closed onto a source stream");
+    }
+    streams[tear_stream].tear_source = source_stream;
+}
+
+int ExchangerNetwork::addExchanger(const std::string& name, const GeometryProperties& geometry,
+                                   int hot_inlet, int cold_inlet, int segments) {
+    Unit unit;
+    unit.name = name;
+    unit.type = UnitType::Exchanger;
+    unit.inlets = {hot_inlet, cold_inlet};
+    unit.geometry = geometry;
+    unit.segments = segments;
+    int id = static_cast<int>(units.size());
+    units.push_back(unit);
+    units[id].outlets.push_back(addStream(name + ".hot_out", id));
+    units[id].outlets.push_back(addStream(name + ".cold_out", id));
+    return id;
+}
+
+int ExchangerNetwork::addMixer(const std::string& name, const std::vector<int>& inlets) {
+    Unit unit;
+    unit.name = name;
+    unit.type = UnitType::Mixer;
+    unit.inlets = inlets;
+    unit.segments = 0;
+    int id = static_cast<int>(units.size());
+    units.push_back(unit);
+    units[id].outlets.push_back(addStream(name + ".out", id));
+    return id;
+}
+
+int ExchangerNetwork::addSplitter(const std::string& name, int inlet, const std::vector<double>& fractions) {
+    Unit unit;
+    unit.name = name;
+    unit.type = UnitType::Splitter;
+    unit.inlets = {inlet};
+    unit.segments = 0;
+    unit.fractions = fractions;
+    int id = static_cast<int>(units.size());
+    units.push_back(unit);
+    for (size_t i = 0; i < fractions.size(); ++i) {
+        units[id].outlets.push_back(addStream(name + ".out" + std::to_string(i), id));
+    }
+    return id;
+}
+
+int ExchangerNetwork::hotOutlet(int exchanger) const {
+    return outlet(exchanger, 0);
+}
+
+int ExchangerNetwork::coldOutlet(int exchanger) const {
+    return outlet(exchanger, 1);
+}
+
+int ExchangerNetwork::outlet(int unit, int index) const {
+    return units.at(unit).outlets.at(index);
+}
+
+std::vector<std::vector<int>> ExchangerNetwork::topologicalLevels() const {
+    // Kahn's algorithm on unit dependencies; feeds and tears carry no dependency
+    int n = static_cast<int>(units.size());
+    std::vector<int> pending(n, 0);
+    std::vector<std::vector<int>> consumers(n);
+    for (int u = 0; u < n; ++u) {
+        for (int s : units[u].inlets) {
+            int producer = streams.at(s).producer;
+            if (producer >= 0) {
+                ++pending[u];
+                consumers[producer].push_back(u);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> levels;
+    std::vector<int> current;
+    for (int u = 0; u < n; ++u) {
+        if (pending[u] == 0) {
+            current.push_back(u);
+        }
+    }
+
+    int scheduled = 0;
+    while (!current.empty()) {
+        levels.push_back(current);
+        scheduled += static_cast<int>(current.size());
+        std::vector<int> next;
+        for (int u : current) {
+            for (int c : consumers[u]) {
+                if (--pending[c] == 0) {
+                    next.push_back(c);
+                }
+            }
+        }
+        current.swap(next);
+    }
+
+    if (scheduled != n) {
+        throw std::runtime_error("Network contains a recycle loop without a tear stream");
+    }
+    return levels;
+}
+
+ExchangerNetwork::UnitResult ExchangerNetwork::evaluateUnit(int unit_id,
+                                                            std::vector<FluidProperties>& states) const {
+    const Unit& unit = units[unit_id];
+    UnitResult result{unit.name, 0.0, 0.0, 0.0, 0.0};
+
+    switch (unit.type) {
+        case UnitType::Exchanger: {
+            FluidProperties hot = states[unit.inlets[0]];
+            FluidProperties cold = states[unit.inlets[1]];
+            NumericalSolver solver(unit.segments, unit.geometry, hot, cold);
+            NumericalSolver::SolutionResults solution = solver.solveTemperatureDistributionScan(1);
+
+            result.hot_outlet_temp = solution.hot_temperatures[unit.segments];
+            result.cold_outlet_temp = solution.cold_temperatures[0];
+            result.overall_htc = solution.overall_htc;
+            result.heat_duty = ThermalCalculations::actualHeatTransfer(
+                hot.mass_flow, hot.specific_heat, hot.inlet_temp, result.hot_outlet_temp);
+
+            FluidProperties hot_out = hot;
+            hot_out.inlet_temp = result.hot_outlet_temp;
+            FluidProperties cold_out = cold;
+            cold_out.inlet_temp = result.cold_outlet_temp;
+            states[unit.outlets[0]] = hot_out;
+            states[unit.outlets[1]] = cold_out;
+            break;
+        }
+
+        case UnitType::Mixer: {
+            // Adiabatic mixing: capacity-rate weighted temperature, flow-weighted properties
+            FluidProperties mixed;
+            double total_flow = 0.0, total_capacity = 0.0, enthalpy = 0.0;
+            for (int s : unit.inlets) {
+                const FluidProperties& in = states[s];
+                double C = ThermalCalculations::heatCapacityRate(in.mass_flow, in.specific_heat);
+                total_flow += in.mass_flow;
+                total_capacity += C;
+                enthalpy += C * in.inlet_temp;
+                mixed.density += in.mass_flow * in.density;
+                mixed.thermal_cond += in.mass_flow * in.thermal_cond;
+                mixed.viscosity += in.mass_flow * in.viscosity;
+            }
+            if (total_flow > 0.0) {
+                mixed.mass_flow = total_flow;
+                mixed.specific_heat = total_capacity / total_flow;
+                mixed.inlet_temp = enthalpy / total_capacity;
+                mixed.outlet_temp = mixed.inlet_temp;
+                mixed.density /= total_flow;
+                mixed.thermal_cond /= total_flow;
+                mixed.viscosity /= total_flow;
+                mixed.prandtl = mixed.specific_heat * mixed.viscosity / mixed.thermal_cond;
+            }
+            states[unit.outlets[0]] = mixed;
+            break;
+        }
+
+        case UnitType::Splitter: {
+            for (size_t i = 0; i < unit.outlets.size(); ++i) {
+                FluidProperties out = states[unit.inlets[0]];
+                out.mass_flow *= unit.fractions[i];
+                states[unit.outlets[i]] = out;
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
+ExchangerNetwork::NetworkResults ExchangerNetwork::solve(const NetworkSettings& settings) {
+    NetworkResults results;
+    results.iterations = 0;
+    results.max_tear_error = 0.0;
+    results.max_flow_error = 0.0;
+    results.max_htc_change = 0.0;
+    results.converged = false;
+
+    std::vector<std::vector<int>> levels = topologicalLevels();
+
+    std::vector<int> tears;
+    for (int s = 0; s < static_cast<int>(streams.size()); ++s) {
+        if (streams[s].tear_source >= 0) {
+            tears.push_back(s);
+        }
+    }
+
+    std::vector<FluidProperties> states(streams.size());
+    for (size_t s = 0; s < streams.size(); ++s) {
+        states[s] = streams[s].state;
+    }
+    results.units.resize(units.size());
+
+    // Wegstein works per tear variable (temperature and mass flow)
+    size_t num_vars = tears.size() * 2;
+    std::vector<double> x(num_vars), g(num_vars), x_prev(num_vars), g_prev(num_vars);
+    auto readTear = [&](std::vector<double>& v, bool from_source) {
+        for (size_t t = 0; t < tears.size(); ++t) {
+            int s = from_source ? streams[tears[t]].tear_source : tears[t];
+            v[2 * t] = states[s].inlet_temp;
+            v[2 * t + 1] = states[s].mass_flow;
+        }
+    };
+    readTear(x, false);
+
+    std::vector<double> htc_prev(units.size(), 0.0);
+
+    int max_iterations = tears.empty() ? 1 : settings.max_iterations;
+    for (int iter = 0; iter < max_iterations; ++iter) {
+        for (size_t t = 0; t < tears.size(); ++t) {
+            // Properties follow the source once it has been computed; T and flow come from x
+            FluidProperties tear_state = (iter == 0) ? states[tears[t]]
+                                                     : states[streams[tears[t]].tear_source];
+            tear_state.inlet_temp = x[2 * t];
+            tear_state.mass_flow = x[2 * t + 1];
+            states[tears[t]] = tear_state;
+        }
+
+        for (const auto& level : levels) {
+            ParallelUtils::parallelFor(0, static_cast<long long>(level.size()), settings.num_threads,
+                [&](long long i) {
+                    int u = level[i];
+                    results.units[u] = evaluateUnit(u, states);
+                });
+        }
+        results.iterations = iter + 1;
+
+        if (tears.empty()) {
+            results.converged = true;
+            break;
+        }
+
+        readTear(g, true);
+        // Temperatures are compared in K, flows relative to the source flow
+        double max_error = 0.0;
+        double max_flow_error = 0.0;
+        for (size_t t = 0; t < tears.size(); ++t) {
+            max_error = std::max(max_error, std::abs(g[2 * t] - x[2 * t]));
+            max_flow_error = std::max(max_flow_error, std::abs(g[2 * t + 1] - x[2 * t + 1]) /
+                                                      std::max(std::abs(g[2 * t + 1]), 1e-300));
+        }
+        results.max_tear_error = max_error;
+        results.max_flow_error = max_flow_error;
+
+        // U has no previous value on the first pass, so that pass never counts as settled
+        double max_htc_change = (iter == 0) ? 1.0 : 0.0;
+        for (size_t u = 0; u < units.size(); ++u) {
+            if (units[u].type != UnitType::Exchanger) {
+                continue;
+            }
+            double htc = results.units[u].overall_htc;
+            if (iter > 0) {
+                max_htc_change = std::max(max_htc_change,
+                                          std::abs(htc - htc_prev[u]) / std::max(std::abs(htc), 1e-300));
+            }
+            htc_prev[u] = htc;
+        }
+        results.max_htc_change = max_htc_change;
+
+        if (max_error < settings.tolerance && max_flow_error < settings.flow_tolerance &&
+            max_htc_change < settings.htc_tolerance) {
+            results.converged = true;
+            break;
+        }
+
+        for (size_t v = 0; v < num_vars; ++v) {
+            double x_new = g[v];
+            if (settings.use_wegstein && iter > 0 && std::abs(x[v] - x_prev[v]) > 1e-12) {
+                double slope = (g[v] - g_prev[v]) / (x[v] - x_prev[v]);
+                if (std::abs(slope - 1.0) > 1e-12) {
+                    double q = slope / (slope - 1.0);
+                    q = std::max(settings.q_min, std::min(settings.q_max, q));
+                    x_new = q * x[v] + (1.0 - q) * g[v];
+                }
+            }
+            x_prev[v] = x[v];
+            g_prev[v] = g[v];
+            x[v] = x_new;
+        }
+    }
+
+    results.streams = states;
+    return results;
+}
@@ -0,0 +1,148 @@
+#ifndef EXCHANGER_NETWORK_H
+#define EXCHANGER_NETWORK_H
+
+#include <string>
+#include <vector>
+#include "fluid_properties.h"
+
+/**
+ * @file exchanger_network.h
+ * @brief Flowsheet of heat exchangers, mixers and splitters connected by streams
+ *
+ * Units are connected through stream ids. Recycle loops are opened with tear
+ * streams: a tear is created with an initial guess, used as an inlet, and later
+ * closed onto the stream that actually feeds it. With tears treated as inputs
+ * the unit graph is acyclic; it is solved level by level in topological order
+ * (units on one level run in parallel) and the tears are converged with
+ * accelerated successive substitution (Wegstein).
+ */
+
+class ExchangerNetwork {
+public:
+    struct UnitResult {
+        std::string name;
+        double heat_duty;        // W, exchangers only
+        double hot_outlet_temp;  // K, exchangers only
+        double cold_outlet_temp; // K, exchangers only
+        double overall_htc;      // W/m²·K, exchangers only
+    };
+
+    struct NetworkResults {
+        std::vector<UnitResult> units;
+        std::vector<FluidProperties> streams;   // Converged stream states (inlet_temp = stream temperature)
+        int iterations;
+        double max_tear_error;                  // K
+        double max_flow_error;                  // Largest relative mismatch of a tear mass flow
+        double max_htc_change;                  // Largest relative change of an exchanger U in the last iteration
+        bool converged;
+    };
+
+    struct NetworkSettings {
+        double tolerance;        // Tear temperature tolerance (K)
+        double flow_tolerance;   // Tear mass flow tolerance (relative to the source flow)
+        double htc_tolerance;    // Relative change of every exchanger U between iterations
+        int max_iterations;
+        int num_threads;         // Units per topological level solved concurrently (0 = hardware)
+        bool use_wegstein;       // false = plain successive substitution
+        double q_min;            // Wegstein acceleration bounds
+        double q_max;
+
+        NetworkSettings();
+    };
+
+    /**
+     * Add an external feed stream
+     * @param name Stream name
+     * @param fluid Fluid properties; inlet_temp is the stream temperature
+     * @return Stream id
+     */
+    int addFeed(const std::string& name, const FluidProperties& fluid);
+
+    /**
+     * Add a tear stream that opens a recycle loop
+     * @param name Stream name
+     * @param initial_guess Initial guess for the recycled stream state
+     * @return Stream id usable as a unit inlet
+     */
+    int addTearStream(const std::string& name, const FluidProperties& initial_guess);
+
+    /**
+     * Close a tear onto the stream that feeds it
+     * @param tear_stream Stream id returned by addTearStream
+     * @param source_stream Stream whose computed state the tear must match
+     */
+    void closeTear(int tear_stream, int source_stream);
+
+    /**
+     * Add a shell-and-tube exchanger (hot fluid on the shell side)
+     * @param name Unit name
+     * @param geometry Exchanger geometry
+     * @param hot_inlet Stream id of the hot inlet
+     * @param cold_inlet Stream id of the cold inlet
+     * @param segments Segments for the NumericalSolver scan solve
+     * @return Unit id
+     */
+    int addExchanger(const std::string& name, const GeometryProperties& geometry,
+                     int hot_inlet, int cold_inlet, int segments = 50);
+
+    /**
+     * Add an adiabatic mixer
+     * @param name Unit name
+     * @param inlets Stream ids to mix
+     * @return Unit id
+     */
+    int addMixer(const std::string& name, const std::vector<int>& inlets);
+
+    /**
+     * Add a splitter
+     * @param name Unit name
+     * @param inlet Stream id to split
+     * @param fractions Mass fraction sent to each outlet (should sum to 1)
+     * @return Unit id
+     */
+    int addSplitter(const std::string& name, int inlet, const std::vector<double>& fractions);
+
+    int hotOutlet(int exchanger) const;
+    int coldOutlet(int exchanger) const;
+    int outlet(int unit, int index = 0) const;
+
+    /**
+     * Solve the network
+     * @param settings Tolerance, iteration limit, threads and acceleration options
+     * @return Per-unit duties, stream states and iteration count
+     */
+    NetworkResults solve(const NetworkSettings& settings = NetworkSettings());
+
+private:
+    enum class UnitType {
+        Exchanger,
+        Mixer,
+        Splitter
+    };
+
+    struct Unit {
+        std::string name;
+        UnitType type;
+        std::vector<int> inlets;
+        std::vector<int> outlets;
+        GeometryProperties geometry;
+        int segments;
+        std::vector<double> fractions;
+    };
+
+    struct Stream {
+        std::string name;
+        FluidProperties state;
+        int producer;       // Unit id, -1 for feeds and tears
+        int tear_source;    // Closing stream for tears, -1 otherwise
+    };
+
+    std::vector<Unit> units;
+    std::vector<Stream> streams;
+
+    int addStream(const std::string& name, int producer);
+    std::vector<std::vector<int>> topologicalLevels() const;
+    UnitResult evaluateUnit(int unit_id, std::vector<FluidProperties>& states) const;
+};
+
+#endif // EXCHANGER_NETWORK_H
@@ -0,0 +1,317 @@
+#include "fluid_database.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    const char MAGIC[8] = {'T', 'C', 'F', 'L', 'U', 'I', 'D', '\0'};
+    const uint32_t ENDIAN_MARKER = 0x01020304;
+    const size_t ALIGNMENT = 64;
+    const int NUM_ARRAYS = 6;
+
+    size_t alignUp(size_t value) {
+        return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    struct TextFluid {
+        std::string name;
+        std::vector<double> columns[5];     // T, rho, cp, k, mu
+    };
+
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseTables(const std::string& path, std::vector<TextFluid>& fluids, std::string& error) {
+        std::ifstream input(path);
+        if (!input.is_open()) {
+            error = "Could not open " + path;
+            return false;
+        }
+
+        std::string line;
+        int line_number = 0;
+        TextFluid* current = nullptr;
+        while (std::getline(input, line)) {
+            ++line_number;
+            std::string content = trim(line.substr(0, line.find('#')));
+            if (content.empty()) {
+                continue;
+            }
+            std::string where = path + ":" + std::to_string(line_number) + ": ";
+
+            if (content.compare(0, 6, "fluid ") == 0 || content.compare(0, 6, "fluid\t") == 0) {
+                if (current) {
+                    error = where + "missing 'end' before new fluid";
+                    return false;
+                }
+                fluids.emplace_back();
+                current = &fluids.back();
+                current->name = trim(content.substr(6));
+                if (current->name.empty()) {
+                    error = where + "fluid name is empty";
+                    return false;
+                }
+            } else if (content == "end") {
+                if (!current) {
+                    error = where + "'end' without 'fluid'";
+                    return false;
+                }
+                if (current->columns[0].size() < 2) {
+                    error = where + "fluid '" + current->name + "' needs at least two rows";
+                    return false;
+                }
+                current = nullptr;
+            } else {
+                if (!current) {
+                    error = where + "data row outside a fluid block";
+                    return false;
+                }
+                std::istringstream row(content);
+                double values[5];
+                for (int c = 0; c < 5; ++c) {
+                    if (!(row >> values[c])) {
+                        error = where + "expected T, density, cp, k and viscosity";
+                        return false;
+                    }
+                }
+                for (int c = 0; c < 5; ++c) {
+                    if (!(values[c] > 0.0) || !std::isfinite(values[c])) {
+                        error = where + "properties must be positive";
+                        return false;
+                    }
+                }
+                if (!current->columns[0].empty() && values[0] <= current->columns[0].back()) {
+                    error = where + "temperatures must be strictly increasing";
+                    return false;
+                }
+                for (int c = 0; c < 5; ++c) {
+                    current->columns[c].push_back(values[c]);
+                }
+            }
+        }
+        if (current) {
+            error = path + ": fluid '" + current->name + "' is missing 'end'";
+            return false;
+        }
+        return true;
+    }
+}
+
+FluidDatabase::FluidDatabase() : header(nullptr), directory(nullptr), names(nullptr) {}
+
+bool FluidDatabase::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        std::cerr << "Error: Could not open fluid database " << path << "\n";
+        return false;
+    }
+
+    const char* data = file.data();
+    size_t size = file.size();
+    const FileHeader* candidate = reinterpret_cast<const FileHeader*>(data);
+    if (size < sizeof(FileHeader) || std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Error: " << path << " is not a fluid database\n";
+        close();
+        return false;
+    }
+    if (candidate->endian_marker != ENDIAN_MARKER || candidate->version != FORMAT_VERSION) {
+        std::cerr << "Error: " << path << " has format version " << candidate->version
+                  << " or byte order unsupported by this build (expected version " << FORMAT_VERSION << ")\n";
+        close();
+        return false;
+    }
+    if (candidate->file_size != size ||
+        candidate->directory_offset + candidate->fluid_count * sizeof(DirectoryEntry) > size ||
+        candidate->names_offset > size) {
+        std::cerr << "Error: " << path << " is truncated\n";
+        close();
+        return false;
+    }
+
+    // Bounds-check the directory once so lookups can trust it
+    const DirectoryEntry* entries = reinterpret_cast<const DirectoryEntry*>(data + candidate->directory_offset);
+    for (uint32_t i = 0; i < candidate->fluid_count; ++i) {
+        const DirectoryEntry& entry = entries[i];
+        if (candidate->names_offset + entry.name_offset + entry.name_length > size ||
+            entry.data_offset % ALIGNMENT != 0 || entry.point_count < 2 ||
+            entry.data_offset + NUM_ARRAYS * alignUp(entry.point_count * sizeof(double)) > size) {
+            std::cerr << "Error: " << path << " has a corrupt directory entry " << i << "\n";
+            close();
+            return false;
+        }
+    }
+
+    header = candidate;
+    directory = entries;
+    names = data + header->names_offset;
+    return true;
+}
+
+void FluidDatabase::close() {
+    file.close();
+    header = nullptr;
+    directory = nullptr;
+    names = nullptr;
+}
+
+int FluidDatabase::fluidCount() const {
+    return header ? static_cast<int>(header->fluid_count) : 0;
+}
+
+std::string FluidDatabase::fluidName(int fluid) const {
+    if (fluid < 0 || fluid >= fluidCount()) {
+        throw std::out_of_range("Fluid index out of range");
+    }
+    const DirectoryEntry& entry = directory[fluid];
+    return std::string(names + entry.name_offset, entry.name_length);
+}
+
+int FluidDatabase::find(const std::string& name) const {
+    int low = 0, high = fluidCount() - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        const DirectoryEntry& entry = directory[mid];
+        size_t common = std::min<size_t>(entry.name_length, name.size());
+        int order = std::memcmp(names + entry.name_offset, name.data(), common);
+        if (order == 0) {
+            order = (entry.name_length < name.size()) ? -1 : (entry.name_length > name.size() ? 1 : 0);
+        }
+        if (order == 0) {
+            return mid;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+FluidDatabase::PropertyTable FluidDatabase::table(int fluid) const {
+    if (fluid < 0 || fluid >= fluidCount()) {
+        throw std::out_of_range("Fluid index out of range");
+    }
+    const DirectoryEntry& entry = directory[fluid];
+    size_t stride = alignUp(entry.point_count * sizeof(double));
+    const char* base = file.data() + entry.data_offset;
+
+    PropertyTable view;
+    view.points = static_cast<int>(entry.point_count);
+    view.temperature = reinterpret_cast<const double*>(base);
+    view.density = reinterpret_cast<const double*>(base + stride);
+    view.specific_heat = reinterpret_cast<const double*>(base + 2 * stride);
+    view.thermal_cond = reinterpret_cast<const double*>(base + 3 * stride);
+    view.viscosity = reinterpret_cast<const double*>(base + 4 * stride);
+    view.log_viscosity = reinterpret_cast<const double*>(base + 5 * stride);
+    return view;
+}
+
+FluidProperties FluidDatabase::properties(int fluid, double temperature) const {
+    PropertyTable view = table(fluid);
+    const double* T = view.temperature;
+    double clamped = std::max(T[0], std::min(T[view.points - 1], temperature));
+
+    // Interval containing the temperature
+    int i = static_cast<int>(std::upper_bound(T, T + view.points, clamped) - T) - 1;
+    i = std::max(0, std::min(view.points - 2, i));
+    double f = (clamped - T[i]) / (T[i + 1] - T[i]);
+    auto lerp = [&](const double* column) {
+        return column[i] + f * (column[i + 1] - column[i]);
+    };
+
+    FluidProperties fluid_props;
+    fluid_props.density = lerp(view.density);
+    fluid_props.specific_heat = lerp(view.specific_heat);
+    fluid_props.thermal_cond = lerp(view.thermal_cond);
+    fluid_props.viscosity = std::exp(lerp(view.log_viscosity));
+    fluid_props.prandtl = (fluid_props.specific_heat * fluid_props.viscosity) / fluid_props.thermal_cond;
+    return fluid_props;
+}
+
+bool FluidDatabase::compile(const std::vector<std::string>& text_files, const std::string& output_path,
+                            std::string& error) {
+    std::vector<TextFluid> fluids;
+    for (const std::string& path : text_files) {
+        if (!parseTables(path, fluids, error)) {
+            return false;
+        }
+    }
+
+    std::sort(fluids.begin(), fluids.end(),
+              [](const TextFluid& a, const TextFluid& b) { return a.name < b.name; });
+    for (size_t i = 1; i < fluids.size(); ++i) {
+        if (fluids[i].name == fluids[i - 1].name) {
+            error = "Duplicate fluid '" + fluids[i].name + "'";
+            return false;
+        }
+    }
+
+    // Lay out header, directory, names, then aligned property arrays
+    FileHeader file_header;
+    std::memset(&file_header, 0, sizeof(file_header));
+    std::memcpy(file_header.magic, MAGIC, sizeof(MAGIC));
+    file_header.version = FORMAT_VERSION;
+    file_header.endian_marker = ENDIAN_MARKER;
+    file_header.fluid_count = static_cast<uint32_t>(fluids.size());
+    file_header.directory_offset = sizeof(FileHeader);
+    file_header.names_offset = file_header.directory_offset + fluids.size() * sizeof(DirectoryEntry);
+
+    std::vector<DirectoryEntry> entries(fluids.size());
+    std::string name_block;
+    for (size_t i = 0; i < fluids.size(); ++i) {
+        entries[i].name_offset = static_cast<uint32_t>(name_block.size());
+        entries[i].name_length = static_cast<uint32_t>(fluids[i].name.size());
+        entries[i].point_count = static_cast<uint32_t>(fluids[i].columns[0].size());
+        entries[i].reserved = 0;
+        name_block += fluids[i].name;
+    }
+
+    size_t offset = alignUp(file_header.names_offset + name_block.size());
+    for (size_t i = 0; i < fluids.size(); ++i) {
+        entries[i].data_offset = offset;
+        offset += NUM_ARRAYS * alignUp(entries[i].point_count * sizeof(double));
+    }
+    file_header.file_size = offset;
+
+    std::vector<char> image(offset, 0);
+    std::memcpy(image.data(), &file_header, sizeof(file_header));
+    if (!entries.empty()) {
+        std::memcpy(image.data() + file_header.directory_offset, entries.data(),
+                    entries.size() * sizeof(DirectoryEntry));
+    }
+    std::memcpy(image.data() + file_header.names_offset, name_block.data(), name_block.size());
+    for (size_t i = 0; i < fluids.size(); ++i) {
+        size_t stride = alignUp(entries[i].point_count * sizeof(double));
+        char* base = image.data() + entries[i].data_offset;
+        for (int c = 0; c < 5; ++c) {
+            std::memcpy(base + c * stride, fluids[i].columns[c].data(), entries[i].point_count * sizeof(double));
+        }
+        double* log_mu = reinterpret_cast<double*>(base + 5 * stride);
+        for (uint32_t p = 0; p < entries[i].point_count; ++p) {
+            log_mu[p] = std::log(fluids[i].columns[4][p]);
+        }
+    }
+
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output.is_open()) {
+        error = "Could not open " + output_path + " for writing";
+        return false;
+    }
+    output.write(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!output.good()) {
+        error = "Write to " + output_path + " failed";
+        return false;
+    }
+    return true;
+}
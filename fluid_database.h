@@ -0,0 +1,118 @@
+#ifndef FLUID_DATABASE_H
+#define FLUID_DATABASE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fluid_properties.h"
+#include "mapped_file.h"
+
+/**
+ * @file fluid_database.h
+ * @brief Memory-mapped binary database of temperature-dependent fluid property tables
+ *
+ * Text tables (see fluid_tables.txt) are compiled once by fluid_db_compiler into a
+ * versioned binary file. Opening the database maps the file and checks the
+ * header and directory; the property arrays are used in place, so no table is
+ * parsed or copied at startup.
+ *
+ * Text format:
+ *   fluid <name>
+ *   # T_K  density_kg_m3  cp_J_kgK  k_W_mK  mu_Pa_s
+ *   300    996.5          4179      0.613   8.55e-4
+ *   ...
+ *   end
+ *
+ * Binary layout (native byte order, checked by an endian marker):
+ *   FileHeader | DirectoryEntry[fluid_count] sorted by name | names |
+ *   per fluid, 64-byte aligned arrays of T, rho, cp, k, mu, ln(mu)
+ */
+
+class FluidDatabase {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    struct PropertyTable {
+        int points;
+        const double* temperature;      // K, strictly increasing
+        const double* density;          // kg/m³
+        const double* specific_heat;    // J/kg·K
+        const double* thermal_cond;     // W/m·K
+        const double* viscosity;        // Pa·s
+        const double* log_viscosity;    // ln(Pa·s), used for interpolation
+    };
+
+    FluidDatabase();
+
+    /**
+     * Map a compiled database
+     * @param path Binary database file
+     * @return false if the file is missing, truncated or has another format version
+     */
+    bool open(const std::string& path);
+    void close();
+
+    int fluidCount() const;
+    std::string fluidName(int fluid) const;
+
+    /**
+     * Look up a fluid by name (binary search over the sorted directory)
+     * @param name Fluid name as given in the text tables
+     * @return Fluid index, or -1 if not present
+     */
+    int find(const std::string& name) const;
+
+    /**
+     * Raw property arrays, pointing into the mapping
+     * @param fluid Fluid index
+     * @return Table view, valid while the database stays open
+     */
+    PropertyTable table(int fluid) const;
+
+    /**
+     * Properties at a temperature: linear interpolation for rho, cp and k,
+     * log-linear for viscosity, clamped to the table range. Flow and
+     * temperature fields are left at zero.
+     * @param fluid Fluid index
+     * @param temperature Temperature (K)
+     * @return Fluid properties including the Prandtl number
+     */
+    FluidProperties properties(int fluid, double temperature) const;
+
+    /**
+     * Compile text property tables into a binary database
+     * @param text_files Input table files
+     * @param output_path Binary database to write
+     * @param error Description of the first problem found
+     * @return false on a parse, validation or write error
+     */
+    static bool compile(const std::vector<std::string>& text_files, const std::string& output_path,
+                        std::string& error);
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t endian_marker;
+        uint32_t fluid_count;
+        uint32_t reserved;
+        uint64_t directory_offset;
+        uint64_t names_offset;
+        uint64_t file_size;
+    };
+
+    struct DirectoryEntry {
+        uint32_t name_offset;       // Relative to names_offset
+        uint32_t name_length;
+        uint32_t point_count;
+        uint32_t reserved;
+        uint64_t data_offset;       // Absolute, 64-byte aligned
+    };
+
+    MappedFile file;
+    const FileHeader* header;
+    const DirectoryEntry* directory;
+    const char* names;
+};
+
+#endif // FLUID_DATABASE_H
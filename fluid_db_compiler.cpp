@@ -0,0 +1,27 @@
+#include "fluid_database.h"
+#include <iostream>
+
+/**
+ * Compile text fluid property tables into a binary fluid database
+ * Usage: fluid_db_compiler <output.tcfd> <tables.txt> [more tables...]
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output.tcfd> <tables.txt> [more tables...]\n";
+        return 1;
+    }
+
+    std::vector<std::string> inputs(argv + 2, argv + argc);
+    std::string error;
+    if (!FluidDatabase::compile(inputs, argv[1], error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    FluidDatabase database;
+    if (!database.open(argv[1])) {
+        return 1;
+    }
+    std::cout << "Wrote " << database.fluidCount() << " fluids to " << argv[1] << "\n";
+    return 0;
+}
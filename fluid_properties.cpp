@@ -22,6 +22,15 @@ GeometryProperties::GeometryProperties(double L, double D_shell, double d_tube,
     : length(L), shell_diameter(D_shell), tube_diameter(d_tube),
       tube_thickness(t_wall), num_tubes(N_tubes), wall_thermal_cond(k_wall) {}
 
+// TwoPhaseFluid constructors
+TwoPhaseFluid::TwoPhaseFluid() : inlet_temp(0), inlet_quality(0), mass_flow(0),
+                 saturation_temp(0), latent_heat(0) {}
+
+TwoPhaseFluid::TwoPhaseFluid(double inlet, double quality, double flow, double T_sat, double h_fg,
+                             const FluidProperties& liquid_props, const FluidProperties& vapor_props)
+    : inlet_temp(inlet), inlet_quality(quality), mass_flow(flow),
+      saturation_temp(T_sat), latent_heat(h_fg), liquid(liquid_props), vapor(vapor_props) {}
+
 namespace CommonFluids {
     FluidProperties getWaterProperties(double temperature) {
         FluidProperties water;
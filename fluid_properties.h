@@ -38,6 +38,26 @@ struct GeometryProperties {
                       int N_tubes, double k_wall);
 };
 
+/**
+ * Stream that condenses or boils at constant pressure (see PhaseChangeSolver).
+ * The inlet is subcooled liquid below saturation_temp, superheated vapour
+ * above it, and a two-phase mixture of inlet_quality at it.
+ */
+struct TwoPhaseFluid {
+    double inlet_temp;        // Inlet temperature (K)
+    double inlet_quality;     // Vapour mass fraction when inlet_temp equals saturation_temp
+    double mass_flow;         // Mass flow rate (kg/s)
+    double saturation_temp;   // Saturation temperature at the operating pressure (K)
+    double latent_heat;       // Latent heat of vaporisation (J/kg)
+    FluidProperties liquid;   // Saturated liquid properties
+    FluidProperties vapor;    // Saturated vapour properties
+    
+    // Constructors
+    TwoPhaseFluid();
+    TwoPhaseFluid(double inlet, double quality, double flow, double T_sat, double h_fg,
+                  const FluidProperties& liquid_props, const FluidProperties& vapor_props);
+};
+
 namespace CommonFluids {
     FluidProperties getWaterProperties(double temperature);
     FluidProperties getAirProperties(double temperature);
@@ -40,6 +40,37 @@ namespace HeatExchangerGeometry {
         return mass_flow / (density * flow_area);
     }
     
+    double tubePressureDrop(double mass_flow, double density, double viscosity, double tube_diameter,
+                            double length, int num_tubes, int tube_passes) {
+        // Each pass carries the full flow through num_tubes / tube_passes tubes
+        double velocity = mass_flow * tube_passes / (density * num_tubes * tubeArea(tube_diameter));
+        double reynolds = density * velocity * tube_diameter / viscosity;
+        double friction = (reynolds < 2300) ? 64.0 / reynolds
+                                            : std::pow(0.790 * std::log(reynolds) - 1.64, -2);
+        double velocity_head = density * velocity * velocity / 2.0;
+        return tube_passes * (friction * length / tube_diameter + 4.0) * velocity_head;
+    }
+    
+    double shellEquivalentDiameter(double tube_outer_diameter, double tube_pitch, TubeLayout layout) {
+        double Do = tube_outer_diameter;
+        if (layout == TubeLayout::Square90 || layout == TubeLayout::RotatedSquare45) {
+            return 1.27 / Do * (tube_pitch * tube_pitch - 0.785 * Do * Do);
+        }
+        return 1.10 / Do * (tube_pitch * tube_pitch - 0.917 * Do * Do);
+    }
+    
+    double shellPressureDrop(double mass_flow, double density, double viscosity, double shell_diameter,
+                             double tube_outer_diameter, double tube_pitch, double baffle_spacing,
+                             double length, TubeLayout layout) {
+        double crossflow_area = shell_diameter * baffle_spacing * (tube_pitch - tube_outer_diameter) / tube_pitch;
+        double mass_velocity = mass_flow / crossflow_area;
+        double De = shellEquivalentDiameter(tube_outer_diameter, tube_pitch, layout);
+        double reynolds = mass_velocity * De / viscosity;
+        double friction = std::exp(0.576 - 0.19 * std::log(reynolds));
+        double crossings = length / baffle_spacing;  // N_baffles + 1
+        return friction * mass_velocity * mass_velocity * shell_diameter * crossings / (2.0 * density * De);
+    }
+    
     double recommendedBaffleSpacing(double shell_diameter) {
         // Rule of thumb: baffle spacing = 0.2 to 1.0 times shell diameter
         return 0.5 * shell_diameter; // Conservative middle value
@@ -10,6 +10,16 @@
 
 namespace HeatExchangerGeometry {
     
+    /**
+     * Tube layout angle measured from the shell-side cross-flow direction
+     */
+    enum class TubeLayout {
+        Triangular30,         // 30° triangular
+        RotatedTriangular60,  // 60° rotated triangular
+        Square90,             // 90° square (inline)
+        RotatedSquare45       // 45° rotated square
+    };
+    
     /**
      * Calculate tube cross-sectional area
      * @param diameter Tube inner diameter (m)
@@ -66,6 +76,47 @@ namespace HeatExchangerGeometry {
     double shellVelocity(double mass_flow, double density, double shell_diameter, 
                         double tube_outer_diameter, int num_tubes);
     
+    /**
+     * Tube-side pressure drop: Darcy friction (64/Re laminar, Petukhov turbulent)
+     * plus four velocity heads per pass for entrance, exit and return losses
+     * @param mass_flow Mass flow rate (kg/s)
+     * @param density Fluid density (kg/m³)
+     * @param viscosity Dynamic viscosity (Pa·s)
+     * @param tube_diameter Tube inner diameter (m)
+     * @param length Tube length (m)
+     * @param num_tubes Number of tubes
+     * @param tube_passes Number of tube passes
+     * @return Pressure drop (Pa)
+     */
+    double tubePressureDrop(double mass_flow, double density, double viscosity, double tube_diameter,
+                            double length, int num_tubes, int tube_passes = 1);
+    
+    /**
+     * Shell-side equivalent diameter (Kern)
+     * @param tube_outer_diameter Tube outer diameter (m)
+     * @param tube_pitch Tube pitch (m)
+     * @param layout Tube layout (square formula for 90° and 45°, triangular otherwise)
+     * @return Equivalent diameter (m)
+     */
+    double shellEquivalentDiameter(double tube_outer_diameter, double tube_pitch, TubeLayout layout);
+    
+    /**
+     * Shell-side pressure drop across the baffled bundle (Kern method)
+     * @param mass_flow Mass flow rate (kg/s)
+     * @param density Fluid density (kg/m³)
+     * @param viscosity Dynamic viscosity (Pa·s)
+     * @param shell_diameter Shell diameter (m)
+     * @param tube_outer_diameter Tube outer diameter (m)
+     * @param tube_pitch Tube pitch (m)
+     * @param baffle_spacing Baffle spacing (m)
+     * @param length Shell length (m)
+     * @param layout Tube layout
+     * @return Pressure drop (Pa)
+     */
+    double shellPressureDrop(double mass_flow, double density, double viscosity, double shell_diameter,
+                             double tube_outer_diameter, double tube_pitch, double baffle_spacing,
+                             double length, TubeLayout layout = TubeLayout::Triangular30);
+    
     /**
      * Calculate baffle spacing (simplified - assumes 25% cut segmental baffles)
      * @param shell_diameter Shell diameter (m)
@@ -82,7 +133,8 @@ namespace HeatExchangerGeometry {
     double tubePitch(double tube_outer_diameter, double pitch_ratio = 1.25);
     
     /**
-     * Estimate maximum number of tubes for given shell diameter
+     * Estimate maximum number of tubes for given shell diameter (80% packing).
+     * TubeLayoutGenerator::maxTubes() (tube_layout.h) gives the exact count.
      * @param shell_diameter Shell diameter (m)
      * @param tube_outer_diameter Tube outer diameter (m)
      * @param pitch_ratio Pitch to diameter ratio
@@ -1,7 +1,19 @@
 #include "heat_transfer_correlations.h"
+#include <algorithm>
 #include <cmath>
 
 namespace HeatTransferCorrelations {
+
+    CorrelationSet textbookPowerLawSet() {
+        CorrelationSet set;
+        set.tube = {0.023, 0.8, 0.4};
+        set.shell = {0.36, 0.55, 0.36};
+        return set;
+    }
+
+    double powerLawNusselt(double reynolds, double prandtl, const PowerLawCoefficients& coefficients) {
+        return coefficients.C * std::pow(reynolds, coefficients.m) * std::pow(prandtl, coefficients.n);
+    }
     
     double dittusBoelter(double reynolds, double prandtl, bool heating) {
         if (reynolds < 2300) {
@@ -72,6 +84,25 @@ namespace HeatTransferCorrelations {
         }
     }
     
+    double filmCondensationHorizontalTubes(const FluidProperties& liquid, double vapor_density, double latent_heat,
+                                           double wall_subcooling, double diameter, int tube_rows) {
+        const double g = 9.81;
+        double subcooling = std::max(wall_subcooling, 1e-6);
+        double corrected_latent_heat = latent_heat + 0.68 * liquid.specific_heat * subcooling;
+        double group = g * liquid.density * (liquid.density - vapor_density) * corrected_latent_heat *
+                       diameter * diameter * diameter / (liquid.viscosity * liquid.thermal_cond * subcooling);
+        return 0.729 * std::pow(group, 0.25) * std::pow(std::max(tube_rows, 1), -1.0 / 6.0);
+    }
+    
+    double gungorWintertonBoiling(double reynolds_liquid_only, double prandtl_liquid, double quality,
+                                  double boiling_number, double density_ratio) {
+        double x = std::min(std::max(quality, 0.0), 0.999);  // The liquid film vanishes at x = 1
+        double nu_liquid = getTubeSideNusselt(reynolds_liquid_only * (1.0 - x), prandtl_liquid, true);
+        double enhancement = 1.0 + 3000.0 * std::pow(std::max(boiling_number, 0.0), 0.86) +
+                             1.12 * std::pow(x / (1.0 - x), 0.75) * std::pow(density_ratio, 0.41);
+        return nu_liquid * enhancement;
+    }
+    
     double getTubeSideNusselt(double reynolds, double prandtl, bool heating) {
         if (reynolds > 10000) {
             // Use Gnielinski for high Re
@@ -94,4 +125,18 @@ namespace HeatTransferCorrelations {
         return shellSideTubeBundles(reynolds, prandtl, tube_arrangement);
     }
 
+    double getTubeSideNusselt(double reynolds, double prandtl, const PowerLawCoefficients& coefficients) {
+        if (reynolds > 2300) {
+            return powerLawNusselt(reynolds, prandtl, coefficients);
+        }
+        return laminarTubeConstantWallTemp();
+    }
+
+    double getShellSideNusselt(double reynolds, double prandtl, const PowerLawCoefficients& coefficients) {
+        if (reynolds < 2000) {
+            return shellSideTubeBundles(reynolds, prandtl);
+        }
+        return powerLawNusselt(reynolds, prandtl, coefficients);
+    }
+
 } // namespace HeatTransferCorrelations
@@ -1,13 +1,53 @@
 #ifndef HEAT_TRANSFER_CORRELATIONS_H
 #define HEAT_TRANSFER_CORRELATIONS_H
 
+#include "fluid_properties.h"
+
 /**
  * @file heat_transfer_correlations.h
  * @brief Heat transfer correlations for Nusselt number calculations
  */
 
 namespace HeatTransferCorrelations {
+
+    /**
+     * Power-law Nusselt correlation Nu = C * Re^m * Pr^n
+     */
+    struct PowerLawCoefficients {
+        double C;
+        double m;       // Reynolds exponent
+        double n;       // Prandtl exponent
+    };
+
+    /**
+     * Coefficient set used by the solver in place of the textbook constants
+     * (tube side replaces Dittus-Boelter, shell side the staggered bundle correlation)
+     */
+    struct CorrelationSet {
+        PowerLawCoefficients tube;
+        PowerLawCoefficients shell;
+    };
+
+    /**
+     * Textbook power-law constants: Dittus-Boelter heating (0.023, 0.8, 0.4) and
+     * staggered tube bundles (0.36, 0.55, 0.36). This is a starting point for
+     * fitted sets, not the solver's behaviour without a set: that uses Gnielinski
+     * above Re 10^4 and the configured bundle arrangement, so installing this set
+     * changes results.
+     * @return Textbook power-law coefficient set
+     */
+    CorrelationSet textbookPowerLawSet();
+
+    /**
+     * Evaluate a power-law correlation
+     * @param reynolds Reynolds number
+     * @param prandtl Prandtl number
+     * @param coefficients C, m and n
+     * @return Nusselt number
+     */
+    double powerLawNusselt(double reynolds, double prandtl, const PowerLawCoefficients& coefficients);
     
+
     /**
      * Dittus-Boelter equation for turbulent flow in smooth tubes
      * @param reynolds Reynolds number
@@ -64,6 +104,35 @@ namespace HeatTransferCorrelations {
      */
     double naturalConvectionVertical(double rayleigh);
     
+    /**
+     * Nusselt film condensation on a bank of horizontal tubes, with Kern's
+     * N^(-1/6) correction for condensate draining onto lower rows and
+     * Rohsenow's latent heat correction h' = h_fg + 0.68 cp (T_sat - T_wall)
+     * @param liquid Saturated liquid properties (density, thermal_cond, viscosity, specific_heat)
+     * @param vapor_density Saturated vapour density (kg/m³)
+     * @param latent_heat Latent heat of condensation (J/kg)
+     * @param wall_subcooling Saturation minus wall temperature (K)
+     * @param diameter Tube outer diameter (m)
+     * @param tube_rows Tubes in a vertical row
+     * @return Nusselt number based on the outer diameter and liquid conductivity
+     */
+    double filmCondensationHorizontalTubes(const FluidProperties& liquid, double vapor_density, double latent_heat,
+                                           double wall_subcooling, double diameter, int tube_rows = 1);
+    
+    /**
+     * Gungor-Winterton (1987) flow boiling in tubes:
+     * h_tp = h_l [1 + 3000 Bo^0.86 + 1.12 (x/(1-x))^0.75 (rho_l/rho_v)^0.41],
+     * with h_l from getTubeSideNusselt() for the liquid fraction alone
+     * @param reynolds_liquid_only Reynolds number of the whole flow as liquid (G D / mu_l)
+     * @param prandtl_liquid Liquid Prandtl number
+     * @param quality Vapour mass fraction (0 to 1)
+     * @param boiling_number Heat flux over mass flux times latent heat, q / (G h_fg)
+     * @param density_ratio Liquid over vapour density
+     * @return Nusselt number based on the tube diameter and liquid conductivity
+     */
+    double gungorWintertonBoiling(double reynolds_liquid_only, double prandtl_liquid, double quality,
+                                  double boiling_number, double density_ratio);
+    
     /**
      * Get appropriate Nusselt correlation for tube side
      * @param reynolds Reynolds number
@@ -82,6 +151,24 @@ namespace HeatTransferCorrelations {
      */
     double getShellSideNusselt(double reynolds, double prandtl, int tube_arrangement = 1);
 
+    /**
+     * Tube side Nusselt number with fitted turbulent coefficients (laminar flow unchanged)
+     * @param reynolds Reynolds number
+     * @param prandtl Prandtl number
+     * @param coefficients Fitted tube-side coefficients
+     * @return Nusselt number
+     */
+    double getTubeSideNusselt(double reynolds, double prandtl, const PowerLawCoefficients& coefficients);
+
+    /**
+     * Shell side Nusselt number with fitted turbulent coefficients (laminar flow unchanged)
+     * @param reynolds Reynolds number
+     * @param prandtl Prandtl number
+     * @param coefficients Fitted shell-side coefficients
+     * @return Nusselt number
+     */
+    double getShellSideNusselt(double reynolds, double prandtl, const PowerLawCoefficients& coefficients);
+
 } // namespace HeatTransferCorrelations
 
 #endif // HEAT_TRANSFER_CORRELATIONS_H
@@ -0,0 +1,309 @@
+#include "historian_replay.h"
+#include "mapped_file.h"
+#include "numerical_solver.h"
+#include "thermal_calculations.h"
+#include "heat_exchanger_geometry.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace HistorianReplay {
+
+    namespace {
+        const int NUM_FIELDS = 7;
+
+        const double POWERS_OF_TEN[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        struct ChunkOutput {
+            std::string text;
+            long long records;
+            long long valid_records;
+            double fouling_sum;
+            double fouling_max;
+        };
+
+        // Parse and back-calculate every complete line in [begin, end)
+        void processChunk(const char* begin, const char* end, const ReplayConfiguration& config,
+                          ChunkOutput& out) {
+            out.records = 0;
+            out.valid_records = 0;
+            out.fouling_sum = 0.0;
+            out.fouling_max = -1e300;
+            out.text.clear();
+            out.text.reserve(static_cast<size_t>(end - begin));
+
+            char buffer[160];
+            const char* line = begin;
+            while (line < end) {
+                const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+                if (line_end == nullptr) {
+                    line_end = end;
+                }
+                const char* content_end = line_end;
+                if (content_end > line && content_end[-1] == '\r') {
+                    --content_end;
+                }
+
+                if (content_end > line) {
+                    // Split fields on commas
+                    const char* field_begin[NUM_FIELDS];
+                    const char* field_end[NUM_FIELDS];
+                    int fields = 0;
+                    const char* cursor = line;
+                    while (fields < NUM_FIELDS) {
+                        const char* comma = static_cast<const char*>(
+                            std::memchr(cursor, ',', content_end - cursor));
+                        field_begin[fields] = cursor;
+                        field_end[fields] = comma ? comma : content_end;
+                        ++fields;
+                        if (!comma) {
+                            break;
+                        }
+                        cursor = comma + 1;
+                    }
+
+                    ++out.records;
+                    HistorianSample sample;
+                    double* targets[NUM_FIELDS - 1] = {&sample.hot_inlet, &sample.hot_outlet,
+                                                       &sample.cold_inlet, &sample.cold_outlet,
+                                                       &sample.hot_flow, &sample.cold_flow};
+                    bool parsed = (fields == NUM_FIELDS);
+                    for (int f = 1; parsed && f < NUM_FIELDS; ++f) {
+                        parsed = parseNumber(field_begin[f], field_end[f], *targets[f - 1]);
+                    }
+
+                    FoulingPoint point = parsed ? backCalculate(sample, config) : FoulingPoint{false, 0, 0, 0, 0};
+                    out.text.append(field_begin[0], field_end[0]);
+                    if (point.valid) {
+                        ++out.valid_records;
+                        out.fouling_sum += point.fouling;
+                        out.fouling_max = std::max(out.fouling_max, point.fouling);
+                        int written = std::snprintf(buffer, sizeof(buffer), ",%.3f,%.3f,%.6e,%.1f\n",
+                                                    point.U_actual, point.U_clean, point.fouling, point.duty);
+                        out.text.append(buffer, written);
+                    } else {
+                        out.text.append(",,,,\n");
+                    }
+                }
+
+                line = line_end + 1;
+            }
+        }
+    } // anonymous namespace
+
+    ReplayConfiguration::ReplayConfiguration()
+        : num_threads(0), chunk_bytes(8 << 20), has_header(true) {}
+
+    bool parseNumber(const char* begin, const char* end, double& value) {
+        while (begin < end && (*begin == ' ' || *begin == '\t')) {
+            ++begin;
+        }
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) {
+            --end;
+        }
+        if (begin == end) {
+            return false;
+        }
+
+        const char* p = begin;
+        bool negative = false;
+        if (*p == '-' || *p == '+') {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        unsigned long long mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool any_digit = false;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0) {
+                    ++digits;
+                }
+            } else {
+                ++exponent;
+            }
+            any_digit = true;
+            ++p;
+        }
+        if (p < end && *p == '.') {
+            ++p;
+            while (p < end && *p >= '0' && *p <= '9') {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                    if (mantissa != 0) {
+                        ++digits;
+                    }
+                    --exponent;
+                }
+                any_digit = true;
+                ++p;
+            }
+        }
+        if (!any_digit) {
+            return false;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            bool exp_negative = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                exp_negative = (*p == '-');
+                ++p;
+            }
+            int exp_value = 0;
+            bool exp_digit = false;
+            while (p < end && *p >= '0' && *p <= '9') {
+                exp_value = std::min(exp_value * 10 + (*p - '0'), 10000);
+                exp_digit = true;
+                ++p;
+            }
+            if (!exp_digit) {
+                return false;
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+        }
+        if (p != end) {
+            return false;
+        }
+
+        // Exact for up to 15 significant digits and |exponent| <= 22; otherwise defer to strtod
+        if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+            double result = static_cast<double>(mantissa);
+            result = (exponent < 0) ? result / POWERS_OF_TEN[-exponent] : result * POWERS_OF_TEN[exponent];
+            value = negative ? -result : result;
+            return true;
+        }
+        std::string text(begin, end);
+        value = std::strtod(text.c_str(), nullptr);
+        return true;
+    }
+
+    FoulingPoint backCalculate(const HistorianSample& sample, const ReplayConfiguration& config) {
+        FoulingPoint point{false, 0.0, 0.0, 0.0, 0.0};
+
+        if (sample.hot_flow <= 0.0 || sample.cold_flow <= 0.0) {
+            return point;
+        }
+        double dT1 = sample.hot_inlet - sample.cold_outlet;
+        double dT2 = sample.hot_outlet - sample.cold_inlet;
+        if (dT1 <= 0.0 || dT2 <= 0.0) {
+            return point;  // Temperature cross or instrument fault
+        }
+
+        FluidProperties hot = config.hot_fluid;
+        hot.inlet_temp = sample.hot_inlet;
+        hot.outlet_temp = sample.hot_outlet;
+        hot.mass_flow = sample.hot_flow;
+        FluidProperties cold = config.cold_fluid;
+        cold.inlet_temp = sample.cold_inlet;
+        cold.outlet_temp = sample.cold_outlet;
+        cold.mass_flow = sample.cold_flow;
+
+        // Measured duty: average of both sides, as in the interactive efficiency report
+        double Q_hot = ThermalCalculations::actualHeatTransfer(
+            hot.mass_flow, hot.specific_heat, hot.inlet_temp, hot.outlet_temp);
+        double Q_cold = ThermalCalculations::actualHeatTransfer(
+            cold.mass_flow, cold.specific_heat, cold.inlet_temp, cold.outlet_temp);
+        point.duty = (Q_hot + Q_cold) / 2.0;
+
+        double lmtd = ThermalCalculations::LMTD_counterCurrent(
+            sample.hot_inlet, sample.hot_outlet, sample.cold_inlet, sample.cold_outlet);
+        double area = HeatExchangerGeometry::totalTubeArea(
+            config.geometry.tube_diameter, config.geometry.length, config.geometry.num_tubes);
+        if (lmtd <= 0.0 || area <= 0.0 || point.duty <= 0.0) {
+            return point;
+        }
+        point.U_actual = point.duty / (area * lmtd);
+
+        NumericalSolver solver(1, config.geometry, hot, cold);
+        solver.setShellSideModel(config.shell_model);
+        solver.setCorrelationSet(config.correlations);
+        point.U_clean = solver.ratingCoefficients().overall_htc;
+
+        point.fouling = ThermalCalculations::foulingFactor(point.U_clean, point.U_actual);
+        point.valid = std::isfinite(point.fouling);
+        return point;
+    }
+
+    ReplaySummary replayFile(const std::string& input_path, const std::string& output_path,
+                             const ReplayConfiguration& config) {
+        ReplaySummary summary{0, 0, 0, 0.0, 0.0, 0.0, false};
+        auto start = std::chrono::steady_clock::now();
+
+        MappedFile input;
+        if (!input.open(input_path)) {
+            std::cerr << "Error: Could not open historian file " << input_path << "\n";
+            return summary;
+        }
+        input.adviseSequential();
+
+        std::ofstream output(output_path, std::ios::binary);
+        if (!output.is_open()) {
+            std::cerr << "Error: Could not open file " << output_path << " for writing\n";
+            return summary;
+        }
+        output << "timestamp,U_actual,U_clean,fouling_m2K_W,duty_W\n";
+
+        const char* data = input.data();
+        size_t size = input.size();
+        size_t position = 0;
+        if (config.has_header && size > 0) {
+            const char* newline = static_cast<const char*>(std::memchr(data, '\n', size));
+            position = newline ? static_cast<size_t>(newline - data) + 1 : size;
+        }
+
+        int threads = ParallelUtils::resolveThreadCount(config.num_threads);
+        size_t chunk_bytes = std::max<size_t>(config.chunk_bytes, 4096);
+        std::vector<ChunkOutput> outputs(threads);
+        std::vector<std::pair<size_t, size_t>> ranges(threads);
+        double fouling_sum = 0.0;
+        double fouling_max = -1e300;
+
+        // One batch of newline-aligned chunks per round keeps memory bounded
+        while (position < size) {
+            int batch = 0;
+            while (batch < threads && position < size) {
+                size_t chunk_end = std::min(size, position + chunk_bytes);
+                if (chunk_end < size) {
+                    const char* newline = static_cast<const char*>(
+                        std::memchr(data + chunk_end, '\n', size - chunk_end));
+                    chunk_end = newline ? static_cast<size_t>(newline - data) + 1 : size;
+                }
+                ranges[batch++] = {position, chunk_end};
+                position = chunk_end;
+            }
+
+            ParallelUtils::parallelFor(0, batch, config.num_threads, [&](long long i) {
+                processChunk(data + ranges[i].first, data + ranges[i].second, config, outputs[i]);
+            });
+
+            for (int i = 0; i < batch; ++i) {
+                output.write(outputs[i].text.data(), static_cast<std::streamsize>(outputs[i].text.size()));
+                summary.records += outputs[i].records;
+                summary.valid_records += outputs[i].valid_records;
+                fouling_sum += outputs[i].fouling_sum;
+                fouling_max = std::max(fouling_max, outputs[i].fouling_max);
+            }
+        }
+
+        summary.skipped_records = summary.records - summary.valid_records;
+        summary.mean_fouling = summary.valid_records > 0 ? fouling_sum / summary.valid_records : 0.0;
+        summary.max_fouling = summary.valid_records > 0 ? fouling_max : 0.0;
+        summary.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        summary.ok = output.good();
+        return summary;
+    }
+
+} // namespace HistorianReplay
@@ -0,0 +1,95 @@
+#ifndef HISTORIAN_REPLAY_H
+#define HISTORIAN_REPLAY_H
+
+#include <memory>
+#include <string>
+#include "fluid_properties.h"
+#include "shell_side_model.h"
+#include "heat_transfer_correlations.h"
+
+/**
+ * @file historian_replay.h
+ * @brief Streaming back-calculation of U and fouling resistance from plant historian CSV
+ *
+ * Input rows (one header line):
+ *   timestamp,hot_inlet_K,hot_outlet_K,cold_inlet_K,cold_outlet_K,hot_flow_kg_s,cold_flow_kg_s
+ * The timestamp is copied through verbatim. Output rows:
+ *   timestamp,U_actual,U_clean,fouling_m2K_W,duty_W
+ *
+ * The input is memory-mapped and cut into newline-aligned chunks that are parsed
+ * and back-calculated in parallel; finished chunks are written in order, so
+ * resident memory is bounded by threads x chunk size regardless of file size.
+ */
+
+namespace HistorianReplay {
+
+    struct ReplayConfiguration {
+        GeometryProperties geometry;
+        FluidProperties hot_fluid;      // Property template; temperatures and flow come from each record
+        FluidProperties cold_fluid;
+        std::shared_ptr<const ShellSideModel> shell_model;  // Optional Bell-Delaware shell side
+        std::shared_ptr<const HeatTransferCorrelations::CorrelationSet> correlations;  // Optional fitted coefficients
+        int num_threads;                // 0 = hardware concurrency
+        size_t chunk_bytes;             // Input bytes per work item
+        bool has_header;
+
+        ReplayConfiguration();
+    };
+
+    struct HistorianSample {
+        double hot_inlet;
+        double hot_outlet;
+        double cold_inlet;
+        double cold_outlet;
+        double hot_flow;
+        double cold_flow;
+    };
+
+    struct FoulingPoint {
+        bool valid;
+        double U_actual;        // W/m²·K, from measured duty and LMTD
+        double U_clean;         // W/m²·K, from the correlations at measured flows
+        double fouling;         // m²·K/W
+        double duty;            // W
+    };
+
+    struct ReplaySummary {
+        long long records;
+        long long valid_records;
+        long long skipped_records;
+        double mean_fouling;
+        double max_fouling;
+        double elapsed_seconds;
+        bool ok;
+    };
+
+    /**
+     * Back-calculate actual U and fouling resistance for one sample
+     * @param sample Measured temperatures and flows
+     * @param config Geometry and fluid property templates
+     * @return Fouling point (valid = false for non-physical samples)
+     */
+    FoulingPoint backCalculate(const HistorianSample& sample, const ReplayConfiguration& config);
+
+    /**
+     * Replay a historian CSV file and write the fouling time series
+     * @param input_path Historian CSV
+     * @param output_path Fouling time series CSV
+     * @param config Geometry, fluid templates and parallel settings
+     * @return Record counts, fouling statistics and wall time
+     */
+    ReplaySummary replayFile(const std::string& input_path, const std::string& output_path,
+                             const ReplayConfiguration& config);
+
+    /**
+     * Parse a decimal number (optional sign, fraction and exponent) without locale lookups
+     * @param begin First character
+     * @param end One past the last character of the field
+     * @param value Parsed value
+     * @return false if the field is not a number
+     */
+    bool parseNumber(const char* begin, const char* end, double& value);
+
+} // namespace HistorianReplay
+
+#endif // HISTORIAN_REPLAY_H
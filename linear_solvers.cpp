@@ -0,0 +1,491 @@
+#include "linear_solvers.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+// SparseMatrix implementation
+SparseMatrix::SparseMatrix() : size(0), row_ptr(1, 0) {}
+
+SparseMatrix::SparseMatrix(int n, int expected_nonzeros_per_row) : size(n), row_ptr(1, 0) {
+    row_ptr.reserve(n + 1);
+    col_idx.reserve(static_cast<size_t>(n) * expected_nonzeros_per_row);
+    values.reserve(static_cast<size_t>(n) * expected_nonzeros_per_row);
+}
+
+void SparseMatrix::addEntry(int col, double value) {
+    col_idx.push_back(col);
+    values.push_back(value);
+}
+
+void SparseMatrix::finishRow() {
+    int begin = row_ptr.back();
+    int end = static_cast<int>(col_idx.size());
+
+    // Insertion sort - rows hold only a handful of entries
+    for (int i = begin + 1; i < end; ++i) {
+        int c = col_idx[i];
+        double v = values[i];
+        int j = i - 1;
+        while (j >= begin && col_idx[j] > c) {
+            col_idx[j + 1] = col_idx[j];
+            values[j + 1] = values[j];
+            --j;
+        }
+        col_idx[j + 1] = c;
+        values[j + 1] = v;
+    }
+    row_ptr.push_back(end);
+}
+
+void SparseMatrix::multiply(const std::vector<double>& x, std::vector<double>& y, int num_threads) const {
+    y.resize(size);
+    ParallelUtils::parallelForBlocks(0, size, num_threads, [&](long long begin, long long end) {
+        for (long long row = begin; row < end; ++row) {
+            double sum = 0.0;
+            for (int k = row_ptr[row]; k < row_ptr[row + 1]; ++k) {
+                sum += values[k] * x[col_idx[k]];
+            }
+            y[row] = sum;
+        }
+    }, 16384);
+}
+
+double SparseMatrix::diagonal(int row) const {
+    for (int k = row_ptr[row]; k < row_ptr[row + 1]; ++k) {
+        if (col_idx[k] == row) {
+            return values[k];
+        }
+    }
+    return 0.0;
+}
+
+int SparseMatrix::nonZeros() const {
+    return static_cast<int>(values.size());
+}
+
+// BandedMatrix implementation
+BandedMatrix::BandedMatrix() : size(0), lower_bandwidth(0), upper_bandwidth(0) {}
+
+BandedMatrix::BandedMatrix(int n, int kl, int ku)
+    : size(n), lower_bandwidth(kl), upper_bandwidth(ku),
+      band(static_cast<size_t>(n) * (2 * kl + ku + 1), 0.0) {}
+
+double& BandedMatrix::at(int row, int col) {
+    int ldab = 2 * lower_bandwidth + upper_bandwidth + 1;
+    return band[static_cast<size_t>(col) * ldab + lower_bandwidth + upper_bandwidth + row - col];
+}
+
+double BandedMatrix::at(int row, int col) const {
+    int ldab = 2 * lower_bandwidth + upper_bandwidth + 1;
+    return band[static_cast<size_t>(col) * ldab + lower_bandwidth + upper_bandwidth + row - col];
+}
+
+namespace LinearSolvers {
+
+    IterativeSettings::IterativeSettings()
+        : tolerance(1e-10), max_iterations(1000), num_threads(0),
+          preconditioner(Preconditioner::ILU0), line_length(0) {}
+
+    namespace {
+
+        double dot(const std::vector<double>& a, const std::vector<double>& b) {
+            return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+        }
+
+        double norm(const std::vector<double>& a) {
+            return std::sqrt(dot(a, a));
+        }
+
+        // Applies z = M^-1 r for the selected preconditioner
+        class PreconditionerApplier {
+        public:
+            PreconditionerApplier(const SparseMatrix& A, Preconditioner type, int threads, int line)
+                : matrix(A), kind(type), num_threads(threads), line_length(line) {
+                if (kind == Preconditioner::Jacobi) {
+                    inverse_diagonal.resize(A.size);
+                    for (int i = 0; i < A.size; ++i) {
+                        double d = A.diagonal(i);
+                        inverse_diagonal[i] = (std::abs(d) > 0.0) ? 1.0 / d : 1.0;
+                    }
+                } else if (kind == Preconditioner::ILU0) {
+                    factorILU0();
+                } else if (kind == Preconditioner::LineGaussSeidel) {
+                    if (line_length <= 0 || A.size % line_length != 0) {
+                        throw std::invalid_argument("LineGaussSeidel needs a line length dividing the matrix size");
+                    }
+                    factorLines();
+                }
+            }
+
+            void apply(const std::vector<double>& r, std::vector<double>& z) const {
+                z.resize(r.size());
+                switch (kind) {
+                    case Preconditioner::Jacobi:
+                        ParallelUtils::parallelForBlocks(0, matrix.size, num_threads,
+                            [&](long long begin, long long end) {
+                                for (long long i = begin; i < end; ++i) {
+                                    z[i] = inverse_diagonal[i] * r[i];
+                                }
+                            }, 16384);
+                        break;
+
+                    case Preconditioner::ILU0:
+                        // Forward solve with unit lower factor, then backward with upper factor
+                        for (int i = 0; i < matrix.size; ++i) {
+                            double sum = r[i];
+                            for (int k = matrix.row_ptr[i]; k < diag_pos[i]; ++k) {
+                                sum -= lu_values[k] * z[matrix.col_idx[k]];
+                            }
+                            z[i] = sum;
+                        }
+                        for (int i = matrix.size - 1; i >= 0; --i) {
+                            double sum = z[i];
+                            for (int k = diag_pos[i] + 1; k < matrix.row_ptr[i + 1]; ++k) {
+                                sum -= lu_values[k] * z[matrix.col_idx[k]];
+                            }
+                            z[i] = sum / lu_values[diag_pos[i]];
+                        }
+                        break;
+
+                    case Preconditioner::LineGaussSeidel:
+                        applyLineGaussSeidel(r, z);
+                        break;
+
+                    default:
+                        z = r;
+                        break;
+                }
+            }
+
+        private:
+            const SparseMatrix& matrix;
+            Preconditioner kind;
+            int num_threads;
+            std::vector<double> inverse_diagonal;
+            std::vector<double> lu_values;
+            std::vector<int> diag_pos;
+            int line_length;
+            std::vector<double> line_lower, line_pivot, line_upper;  // Thomas factors per row
+            mutable std::vector<double> work;
+
+            // Tridiagonal part of each line block, factored once (Thomas algorithm)
+            void factorLines() {
+                int n = matrix.size;
+                line_lower.assign(n, 0.0);
+                line_pivot.assign(n, 0.0);
+                line_upper.assign(n, 0.0);
+                work.assign(n, 0.0);
+                for (int i = 0; i < n; ++i) {
+                    int line_start = i - i % line_length;
+                    int line_end = line_start + line_length;
+                    double lower = 0.0, diag = 0.0, upper = 0.0;
+                    for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; ++k) {
+                        int col = matrix.col_idx[k];
+                        if (col == i) {
+                            diag = matrix.values[k];
+                        } else if (col == i - 1 && col >= line_start) {
+                            lower = matrix.values[k];
+                        } else if (col == i + 1 && col < line_end) {
+                            upper = matrix.values[k];
+                        }
+                    }
+                    if (i == line_start) {
+                        line_pivot[i] = diag;
+                    } else {
+                        line_lower[i] = lower / line_pivot[i - 1];
+                        line_pivot[i] = diag - line_lower[i] * line_upper[i - 1];
+                    }
+                    line_upper[i] = upper;
+                    if (std::abs(line_pivot[i]) < 1e-300) {
+                        throw std::runtime_error("Singular line block in LineGaussSeidel preconditioner");
+                    }
+                }
+            }
+
+            void solveLine(int start, std::vector<double>& x) const {
+                int end = start + line_length;
+                for (int i = start + 1; i < end; ++i) {
+                    x[i] -= line_lower[i] * x[i - 1];
+                }
+                x[end - 1] /= line_pivot[end - 1];
+                for (int i = end - 2; i >= start; --i) {
+                    x[i] = (x[i] - line_upper[i] * x[i + 1]) / line_pivot[i];
+                }
+            }
+
+            // z = (D+U)^-1 D (D+L)^-1 r with D the tridiagonal line blocks
+            void applyLineGaussSeidel(const std::vector<double>& r, std::vector<double>& z) const {
+                int n = matrix.size;
+                std::vector<double>& y = work;
+                for (int start = 0; start < n; start += line_length) {
+                    for (int i = start; i < start + line_length; ++i) {
+                        double sum = r[i];
+                        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1] && matrix.col_idx[k] < start; ++k) {
+                            sum -= matrix.values[k] * y[matrix.col_idx[k]];
+                        }
+                        y[i] = sum;
+                    }
+                    solveLine(start, y);
+                }
+
+                for (int start = n - line_length; start >= 0; start -= line_length) {
+                    int end = start + line_length;
+                    for (int i = start; i < end; ++i) {
+                        double block_product = 0.0, upper_sum = 0.0;
+                        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; ++k) {
+                            int col = matrix.col_idx[k];
+                            if (col >= end) {
+                                upper_sum += matrix.values[k] * z[col];
+                            } else if (col >= start) {
+                                block_product += matrix.values[k] * y[col];
+                            }
+                        }
+                        z[i] = block_product - upper_sum;
+                    }
+                    solveLine(start, z);
+                }
+            }
+
+            void factorILU0() {
+                int n = matrix.size;
+                lu_values = matrix.values;
+                diag_pos.assign(n, -1);
+                for (int i = 0; i < n; ++i) {
+                    for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; ++k) {
+                        if (matrix.col_idx[k] == i) {
+                            diag_pos[i] = k;
+                            break;
+                        }
+                    }
+                    if (diag_pos[i] < 0) {
+                        throw std::runtime_error("ILU(0) requires a structurally non-zero diagonal");
+                    }
+                }
+
+                // Column -> position lookup for the row being eliminated
+                std::vector<int> position(n, -1);
+                for (int i = 0; i < n; ++i) {
+                    for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; ++k) {
+                        position[matrix.col_idx[k]] = k;
+                    }
+                    for (int k = matrix.row_ptr[i]; k < diag_pos[i]; ++k) {
+                        int col = matrix.col_idx[k];
+                        lu_values[k] /= lu_values[diag_pos[col]];
+                        for (int m = diag_pos[col] + 1; m < matrix.row_ptr[col + 1]; ++m) {
+                            int target = position[matrix.col_idx[m]];
+                            if (target >= 0) {
+                                lu_values[target] -= lu_values[k] * lu_values[m];
+                            }
+                        }
+                    }
+                    for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; ++k) {
+                        position[matrix.col_idx[k]] = -1;
+                    }
+                }
+            }
+        };
+
+    } // anonymous namespace
+
+    IterativeResult conjugateGradient(const SparseMatrix& A, const std::vector<double>& b,
+                                      std::vector<double>& x, const IterativeSettings& settings) {
+        IterativeResult result{0, 0.0, false};
+        int n = A.size;
+        x.resize(n, 0.0);
+
+        PreconditionerApplier preconditioner(A, settings.preconditioner, settings.num_threads,
+                                              settings.line_length);
+
+        std::vector<double> r(n), z(n), p(n), Ap(n);
+        A.multiply(x, Ap, settings.num_threads);
+        for (int i = 0; i < n; ++i) {
+            r[i] = b[i] - Ap[i];
+        }
+
+        double b_norm = norm(b);
+        if (b_norm == 0.0) {
+            b_norm = 1.0;
+        }
+        result.relative_residual = norm(r) / b_norm;
+        if (result.relative_residual < settings.tolerance) {
+            result.converged = true;
+            return result;
+        }
+
+        preconditioner.apply(r, z);
+        p = z;
+        double rz = dot(r, z);
+
+        for (int iter = 0; iter < settings.max_iterations; ++iter) {
+            A.multiply(p, Ap, settings.num_threads);
+            double alpha = rz / dot(p, Ap);
+            for (int i = 0; i < n; ++i) {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * Ap[i];
+            }
+
+            result.iterations = iter + 1;
+            result.relative_residual = norm(r) / b_norm;
+            if (result.relative_residual < settings.tolerance) {
+                result.converged = true;
+                break;
+            }
+
+            preconditioner.apply(r, z);
+            double rz_new = dot(r, z);
+            double beta = rz_new / rz;
+            rz = rz_new;
+            for (int i = 0; i < n; ++i) {
+                p[i] = z[i] + beta * p[i];
+            }
+        }
+
+        return result;
+    }
+
+    IterativeResult biCGStab(const SparseMatrix& A, const std::vector<double>& b,
+                             std::vector<double>& x, const IterativeSettings& settings) {
+        IterativeResult result{0, 0.0, false};
+        int n = A.size;
+        x.resize(n, 0.0);
+
+        PreconditionerApplier preconditioner(A, settings.preconditioner, settings.num_threads,
+                                              settings.line_length);
+
+        std::vector<double> r(n), r_hat(n), p(n, 0.0), v(n, 0.0), s(n), t(n), p_hat(n), s_hat(n);
+        A.multiply(x, v, settings.num_threads);
+        for (int i = 0; i < n; ++i) {
+            r[i] = b[i] - v[i];
+        }
+        r_hat = r;
+        std::fill(v.begin(), v.end(), 0.0);
+
+        double b_norm = norm(b);
+        if (b_norm == 0.0) {
+            b_norm = 1.0;
+        }
+        result.relative_residual = norm(r) / b_norm;
+        if (result.relative_residual < settings.tolerance) {
+            result.converged = true;
+            return result;
+        }
+
+        double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+        for (int iter = 0; iter < settings.max_iterations; ++iter) {
+            double rho_new = dot(r_hat, r);
+            if (std::abs(rho_new) < 1e-300) {
+                break; // Breakdown - return the best iterate so far
+            }
+
+            double beta = (rho_new / rho) * (alpha / omega);
+            rho = rho_new;
+            for (int i = 0; i < n; ++i) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+
+            preconditioner.apply(p, p_hat);
+            A.multiply(p_hat, v, settings.num_threads);
+            alpha = rho / dot(r_hat, v);
+            for (int i = 0; i < n; ++i) {
+                s[i] = r[i] - alpha * v[i];
+            }
+
+            result.iterations = iter + 1;
+            double s_norm = norm(s);
+            if (s_norm / b_norm < settings.tolerance) {
+                for (int i = 0; i < n; ++i) {
+                    x[i] += alpha * p_hat[i];
+                }
+                result.relative_residual = s_norm / b_norm;
+                result.converged = true;
+                break;
+            }
+
+            preconditioner.apply(s, s_hat);
+            A.multiply(s_hat, t, settings.num_threads);
+            double tt = dot(t, t);
+            omega = (tt > 0.0) ? dot(t, s) / tt : 0.0;
+            for (int i = 0; i < n; ++i) {
+                x[i] += alpha * p_hat[i] + omega * s_hat[i];
+                r[i] = s[i] - omega * t[i];
+            }
+
+            result.relative_residual = norm(r) / b_norm;
+            if (result.relative_residual < settings.tolerance) {
+                result.converged = true;
+                break;
+            }
+            if (omega == 0.0) {
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    bool solveBanded(BandedMatrix& A, std::vector<double>& b) {
+        int n = A.size;
+        int kl = A.lower_bandwidth;
+        int ku = A.upper_bandwidth;
+        A.pivots.assign(n, 0);
+
+        // Factorisation
+        for (int j = 0; j < n; ++j) {
+            int last_row = std::min(n - 1, j + kl);
+            int last_col = std::min(n - 1, j + kl + ku);
+
+            int pivot = j;
+            double pivot_value = std::abs(A.at(j, j));
+            for (int i = j + 1; i <= last_row; ++i) {
+                if (std::abs(A.at(i, j)) > pivot_value) {
+                    pivot_value = std::abs(A.at(i, j));
+                    pivot = i;
+                }
+            }
+            A.pivots[j] = pivot;
+            if (pivot_value == 0.0) {
+                return false;
+            }
+            if (pivot != j) {
+                for (int c = j; c <= last_col; ++c) {
+                    std::swap(A.at(j, c), A.at(pivot, c));
+                }
+            }
+
+            double diag = A.at(j, j);
+            for (int i = j + 1; i <= last_row; ++i) {
+                double factor = A.at(i, j) / diag;
+                A.at(i, j) = factor;
+                if (factor != 0.0) {
+                    for (int c = j + 1; c <= last_col; ++c) {
+                        A.at(i, c) -= factor * A.at(j, c);
+                    }
+                }
+            }
+        }
+
+        // Forward substitution with row interchanges
+        for (int j = 0; j < n; ++j) {
+            std::swap(b[j], b[A.pivots[j]]);
+            int last_row = std::min(n - 1, j + kl);
+            for (int i = j + 1; i <= last_row; ++i) {
+                b[i] -= A.at(i, j) * b[j];
+            }
+        }
+
+        // Back substitution
+        for (int j = n - 1; j >= 0; --j) {
+            b[j] /= A.at(j, j);
+            int first_row = std::max(0, j - kl - ku);
+            for (int i = first_row; i < j; ++i) {
+                b[i] -= A.at(i, j) * b[j];
+            }
+        }
+
+        return true;
+    }
+
+} // namespace LinearSolvers
@@ -0,0 +1,118 @@
+#ifndef LINEAR_SOLVERS_H
+#define LINEAR_SOLVERS_H
+
+#include <vector>
+
+/**
+ * @file linear_solvers.h
+ * @brief Sparse matrix storage and preconditioned iterative linear solvers
+ */
+
+/**
+ * Square sparse matrix in compressed sparse row (CSR) format.
+ * Rows are assembled in order with addEntry()/finishRow(); column indices
+ * inside a row are sorted when the row is finished.
+ */
+struct SparseMatrix {
+    int size;
+    std::vector<int> row_ptr;
+    std::vector<int> col_idx;
+    std::vector<double> values;
+
+    // Constructors
+    SparseMatrix();
+    explicit SparseMatrix(int n, int expected_nonzeros_per_row = 7);
+
+    void addEntry(int col, double value);
+    void finishRow();
+
+    /**
+     * y = A * x, rows split across threads
+     * @param x Input vector (size n)
+     * @param y Output vector (resized to n)
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     */
+    void multiply(const std::vector<double>& x, std::vector<double>& y, int num_threads = 0) const;
+
+    double diagonal(int row) const;
+    int nonZeros() const;
+};
+
+/**
+ * Square banded matrix stored by columns (LAPACK band layout) with room for
+ * the extra upper diagonals produced by partial pivoting.
+ */
+struct BandedMatrix {
+    int size;
+    int lower_bandwidth;
+    int upper_bandwidth;
+    std::vector<double> band;
+    std::vector<int> pivots;
+
+    // Constructors
+    BandedMatrix();
+    BandedMatrix(int n, int kl, int ku);
+
+    double& at(int row, int col);
+    double at(int row, int col) const;
+};
+
+namespace LinearSolvers {
+
+    enum class Preconditioner {
+        None,
+        Jacobi,
+        ILU0,
+        LineGaussSeidel     // Symmetric block Gauss-Seidel over contiguous tridiagonal lines
+    };
+
+    struct IterativeSettings {
+        double tolerance;            // Relative residual ||b - Ax|| / ||b||
+        int max_iterations;
+        int num_threads;             // Threads for SpMV (0 = hardware concurrency)
+        Preconditioner preconditioner;
+        int line_length;             // Rows per line block for LineGaussSeidel
+
+        IterativeSettings();
+    };
+
+    struct IterativeResult {
+        int iterations;
+        double relative_residual;
+        bool converged;
+    };
+
+    /**
+     * Preconditioned conjugate gradient for symmetric positive definite systems
+     * @param A System matrix
+     * @param b Right-hand side
+     * @param x Initial guess on entry, solution on exit
+     * @param settings Tolerance, iteration limit, threads and preconditioner
+     * @return Iteration count and final relative residual
+     */
+    IterativeResult conjugateGradient(const SparseMatrix& A, const std::vector<double>& b,
+                                      std::vector<double>& x, const IterativeSettings& settings);
+
+    /**
+     * Right-preconditioned BiCGSTAB for general non-symmetric systems
+     * @param A System matrix
+     * @param b Right-hand side
+     * @param x Initial guess on entry, solution on exit
+     * @param settings Tolerance, iteration limit, threads and preconditioner
+     * @return Iteration count and final relative residual
+     */
+    IterativeResult biCGStab(const SparseMatrix& A, const std::vector<double>& b,
+                             std::vector<double>& x, const IterativeSettings& settings);
+
+    /**
+     * Direct banded solve by Gaussian elimination with partial pivoting.
+     * Cost is O(n * kl * (kl + ku)); the matrix is overwritten by its LU factors.
+     * @param A Banded matrix (factored in place)
+     * @param b Right-hand side on entry, solution on exit
+     * @return false if a zero pivot was encountered
+     */
+    bool solveBanded(BandedMatrix& A, std::vector<double>& b);
+
+} // namespace LinearSolvers
+
+#endif // LINEAR_SOLVERS_H
@@ -7,6 +7,7 @@
 #include "heat_transfer_correlations.h"
 #include "dimensionless_numbers.h"
 #include "numerical_solver.h"
+#include "sharded_sweep.h"
 
 class HeatExchanger {
 private:
@@ -216,7 +217,12 @@ void HeatExchanger::outputResults() {
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Worker process of a sharded sweep started by ShardedSweep::run()
+    if (ShardedSweep::isWorkerInvocation(argc, argv)) {
+        return ShardedSweep::workerMain(argc, argv);
+    }
+
     std::cout << "=== SHELL AND TUBE HEAT EXCHANGER ANALYSIS ===\n";
     std::cout << "This program calculates temperature profiles and efficiency\n";
     std::cout << "using numerical methods for heat transfer analysis.\n\n";
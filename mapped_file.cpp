@@ -0,0 +1,107 @@
+#include "mapped_file.h"
+#include <cstdint>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : mapped_data(nullptr), mapped_size(0), is_open(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    mapped_size = static_cast<size_t>(info.st_size);
+    if (mapped_size > 0) {
+        void* address = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            mapped_size = 0;
+            return false;
+        }
+        mapped_data = static_cast<const char*>(address);
+    }
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+    is_open = true;
+    return true;
+#else
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) ||
+        static_cast<unsigned long long>(file_size.QuadPart) > static_cast<unsigned long long>(SIZE_MAX)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    mapped_size = static_cast<size_t>(file_size.QuadPart);
+    if (mapped_size > 0) {
+        // An empty file cannot be mapped; it opens with no data, as on POSIX
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* address = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (!address) {
+            CloseHandle(file);
+            mapped_size = 0;
+            return false;
+        }
+        mapped_data = static_cast<const char*>(address);
+    }
+    CloseHandle(file);  // The view keeps the mapping and the file open until it is unmapped
+    is_open = true;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+    if (mapped_data != nullptr) {
+#if !defined(_WIN32)
+        munmap(const_cast<char*>(mapped_data), mapped_size);
+#else
+        UnmapViewOfFile(mapped_data);
+#endif
+    }
+    mapped_data = nullptr;
+    mapped_size = 0;
+    is_open = false;
+}
+
+void MappedFile::adviseSequential() const {
+#if !defined(_WIN32)
+    if (mapped_data != nullptr) {
+        madvise(const_cast<char*>(mapped_data), mapped_size, MADV_SEQUENTIAL);
+    }
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory-mapped file (mmap on POSIX, MapViewOfFile on Windows)
+ */
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map a file read-only
+     * @param path File path
+     * @return false if the file could not be opened or mapped
+     */
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return mapped_data; }
+    size_t size() const { return mapped_size; }
+    bool isOpen() const { return mapped_data != nullptr || (is_open && mapped_size == 0); }
+
+    /**
+     * Hint that the mapping will be read sequentially
+     */
+    void adviseSequential() const;
+
+private:
+    const char* mapped_data;
+    size_t mapped_size;
+    bool is_open;
+};
+
+#endif // MAPPED_FILE_H
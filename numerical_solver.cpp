@@ -3,39 +3,92 @@
 #include "heat_transfer_correlations.h"
 #include "thermal_calculations.h"
 #include "heat_exchanger_geometry.h"
+#include "linear_solvers.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
 
-NumericalSolver::NumericalSolver(int segments, const GeometryProperties& geom,
-                               const FluidProperties& hot, const FluidProperties& cold)
-    : num_segments(segments), geometry(geom), hot_fluid(hot), cold_fluid(cold) {
-}
-
-NumericalSolver::SolutionResults NumericalSolver::solveTemperatureDistribution() {
-    SolutionResults results;
+namespace {
+    // Affine map x -> M*x + v acting on the (hot, cold) state of one station
+    struct AffineMap2 {
+        double m00, m01, m10, m11;
+        double v0, v1;
+    };
     
-    // Initialize arrays
-    results.hot_temperatures.resize(num_segments + 1);
-    results.cold_temperatures.resize(num_segments + 1);
-    results.positions.resize(num_segments + 1);
+    AffineMap2 identityMap() {
+        return {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+    }
     
-    // Calculate segment length
-    double dx = geometry.length / num_segments;
+    // Returns "second after first"
+    AffineMap2 composeMaps(const AffineMap2& first, const AffineMap2& second) {
+        AffineMap2 r;
+        r.m00 = second.m00 * first.m00 + second.m01 * first.m10;
+        r.m01 = second.m00 * first.m01 + second.m01 * first.m11;
+        r.m10 = second.m10 * first.m00 + second.m11 * first.m10;
+        r.m11 = second.m10 * first.m01 + second.m11 * first.m11;
+        r.v0 = second.m00 * first.v0 + second.m01 * first.v1 + second.v0;
+        r.v1 = second.m10 * first.v0 + second.m11 * first.v1 + second.v1;
+        return r;
+    }
     
-    // Initialize boundary conditions
-    results.hot_temperatures[0] = hot_fluid.inlet_temp;  // Hot inlet
-    results.cold_temperatures[num_segments] = cold_fluid.inlet_temp;  // Cold inlet (counter-current)
+    void applyMap(const AffineMap2& map, double& hot, double& cold) {
+        double h = map.m00 * hot + map.m01 * cold + map.v0;
+        double c = map.m10 * hot + map.m11 * cold + map.v1;
+        hot = h;
+        cold = c;
+    }
     
-    // Calculate positions
-    for (int i = 0; i <= num_segments; ++i) {
-        results.positions[i] = i * dx;
+    /**
+     * Segment update of the finite difference scheme written as an explicit map.
+     * The fixed point of the relaxed iteration satisfies, per segment,
+     *   H_i = H_{i-1} - a (H_{i-1} - (C_{i-1} + C_i)/2),     a = UA/C_hot
+     *   C_i = C_{i-1} + b ((H_{i-1} + H_i)/2 - C_{i-1}),     b = UA/C_cold
+     * which is solved here for (H_i, C_i) in closed form.
+     */
+    AffineMap2 segmentMap(double UA_segment, double C_hot, double C_cold) {
+        double a = UA_segment / C_hot;
+        double b = UA_segment / C_cold;
+        double det = 1.0 - a * b / 4.0;
+        
+        // inverse of [1, -a/2; -b/2, 1] times [1-a, a/2; b/2, 1-b]
+        AffineMap2 map;
+        map.m00 = ((1.0 - a) + (a / 2.0) * (b / 2.0)) / det;
+        map.m01 = ((a / 2.0) + (a / 2.0) * (1.0 - b)) / det;
+        map.m10 = ((b / 2.0) * (1.0 - a) + (b / 2.0)) / det;
+        map.m11 = ((b / 2.0) * (a / 2.0) + (1.0 - b)) / det;
+        map.v0 = 0.0;
+        map.v1 = 0.0;
+        return map;
     }
     
-    // Calculate flow areas and velocities
-    double tube_flow_area = HeatExchangerGeometry::tubeArea(geometry.tube_diameter) * geometry.num_tubes;
+    // The same map applied count times, by repeated squaring
+    AffineMap2 mapPower(const AffineMap2& map, long long count) {
+        AffineMap2 result = identityMap();
+        AffineMap2 square = map;
+        while (count > 0) {
+            if (count & 1) {
+                result = composeMaps(result, square);
+            }
+            square = composeMaps(square, square);
+            count >>= 1;
+        }
+        return result;
+    }
+}
+
+NumericalSolver::NumericalSolver(int segments, const GeometryProperties& geom,
+                               const FluidProperties& hot, const FluidProperties& cold)
+    : num_segments(segments), geometry(geom), hot_fluid(hot), cold_fluid(cold) {
+}
+
+void NumericalSolver::calculateCoefficients(SolutionResults& results, int tube_passes) const {
+    // Calculate flow areas and velocities (each tube pass carries the full tube-side flow)
+    double tube_flow_area = HeatExchangerGeometry::tubeArea(geometry.tube_diameter) * geometry.num_tubes / tube_passes;
     double shell_flow_area = HeatExchangerGeometry::shellFlowArea(
         geometry.shell_diameter, geometry.tube_diameter + 2 * geometry.tube_thickness, geometry.num_tubes);
     
@@ -49,19 +102,40 @@ NumericalSolver::SolutionResults NumericalSolver::solveTemperatureDistribution()
         hot_velocity, geometry.shell_diameter, hot_fluid.density, hot_fluid.viscosity);
     
     // Calculate Nusselt numbers using appropriate correlations
-    results.cold_nusselt = HeatTransferCorrelations::getTubeSideNusselt(
-        results.cold_reynolds, cold_fluid.prandtl, true); // Heating
-    results.hot_nusselt = HeatTransferCorrelations::getShellSideNusselt(
-        results.hot_reynolds, hot_fluid.prandtl);
+    if (correlations) {
+        results.cold_nusselt = HeatTransferCorrelations::getTubeSideNusselt(
+            results.cold_reynolds, cold_fluid.prandtl, correlations->tube);
+        results.hot_nusselt = HeatTransferCorrelations::getShellSideNusselt(
+            results.hot_reynolds, hot_fluid.prandtl, correlations->shell);
+    } else {
+        results.cold_nusselt = HeatTransferCorrelations::getTubeSideNusselt(
+            results.cold_reynolds, cold_fluid.prandtl, true); // Heating
+        results.hot_nusselt = HeatTransferCorrelations::getShellSideNusselt(
+            results.hot_reynolds, hot_fluid.prandtl);
+    }
+    if (user_tube || user_shell) {
+        UserCorrelations::GeometryRatios ratios = UserCorrelations::GeometryRatios::fromGeometry(geometry);
+        if (user_tube) {
+            results.cold_nusselt = UserCorrelations::getTubeSideNusselt(
+                results.cold_reynolds, cold_fluid.prandtl, *user_tube, ratios);
+        }
+        if (user_shell) {
+            results.hot_nusselt = UserCorrelations::getShellSideNusselt(
+                results.hot_reynolds, hot_fluid.prandtl, *user_shell, ratios);
+        }
+    }
     
     // Calculate heat transfer coefficients
     results.cold_htc = results.cold_nusselt * cold_fluid.thermal_cond / geometry.tube_diameter;
     results.hot_htc = results.hot_nusselt * hot_fluid.thermal_cond / geometry.shell_diameter;
     
-    // Calculate heat transfer surface areas
-    double inner_surface_area = HeatExchangerGeometry::totalTubeArea(
-        geometry.tube_diameter, geometry.length, geometry.num_tubes);
-    // Note: outer_surface_area calculation removed as it's not used
+    // Baffle-compartment shell side replaces the axial-flow estimate when configured
+    if (shell_model) {
+        ShellSideModel::ShellSideResults shell = shell_model->rate(hot_fluid);
+        results.hot_reynolds = shell.reynolds;
+        results.hot_nusselt = shell.nusselt;
+        results.hot_htc = shell.shell_htc;
+    }
     
     // Calculate overall heat transfer coefficient
     double inner_radius = geometry.tube_diameter / 2.0;
@@ -69,6 +143,61 @@ NumericalSolver::SolutionResults NumericalSolver::solveTemperatureDistribution()
     results.overall_htc = ThermalCalculations::overallHTC(
         results.cold_htc, results.hot_htc, inner_radius,
         outer_radius, geometry.wall_thermal_cond);
+}
+
+void NumericalSolver::setShellSideModel(std::shared_ptr<const ShellSideModel> model) {
+    shell_model = std::move(model);
+}
+
+void NumericalSolver::setCorrelationSet(std::shared_ptr<const HeatTransferCorrelations::CorrelationSet> set) {
+    correlations = std::move(set);
+}
+
+void NumericalSolver::setUserCorrelations(std::shared_ptr<const UserCorrelations::Correlation> tube,
+                                          std::shared_ptr<const UserCorrelations::Correlation> shell) {
+    if (tube && tube->side() != UserCorrelations::Side::Tube) {
+        throw std::invalid_argument("Correlation " + tube->name() + " is not a tube-side correlation");
+    }
+    if (shell && shell->side() != UserCorrelations::Side::Shell) {
+        throw std::invalid_argument("Correlation " + shell->name() + " is not a shell-side correlation");
+    }
+    user_tube = std::move(tube);
+    user_shell = std::move(shell);
+}
+
+NumericalSolver::SolutionResults NumericalSolver::ratingCoefficients(int tube_passes) const {
+    SolutionResults results;
+    calculateCoefficients(results, tube_passes);
+    return results;
+}
+
+NumericalSolver::SolutionResults NumericalSolver::solveTemperatureDistribution() {
+    SolutionResults results;
+    
+    // Initialize arrays
+    results.hot_temperatures.resize(num_segments + 1);
+    results.cold_temperatures.resize(num_segments + 1);
+    results.positions.resize(num_segments + 1);
+    
+    // Calculate segment length
+    double dx = geometry.length / num_segments;
+    
+    // Initialize boundary conditions
+    results.hot_temperatures[0] = hot_fluid.inlet_temp;  // Hot inlet
+    results.cold_temperatures[num_segments] = cold_fluid.inlet_temp;  // Cold inlet (counter-current)
+    
+    // Calculate positions
+    for (int i = 0; i <= num_segments; ++i) {
+        results.positions[i] = i * dx;
+    }
+    
+    // Calculate Reynolds, Nusselt and heat transfer coefficients
+    calculateCoefficients(results);
+    
+    // Calculate heat transfer surface areas
+    double inner_surface_area = HeatExchangerGeometry::totalTubeArea(
+        geometry.tube_diameter, geometry.length, geometry.num_tubes);
+    // Note: outer_surface_area calculation removed as it's not used
     
     // Calculate heat capacity rates
     double C_hot = hot_fluid.mass_flow * hot_fluid.specific_heat;
@@ -167,6 +296,496 @@ NumericalSolver::SolutionResults NumericalSolver::solveTemperatureDistribution()
     return results;
 }
 
+NumericalSolver::SolutionResults NumericalSolver::solveTemperatureDistributionScan(int num_threads) {
+    SolutionResults results;
+    
+    results.hot_temperatures.resize(num_segments + 1);
+    results.cold_temperatures.resize(num_segments + 1);
+    results.positions.resize(num_segments + 1);
+    
+    double dx = geometry.length / num_segments;
+    
+    calculateCoefficients(results);
+    
+    double inner_surface_area = HeatExchangerGeometry::totalTubeArea(
+        geometry.tube_diameter, geometry.length, geometry.num_tubes);
+    double UA_segment = results.overall_htc * inner_surface_area / num_segments;
+    double C_hot = hot_fluid.mass_flow * hot_fluid.specific_heat;
+    double C_cold = cold_fluid.mass_flow * cold_fluid.specific_heat;
+    
+    // Coefficients are constant along the exchanger, so every segment shares one map.
+    // The scan below only relies on the maps being known up front.
+    AffineMap2 step = segmentMap(UA_segment, C_hot, C_cold);
+    
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    num_threads = std::max(1, std::min(num_threads, num_segments));
+    
+    // Cold temperatures are stored in reverse station order (cold inlet at index num_segments)
+    int n = num_segments;
+    auto storeStation = [&](int i, double hot, double cold) {
+        results.hot_temperatures[i] = hot;
+        results.cold_temperatures[n - i] = cold;
+        results.positions[i] = i * dx;
+    };
+    
+    std::vector<int> chunk_begin(num_threads + 1);
+    for (int t = 0; t <= num_threads; ++t) {
+        chunk_begin[t] = static_cast<int>(static_cast<long long>(n) * t / num_threads);
+    }
+    
+    // Pass 1: each thread reduces the maps of its chunk to a single map
+    // (the last chunk's map is never needed)
+    std::vector<AffineMap2> chunk_maps(num_threads, identityMap());
+    auto reduceChunk = [&](int t) {
+        AffineMap2 acc = identityMap();
+        for (int i = chunk_begin[t]; i < chunk_begin[t + 1]; ++i) {
+            acc = composeMaps(acc, step);
+        }
+        chunk_maps[t] = acc;
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < num_threads - 1; ++t) {
+        workers.emplace_back(reduceChunk, t);
+    }
+    if (num_threads > 1) {
+        reduceChunk(0);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    
+    // Exclusive scan over the chunk maps gives the state entering every chunk
+    std::vector<double> start_hot(num_threads), start_cold(num_threads);
+    double hot = hot_fluid.inlet_temp;
+    double cold = cold_fluid.inlet_temp;
+    for (int t = 0; t < num_threads; ++t) {
+        start_hot[t] = hot;
+        start_cold[t] = cold;
+        applyMap(chunk_maps[t], hot, cold);
+    }
+    
+    // Pass 2: march every chunk from its start state
+    auto marchChunk = [&](int t) {
+        double h = start_hot[t];
+        double c = start_cold[t];
+        storeStation(chunk_begin[t], h, c);
+        for (int i = chunk_begin[t] + 1; i <= chunk_begin[t + 1]; ++i) {
+            applyMap(step, h, c);
+            storeStation(i, h, c);
+        }
+    };
+    for (int t = 1; t < num_threads; ++t) {
+        workers.emplace_back(marchChunk, t);
+    }
+    marchChunk(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    return results;
+}
+
+NumericalSolver::StreamResults NumericalSolver::solveTemperatureDistributionStreaming(
+    const ProfileStream::Sink& sink, int chunk_stations) {
+    if (chunk_stations < 1) {
+        throw std::invalid_argument("Chunk size must be at least 1 station");
+    }
+    StreamResults stream;
+    calculateCoefficients(stream.coefficients);
+    
+    double inner_surface_area = HeatExchangerGeometry::totalTubeArea(
+        geometry.tube_diameter, geometry.length, geometry.num_tubes);
+    double UA_segment = stream.coefficients.overall_htc * inner_surface_area / num_segments;
+    AffineMap2 step = segmentMap(UA_segment, hot_fluid.mass_flow * hot_fluid.specific_heat,
+                                 cold_fluid.mass_flow * cold_fluid.specific_heat);
+    
+    long long stations = static_cast<long long>(num_segments) + 1;
+    int capacity = static_cast<int>(std::min<long long>(chunk_stations, stations));
+    std::vector<double> hot_chunk(capacity), cold_chunk(capacity);
+    
+    ProfileStream::ProfileChunk chunk;
+    chunk.dx = geometry.length / num_segments;
+    chunk.hot = hot_chunk.data();
+    chunk.cold = cold_chunk.data();
+    chunk.positions = nullptr;
+    
+    // Sequential march from the inlets; station i pairs hot[i] with cold[n - i] of the scan layout
+    double h = hot_fluid.inlet_temp;
+    double c = cold_fluid.inlet_temp;
+    stream.stations_delivered = 0;
+    stream.completed = true;
+    for (long long first = 0; first < stations; first += capacity) {
+        int count = static_cast<int>(std::min<long long>(capacity, stations - first));
+        for (int k = 0; k < count; ++k) {
+            if (first + k > 0) {
+                applyMap(step, h, c);
+            }
+            hot_chunk[k] = h;
+            cold_chunk[k] = c;
+        }
+        chunk.first_station = first;
+        chunk.count = count;
+        chunk.last = (first + count == stations);
+        stream.stations_delivered += count;
+        if (!sink(chunk)) {
+            stream.completed = chunk.last;
+            break;
+        }
+    }
+    
+    stream.hot_outlet = h;
+    stream.cold_outlet = c;
+    return stream;
+}
+
+NumericalSolver::AnytimeOptions::AnytimeOptions()
+    : deadline(std::chrono::steady_clock::time_point::max()), cancel(nullptr),
+      coarse_segments(16), refinement_factor(4) {}
+
+void NumericalSolver::AnytimeOptions::setTimeBudget(double seconds) {
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+NumericalSolver::AnytimeResults NumericalSolver::solveAnytime(const AnytimeOptions& options) {
+    if (options.coarse_segments < 1 || options.refinement_factor < 2) {
+        throw std::invalid_argument("Anytime levels need at least 1 coarse segment and a refinement factor of 2");
+    }
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+    auto stopRequested = [&options]() {
+        return (options.cancel && options.cancel->cancelled()) || Clock::now() >= options.deadline;
+    };
+    
+    SolutionResults coefficients;
+    calculateCoefficients(coefficients);
+    double UA = coefficients.overall_htc * HeatExchangerGeometry::totalTubeArea(
+        geometry.tube_diameter, geometry.length, geometry.num_tubes);
+    double C_hot = hot_fluid.mass_flow * hot_fluid.specific_heat;
+    double C_cold = cold_fluid.mass_flow * cold_fluid.specific_heat;
+    double T_hot = hot_fluid.inlet_temp;
+    double T_cold = cold_fluid.inlet_temp;
+    
+    // Closed-form parallel-flow rating, the continuum limit of the segment scheme
+    double C_min = std::min(C_hot, C_cold);
+    double C_max = std::max(C_hot, C_cold);
+    double effectiveness = ThermalCalculations::effectiveness_NTU(UA / C_min, C_min / C_max, 1);
+    double Q = effectiveness * C_min * (T_hot - T_cold);
+    
+    // Its distance from the full solve, whose outlets come from the segment map raised to num_segments
+    double target_hot = T_hot;
+    double target_cold = T_cold;
+    applyMap(mapPower(segmentMap(UA / num_segments, C_hot, C_cold), num_segments), target_hot, target_cold);
+    double closed_form_error = std::max(std::abs(T_hot - Q / C_hot - target_hot),
+                                        std::abs(T_cold + Q / C_cold - target_cold));
+    
+    // Levels sample the continuum profile H(x) = H0 - (UA/C_hot) d0 (1 - exp(-λx)) / λ (and C alike)
+    // on finer grids until the interpolation error drops below the closed form's own error. A march
+    // of fewer segments is always further from the full solve than the continuum (the scheme converges
+    // as 1/n²), so the only segment solve is the final one at num_segments.
+    double lambda = UA * (1.0 / C_hot + 1.0 / C_cold);
+    double d0 = T_hot - T_cold;
+    
+    AnytimeResults best;
+    best.converged = false;
+    SolutionResults buffers;        // Profile under construction; freed on return, even if a level is cut short
+    double seconds_per_station = 0.0;
+    long long n = std::min<long long>(options.coarse_segments, num_segments);
+    bool march = false;
+    bool keep_going = true;
+    for (int level = 0; keep_going; ++level) {
+        if (level > 0) {
+            if (stopRequested()) {
+                break;
+            }
+            // Skip a level the deadline would cut short (its cost is predicted from the last one)
+            if (options.deadline != Clock::time_point::max() &&
+                seconds(options.deadline - Clock::now()) < seconds_per_station * (n + 1)) {
+                best.deadline_reached = true;
+                break;
+            }
+        }
+        auto level_start = Clock::now();
+        
+        // Level 0 is always delivered; later levels stop within 1024 stations of a request
+        std::vector<double>& hot = buffers.hot_temperatures;
+        std::vector<double>& cold = buffers.cold_temperatures;
+        std::vector<double>& positions = buffers.positions;
+        hot.clear();
+        cold.clear();
+        positions.clear();
+        hot.reserve(n + 1);
+        cold.reserve(n + 1);
+        positions.reserve(n + 1);
+        double dx = geometry.length / n;
+        AffineMap2 step = segmentMap(UA / n, C_hot, C_cold);
+        double h = T_hot;
+        double c = T_cold;
+        bool interrupted = false;
+        for (long long i = 0; i <= n; ++i) {
+            if (march) {
+                if (i > 0) {
+                    applyMap(step, h, c);
+                }
+            } else {
+                double x = static_cast<double>(i) / n;
+                double exchanged = d0 * UA * (lambda > 0.0 ? -std::expm1(-lambda * x) / lambda : x);
+                h = T_hot - exchanged / C_hot;
+                c = T_cold + exchanged / C_cold;
+            }
+            hot.push_back(h);
+            cold.push_back(c);
+            positions.push_back(i * dx);
+            if (level > 0 && (i & 1023) == 1023 && stopRequested()) {
+                interrupted = true;
+                break;
+            }
+        }
+        if (interrupted) {
+            break;
+        }
+        
+        double interpolation = 0.0;
+        if (!march) {
+            // Linear interpolation between stations is off by at most max|second difference| / 8
+            for (long long i = 1; i < n; ++i) {
+                interpolation = std::max(interpolation, std::abs(hot[i - 1] - 2.0 * hot[i] + hot[i + 1]));
+                interpolation = std::max(interpolation, std::abs(cold[i - 1] - 2.0 * cold[i] + cold[i + 1]));
+            }
+            interpolation /= 8.0;
+        }
+        std::reverse(cold.begin(), cold.end());     // Same layout as solveTemperatureDistributionScan()
+        
+        AnytimeResults next;
+        next.solution = coefficients;
+        next.solution.hot_temperatures.swap(hot);
+        next.solution.cold_temperatures.swap(cold);
+        next.solution.positions.swap(positions);
+        next.level = level;
+        next.segments = march ? static_cast<int>(n) : 0;
+        next.converged = march;
+        next.cancelled = false;
+        next.deadline_reached = false;
+        if (march) {
+            next.hot_outlet = h;
+            next.cold_outlet = c;
+            next.heat_duty = C_hot * (T_hot - h);
+            next.error_estimate = std::max(std::abs(h - target_hot), std::abs(c - target_cold));
+        } else {
+            next.hot_outlet = T_hot - Q / C_hot;
+            next.cold_outlet = T_cold + Q / C_cold;
+            next.heat_duty = Q;
+            next.error_estimate = closed_form_error + interpolation;
+        }
+        next.elapsed_seconds = seconds(Clock::now() - start);
+        best = std::move(next);
+        seconds_per_station = seconds(Clock::now() - level_start) / (n + 1);
+        
+        keep_going = (!options.progress || options.progress(best)) && !best.converged;
+        march = interpolation <= closed_form_error || n * options.refinement_factor >= num_segments;
+        n = march ? num_segments : n * options.refinement_factor;
+    }
+    
+    if (!best.converged) {
+        best.cancelled = options.cancel && options.cancel->cancelled();
+        best.deadline_reached = best.deadline_reached || Clock::now() >= options.deadline;
+    }
+    best.elapsed_seconds = seconds(Clock::now() - start);
+    return best;
+}
+
+void NumericalSolver::scalingStudy(int max_threads) {
+    if (max_threads <= 0) {
+        max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    
+    std::cout << "Performing strong scaling study (" << num_segments << " segments)...\n";
+    std::cout << std::setw(10) << "Threads" << std::setw(14) << "Time (ms)"
+              << std::setw(12) << "Speedup" << std::setw(18) << "Max |dT| (K)" << std::endl;
+    std::cout << std::string(54, '-') << std::endl;
+    
+    std::ofstream file("scaling_study.csv");
+    file << "Threads,Time_ms,Speedup,Max_Deviation_K\n";
+    
+    SolutionResults reference;
+    double reference_ms = 0.0;
+    
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        auto start = std::chrono::steady_clock::now();
+        SolutionResults temp_results = solveTemperatureDistributionScan(threads);
+        auto stop = std::chrono::steady_clock::now();
+        double elapsed_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+        
+        // The single-threaded scan is a plain sequential march and serves as the reference
+        double max_deviation = 0.0;
+        if (threads == 1) {
+            reference = temp_results;
+            reference_ms = elapsed_ms;
+        } else {
+            for (int i = 0; i <= num_segments; ++i) {
+                max_deviation = std::max(max_deviation,
+                    std::abs(temp_results.hot_temperatures[i] - reference.hot_temperatures[i]));
+                max_deviation = std::max(max_deviation,
+                    std::abs(temp_results.cold_temperatures[i] - reference.cold_temperatures[i]));
+            }
+        }
+        double speedup = (elapsed_ms > 0) ? reference_ms / elapsed_ms : 0.0;
+        
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << threads
+                  << std::setw(14) << elapsed_ms
+                  << std::setw(12) << speedup
+                  << std::setw(18) << std::scientific << max_deviation << std::fixed << std::endl;
+        
+        file << threads << "," << elapsed_ms << "," << speedup << "," << max_deviation << "\n";
+    }
+    
+    file.close();
+    std::cout << "Scaling study results written to scaling_study.csv\n";
+}
+
+NumericalSolver::MultiPassResults NumericalSolver::solveMultiPass(int tube_passes) {
+    if (tube_passes < 1) {
+        throw std::invalid_argument("Number of tube passes must be at least 1");
+    }
+    
+    MultiPassResults results;
+    results.tube_passes = tube_passes;
+    
+    SolutionResults coefficients;
+    calculateCoefficients(coefficients, tube_passes);
+    results.overall_htc = coefficients.overall_htc;
+    results.hot_reynolds = coefficients.hot_reynolds;
+    results.cold_reynolds = coefficients.cold_reynolds;
+    results.hot_htc = coefficients.hot_htc;
+    results.cold_htc = coefficients.cold_htc;
+    
+    const int N = num_segments;
+    const int P = tube_passes;
+    const int V = P + 1;  // Unknowns per station: shell, then one per tube pass
+    
+    double inner_surface_area = HeatExchangerGeometry::totalTubeArea(
+        geometry.tube_diameter, geometry.length, geometry.num_tubes);
+    double UA_pass = results.overall_htc * inner_surface_area / (N * P);
+    double C_hot = hot_fluid.mass_flow * hot_fluid.specific_heat;
+    double C_cold = cold_fluid.mass_flow * cold_fluid.specific_heat;
+    
+    auto index = [V](int node, int var) { return node * V + var; };
+    
+    // Boundary rows at x = 0: shell inlet, tube inlet and the return bends of odd passes.
+    // Return bends of even passes sit at x = L and close the system.
+    int rows_at_start = 2;
+    for (int p = 1; p + 1 < P; p += 2) {
+        ++rows_at_start;
+    }
+    int n = (N + 1) * V;
+    int kl = rows_at_start + V - 1;
+    int ku = 2 * V - 1 - rows_at_start;
+    BandedMatrix A(n, kl, ku);
+    std::vector<double> b(n, 0.0);
+    
+    int row = 0;
+    A.at(row, index(0, 0)) = 1.0;
+    b[row++] = hot_fluid.inlet_temp;
+    A.at(row, index(0, 1)) = 1.0;
+    b[row++] = cold_fluid.inlet_temp;
+    for (int p = 1; p + 1 < P; p += 2) {
+        A.at(row, index(0, 2 + p)) = 1.0;
+        A.at(row, index(0, 1 + p)) = -1.0;
+        ++row;
+    }
+    
+    // Segment energy balances, trapezoidal temperature differences
+    for (int i = 1; i <= N; ++i) {
+        // Shell stream
+        A.at(row, index(i, 0)) += C_hot + P * UA_pass / 2.0;
+        A.at(row, index(i - 1, 0)) += -C_hot + P * UA_pass / 2.0;
+        for (int p = 0; p < P; ++p) {
+            A.at(row, index(i, 1 + p)) -= UA_pass / 2.0;
+            A.at(row, index(i - 1, 1 + p)) -= UA_pass / 2.0;
+        }
+        ++row;
+        
+        // Tube passes alternate direction, even passes flow towards x = L
+        for (int p = 0; p < P; ++p) {
+            double direction = (p % 2 == 0) ? 1.0 : -1.0;
+            A.at(row, index(i, 1 + p)) += direction * C_cold + UA_pass / 2.0;
+            A.at(row, index(i - 1, 1 + p)) += -direction * C_cold + UA_pass / 2.0;
+            A.at(row, index(i, 0)) -= UA_pass / 2.0;
+            A.at(row, index(i - 1, 0)) -= UA_pass / 2.0;
+            ++row;
+        }
+    }
+    
+    for (int p = 0; p + 1 < P; p += 2) {
+        A.at(row, index(N, 2 + p)) = 1.0;
+        A.at(row, index(N, 1 + p)) = -1.0;
+        ++row;
+    }
+    
+    if (!LinearSolvers::solveBanded(A, b)) {
+        throw std::runtime_error("Singular multi-pass system");
+    }
+    
+    double dx = geometry.length / N;
+    results.positions.resize(N + 1);
+    results.shell_temperatures.resize(N + 1);
+    results.pass_temperatures.assign(P, std::vector<double>(N + 1));
+    for (int i = 0; i <= N; ++i) {
+        results.positions[i] = i * dx;
+        results.shell_temperatures[i] = b[index(i, 0)];
+        for (int p = 0; p < P; ++p) {
+            results.pass_temperatures[p][i] = b[index(i, 1 + p)];
+        }
+    }
+    
+    results.hot_outlet = results.shell_temperatures[N];
+    results.cold_outlet = ((P - 1) % 2 == 0) ? results.pass_temperatures[P - 1][N]
+                                             : results.pass_temperatures[P - 1][0];
+    results.heat_duty = C_hot * (hot_fluid.inlet_temp - results.hot_outlet);
+    
+    double C_min = std::min(C_hot, C_cold);
+    double Q_max = ThermalCalculations::maximumHeatTransfer(C_min, hot_fluid.inlet_temp, cold_fluid.inlet_temp);
+    results.effectiveness = ThermalCalculations::calculateEffectiveness(results.heat_duty, Q_max);
+    results.ntu = ThermalCalculations::calculateNTU(results.overall_htc * inner_surface_area, C_min);
+    
+    return results;
+}
+
+void NumericalSolver::multiPassStudy(int max_passes) {
+    std::cout << "Performing multi-pass study (" << num_segments << " segments)...\n";
+    std::cout << std::setw(8) << "Passes" << std::setw(14) << "Hot Out (K)" << std::setw(14) << "Cold Out (K)"
+              << std::setw(12) << "NTU" << std::setw(14) << "Eff (solver)" << std::setw(14) << "Eff (1-2N)"
+              << std::setw(10) << "F" << std::endl;
+    std::cout << std::string(86, '-') << std::endl;
+    
+    double C_hot = hot_fluid.mass_flow * hot_fluid.specific_heat;
+    double C_cold = cold_fluid.mass_flow * cold_fluid.specific_heat;
+    double C_ratio = std::min(C_hot, C_cold) / std::max(C_hot, C_cold);
+    
+    for (int passes = 2; passes <= max_passes; passes += 2) {
+        MultiPassResults mp = solveMultiPass(passes);
+        double eff_closed_form = ThermalCalculations::effectiveness_NTU(mp.ntu, C_ratio, 3);
+        
+        double P = (mp.cold_outlet - cold_fluid.inlet_temp) / (hot_fluid.inlet_temp - cold_fluid.inlet_temp);
+        double R = (hot_fluid.inlet_temp - mp.hot_outlet) / (mp.cold_outlet - cold_fluid.inlet_temp);
+        double F = ThermalCalculations::correctionFactor_1_2N(P, R);
+        
+        std::cout << std::fixed << std::setprecision(4)
+                  << std::setw(8) << passes
+                  << std::setw(14) << mp.hot_outlet
+                  << std::setw(14) << mp.cold_outlet
+                  << std::setw(12) << mp.ntu
+                  << std::setw(14) << mp.effectiveness
+                  << std::setw(14) << eff_closed_form
+                  << std::setw(10) << F << std::endl;
+    }
+}
+
 void NumericalSolver::convergenceStudy(int min_segments, int max_segments, int step) {
     std::cout << "Performing convergence study...\n";
     std::cout << std::setw(12) << "Segments" << std::setw(15) << "Hot Outlet (K)" 
@@ -179,6 +798,9 @@ void NumericalSolver::convergenceStudy(int min_segments, int max_segments, int s
     for (int segments = min_segments; segments <= max_segments; segments += step) {
         // Create temporary solver with current segment count
         NumericalSolver temp_solver(segments, geometry, hot_fluid, cold_fluid);
+        temp_solver.setShellSideModel(shell_model);
+        temp_solver.setCorrelationSet(correlations);
+        temp_solver.setUserCorrelations(user_tube, user_shell);
         SolutionResults temp_results = temp_solver.solveTemperatureDistribution();
         
         double hot_outlet = temp_results.hot_temperatures[segments];
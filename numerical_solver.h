@@ -3,7 +3,15 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include "cancellation_token.h"
 #include "fluid_properties.h"
+#include "shell_side_model.h"
+#include "heat_transfer_correlations.h"
+#include "profile_stream.h"
+#include "user_correlations.h"
 
 /**
  * @file numerical_solver.h
@@ -16,6 +24,10 @@ private:
     GeometryProperties geometry;
     FluidProperties hot_fluid;
     FluidProperties cold_fluid;
+    std::shared_ptr<const ShellSideModel> shell_model;  // Optional Bell-Delaware shell side
+    std::shared_ptr<const HeatTransferCorrelations::CorrelationSet> correlations;  // Optional fitted coefficients
+    std::shared_ptr<const UserCorrelations::Correlation> user_tube;    // Optional config-file correlations
+    std::shared_ptr<const UserCorrelations::Correlation> user_shell;
     
 public:
     struct SolutionResults {
@@ -31,12 +43,157 @@ public:
         double cold_htc;
     };
     
+    struct MultiPassResults {
+        std::vector<double> positions;
+        std::vector<double> shell_temperatures;                // Hot (shell) stream, position order
+        std::vector<std::vector<double>> pass_temperatures;    // [pass][node], position order
+        int tube_passes;
+        double overall_htc;
+        double hot_reynolds;
+        double cold_reynolds;
+        double hot_htc;
+        double cold_htc;
+        double hot_outlet;
+        double cold_outlet;
+        double heat_duty;                                      // W
+        double effectiveness;
+        double ntu;
+    };
+    
+    struct StreamResults {
+        SolutionResults coefficients;          // Reynolds, Nusselt and film coefficients (profile vectors empty)
+        double hot_outlet;                     // K, at the last delivered station
+        double cold_outlet;
+        long long stations_delivered;
+        bool completed;                        // false if the sink stopped the solve early
+    };
+    
+    struct AnytimeResults {
+        SolutionResults solution;              // Coefficients and the level's profile
+        double hot_outlet;                     // K
+        double cold_outlet;                    // K
+        double heat_duty;                      // W, hot side
+        int level;                             // 0 = closed-form ε-NTU, then finer levels
+        int segments;                          // Segments marched (0 for closed-form levels)
+        double error_estimate;                 // K, outlet and interpolated profile deviation from the full solve
+        bool converged;                        // The level used the solver's own segment count
+        bool cancelled;
+        bool deadline_reached;
+        double elapsed_seconds;
+    };
+    
+    struct AnytimeOptions {
+        std::chrono::steady_clock::time_point deadline;        // Default: none
+        const CancellationToken* cancel;                       // Optional
+        std::function<bool(const AnytimeResults&)> progress;   // Optional; called per level, false stops
+        int coarse_segments;                                   // Profile segments of level 0
+        int refinement_factor;                                 // Profile refinement per level
+        
+        AnytimeOptions();
+        
+        /** Set the deadline this many seconds from now */
+        void setTimeBudget(double seconds);
+    };
+    
     NumericalSolver(int segments, const GeometryProperties& geom,
                    const FluidProperties& hot, const FluidProperties& cold);
     
+    /**
+     * Use a Bell-Delaware baffle-compartment model for the shell side instead of
+     * the axial-flow tube bank correlation. The model (and its cached geometry
+     * factors) can be shared between solvers rating the same shell.
+     * @param model Shell-side model, or nullptr to restore the default correlation
+     */
+    void setShellSideModel(std::shared_ptr<const ShellSideModel> model);
+    
+    /**
+     * Use fitted power-law coefficients (see CorrelationFitting) for the turbulent
+     * tube and shell side Nusselt numbers instead of the built-in correlations
+     * @param set Coefficient set, or nullptr to restore the built-in correlations
+     */
+    void setCorrelationSet(std::shared_ptr<const HeatTransferCorrelations::CorrelationSet> set);
+    
+    /**
+     * Use correlations compiled from a config file (see UserCorrelations) for
+     * the tube and/or shell side. They take precedence over a correlation set;
+     * a Bell-Delaware shell-side model still replaces the shell side.
+     * @param tube Tube-side correlation, or nullptr for the default
+     * @param shell Shell-side correlation, or nullptr for the default
+     */
+    void setUserCorrelations(std::shared_ptr<const UserCorrelations::Correlation> tube,
+                             std::shared_ptr<const UserCorrelations::Correlation> shell);
+    
+    /**
+     * Reynolds, Nusselt, film and overall coefficients only (no temperature profile)
+     * @param tube_passes Tube passes sharing the tube count (sets the tube-side velocity)
+     * @return Results with empty profile vectors
+     */
+    SolutionResults ratingCoefficients(int tube_passes = 1) const;
+    
     SolutionResults solveTemperatureDistribution();
+    
+    /**
+     * Direct solve of the segment recurrence using a parallel prefix scan over
+     * the per-segment affine maps. Converges to the same discrete solution as
+     * solveTemperatureDistribution() without fixed-point sweeps.
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     */
+    SolutionResults solveTemperatureDistributionScan(int num_threads = 0);
+    
+    /**
+     * Same segment recurrence as solveTemperatureDistributionScan(), handed to a
+     * sink chunk by chunk as stations are finalised. Only one chunk of
+     * temperatures is resident, whatever the number of segments.
+     * @param sink Chunk receiver (ProfileStream::FileSink, Decimator or any callback)
+     * @param chunk_stations Stations per chunk
+     */
+    StreamResults solveTemperatureDistributionStreaming(const ProfileStream::Sink& sink,
+                                                        int chunk_stations = 65536);
+    
+    /**
+     * Progressive solve that can be stopped at any time. Level 0 is the
+     * closed-form parallel-flow ε-NTU rating, the continuum limit of the
+     * segment scheme, with its exponential profile at coarse_segments.
+     * Later levels sample that profile refinement_factor times finer until
+     * its interpolation error is below the closed form's own error. The last
+     * level is the full num_segments march. Error estimates are measured
+     * against the full solve's outlets, which are found in O(log n) by
+     * squaring the segment map, plus the profile's linear interpolation
+     * bound. A level whose predicted cost overruns the deadline is not
+     * started. The march checks the token and the deadline every 1024
+     * stations.
+     * @param options Deadline, cancellation token, progress callback and level schedule
+     * @return The finest level that completed
+     */
+    AnytimeResults solveAnytime(const AnytimeOptions& options = AnytimeOptions());
+    
+    /**
+     * Time the scan solver for 1, 2, 4, ... threads and report the deviation
+     * from the single-threaded march (written to scaling_study.csv)
+     * @param max_threads Largest thread count (0 = hardware concurrency)
+     */
+    void scalingStudy(int max_threads = 0);
+    
+    /**
+     * One shell pass with several tube passes (1-2N TEMA E arrangement).
+     * Every tube pass exchanges heat with the single shell stream; the shell
+     * enters at x = 0 together with the first tube pass. The coupled segment
+     * equations are solved directly as one banded system.
+     * @param tube_passes Number of tube passes (1, 2, 4, ...)
+     */
+    MultiPassResults solveMultiPass(int tube_passes);
+    
+    /**
+     * Compare multi-pass solutions for 2, 4, ... tube passes against the closed-form
+     * 1-2N effectiveness and report the LMTD correction factor F
+     * @param max_passes Largest number of tube passes
+     */
+    void multiPassStudy(int max_passes = 8);
     void convergenceStudy(int min_segments, int max_segments, int step);
     void writeResultsToFile(const SolutionResults& results, const std::string& filename = "temperature_profile.csv");
+    
+private:
+    void calculateCoefficients(SolutionResults& results, int tube_passes = 1) const;
 };
 
 #endif // NUMERICAL_SOLVER_H
@@ -0,0 +1,116 @@
+#ifndef PARALLEL_UTILS_H
+#define PARALLEL_UTILS_H
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file parallel_utils.h
+ * @brief Minimal helpers for splitting index ranges across worker threads
+ */
+
+namespace ParallelUtils {
+
+    /**
+     * Resolve a requested thread count
+     * @param requested Requested threads (0 or negative = hardware concurrency)
+     * @return Thread count of at least 1
+     */
+    inline int resolveThreadCount(int requested) {
+        if (requested > 0) {
+            return requested;
+        }
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    /**
+     * Split [begin, end) into contiguous blocks and call func(block_begin, block_end)
+     * once per block, one block per thread. The calling thread runs the first block.
+     * An exception thrown by any block is rethrown here once every thread has joined
+     * (the first one caught if several blocks throw).
+     * @param begin First index
+     * @param end One past the last index
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     * @param func Callable taking (long long block_begin, long long block_end)
+     * @param min_block Smallest block worth a thread of its own
+     */
+    template <typename Func>
+    void parallelForBlocks(long long begin, long long end, int num_threads, Func func,
+                           long long min_block = 4096) {
+        long long count = end - begin;
+        if (count <= 0) {
+            return;
+        }
+
+        long long max_useful = std::max(1LL, count / std::max(1LL, min_block));
+        int threads = static_cast<int>(std::min<long long>(resolveThreadCount(num_threads), max_useful));
+        if (threads <= 1) {
+            func(begin, end);
+            return;
+        }
+
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto runBlock = [&error, &error_mutex](Func& block_func, long long block_begin, long long block_end) {
+            try {
+                block_func(block_begin, block_end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        try {
+            for (int t = 1; t < threads; ++t) {
+                long long block_begin = begin + count * t / threads;
+                long long block_end = begin + count * (t + 1) / threads;
+                // Each worker gets its own copy of func, as std::thread(func, ...) would
+                workers.emplace_back([runBlock, func, block_begin, block_end]() mutable {
+                    runBlock(func, block_begin, block_end);
+                });
+            }
+            runBlock(func, begin, begin + count / threads);
+        } catch (...) {
+            // Thread creation failed: the blocks already started still have to be joined
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * Call func(i) for every i in [begin, end) using contiguous blocks per thread.
+     * Exceptions reach the caller as in parallelForBlocks().
+     * @param begin First index
+     * @param end One past the last index
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     * @param func Callable taking (long long i)
+     * @param min_block Smallest block worth a thread of its own
+     */
+    template <typename Func>
+    void parallelFor(long long begin, long long end, int num_threads, Func func,
+                     long long min_block = 1) {
+        parallelForBlocks(begin, end, num_threads, [&func](long long b, long long e) {
+            for (long long i = b; i < e; ++i) {
+                func(i);
+            }
+        }, min_block);
+    }
+
+} // namespace ParallelUtils
+
+#endif // PARALLEL_UTILS_H
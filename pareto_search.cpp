@@ -0,0 +1,381 @@
+#include "pareto_search.h"
+#include "numerical_solver.h"
+#include "shell_side_model.h"
+#include "tube_layout.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+namespace ParetoSearch {
+
+    namespace {
+        const int NUM_REAL = 4;     // Shell diameter, length, baffle ratio, pitch ratio
+        const int NUM_INT = 3;      // Tube size, passes, layout
+        const int NUM_OBJECTIVES = 3;
+
+        struct Individual {
+            double x[NUM_REAL];
+            int g[NUM_INT];
+            ParetoDesign design;
+            int rank;
+            double crowding;
+        };
+
+        double objective(const ParetoDesign& design, int m) {
+            switch (m) {
+                case 0: return design.tube_area;
+                case 1: return design.pumping_power;
+                default: return design.cost;
+            }
+        }
+
+        // Deb's constraint domination
+        bool dominates(const ParetoDesign& a, const ParetoDesign& b) {
+            bool a_feasible = a.constraint_violation <= 0.0;
+            bool b_feasible = b.constraint_violation <= 0.0;
+            if (a_feasible != b_feasible) {
+                return a_feasible;
+            }
+            if (!a_feasible) {
+                return a.constraint_violation < b.constraint_violation;
+            }
+            bool strictly_better = false;
+            for (int m = 0; m < NUM_OBJECTIVES; ++m) {
+                double fa = objective(a, m), fb = objective(b, m);
+                if (fa > fb) {
+                    return false;
+                }
+                if (fa < fb) {
+                    strictly_better = true;
+                }
+            }
+            return strictly_better;
+        }
+
+        // Fast non-dominated sort; fills rank and returns the fronts
+        std::vector<std::vector<int>> sortFronts(std::vector<Individual>& pop) {
+            int n = static_cast<int>(pop.size());
+            std::vector<std::vector<int>> dominated(n);
+            std::vector<int> dominators(n, 0);
+            std::vector<std::vector<int>> fronts(1);
+            for (int p = 0; p < n; ++p) {
+                for (int q = p + 1; q < n; ++q) {
+                    if (dominates(pop[p].design, pop[q].design)) {
+                        dominated[p].push_back(q);
+                        ++dominators[q];
+                    } else if (dominates(pop[q].design, pop[p].design)) {
+                        dominated[q].push_back(p);
+                        ++dominators[p];
+                    }
+                }
+            }
+            for (int p = 0; p < n; ++p) {
+                if (dominators[p] == 0) {
+                    pop[p].rank = 0;
+                    fronts[0].push_back(p);
+                }
+            }
+            for (size_t f = 0; f < fronts.size() && !fronts[f].empty(); ++f) {
+                std::vector<int> next;
+                for (int p : fronts[f]) {
+                    for (int q : dominated[p]) {
+                        if (--dominators[q] == 0) {
+                            pop[q].rank = static_cast<int>(f) + 1;
+                            next.push_back(q);
+                        }
+                    }
+                }
+                if (!next.empty()) {
+                    fronts.push_back(next);
+                }
+            }
+            return fronts;
+        }
+
+        void assignCrowding(std::vector<Individual>& pop, std::vector<int>& front) {
+            for (int i : front) {
+                pop[i].crowding = 0.0;
+            }
+            if (front.size() <= 2) {
+                for (int i : front) {
+                    pop[i].crowding = std::numeric_limits<double>::infinity();
+                }
+                return;
+            }
+            for (int m = 0; m < NUM_OBJECTIVES; ++m) {
+                std::sort(front.begin(), front.end(), [&](int a, int b) {
+                    return objective(pop[a].design, m) < objective(pop[b].design, m);
+                });
+                double low = objective(pop[front.front()].design, m);
+                double high = objective(pop[front.back()].design, m);
+                pop[front.front()].crowding = std::numeric_limits<double>::infinity();
+                pop[front.back()].crowding = std::numeric_limits<double>::infinity();
+                if (high - low <= 0.0 || !std::isfinite(high - low)) {
+                    continue;
+                }
+                for (size_t k = 1; k + 1 < front.size(); ++k) {
+                    pop[front[k]].crowding += (objective(pop[front[k + 1]].design, m) -
+                                               objective(pop[front[k - 1]].design, m)) / (high - low);
+                }
+            }
+        }
+
+        void bounds(const SearchSpace& space, double lower[NUM_REAL], double upper[NUM_REAL]) {
+            lower[0] = space.shell_diameter_min; upper[0] = space.shell_diameter_max;
+            lower[1] = space.length_min;         upper[1] = space.length_max;
+            lower[2] = space.baffle_ratio_min;   upper[2] = space.baffle_ratio_max;
+            lower[3] = space.pitch_ratio_min;    upper[3] = space.pitch_ratio_max;
+        }
+
+        void decode(Individual& individual, const SearchSpace& space) {
+            const DesignOptimizer::TubeSize& tube = space.tube_sizes[individual.g[0]];
+            ParetoDesign& design = individual.design;
+            design.geometry = GeometryProperties(individual.x[1], individual.x[0],
+                                                 tube.outer_diameter - 2.0 * tube.wall_thickness,
+                                                 tube.wall_thickness, 0, space.wall_thermal_cond);
+            design.baffle_spacing = individual.x[2] * individual.x[0];
+            design.pitch_ratio = individual.x[3];
+            design.tube_passes = space.tube_passes[individual.g[1]];
+            design.layout = space.layouts[individual.g[2]];
+        }
+
+        // Simulated binary crossover on one bounded variable
+        void sbx(double& a, double& b, double lower, double upper, double eta, std::mt19937_64& rng) {
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            if (uniform(rng) > 0.5 || std::abs(a - b) < 1e-14 || upper <= lower) {
+                return;
+            }
+            double y1 = std::min(a, b), y2 = std::max(a, b);
+            double u = uniform(rng);
+            auto spread = [&](double beta) {
+                double alpha = 2.0 - std::pow(beta, -(eta + 1.0));
+                return (u <= 1.0 / alpha) ? std::pow(u * alpha, 1.0 / (eta + 1.0))
+                                          : std::pow(1.0 / (2.0 - u * alpha), 1.0 / (eta + 1.0));
+            };
+            double c1 = 0.5 * ((y1 + y2) - spread(1.0 + 2.0 * (y1 - lower) / (y2 - y1)) * (y2 - y1));
+            double c2 = 0.5 * ((y1 + y2) + spread(1.0 + 2.0 * (upper - y2) / (y2 - y1)) * (y2 - y1));
+            c1 = std::max(lower, std::min(upper, c1));
+            c2 = std::max(lower, std::min(upper, c2));
+            if (uniform(rng) < 0.5) {
+                std::swap(c1, c2);
+            }
+            a = c1;
+            b = c2;
+        }
+
+        // Polynomial mutation on one bounded variable
+        void mutate(double& y, double lower, double upper, double eta, std::mt19937_64& rng) {
+            if (upper <= lower) {
+                return;
+            }
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            double u = uniform(rng);
+            double power = 1.0 / (eta + 1.0);
+            double deltaq;
+            if (u < 0.5) {
+                double xy = 1.0 - (y - lower) / (upper - lower);
+                double value = 2.0 * u + (1.0 - 2.0 * u) * std::pow(xy, eta + 1.0);
+                deltaq = std::pow(value, power) - 1.0;
+            } else {
+                double xy = 1.0 - (upper - y) / (upper - lower);
+                double value = 2.0 * (1.0 - u) + 2.0 * (u - 0.5) * std::pow(xy, eta + 1.0);
+                deltaq = 1.0 - std::pow(value, power);
+            }
+            y = std::max(lower, std::min(upper, y + deltaq * (upper - lower)));
+        }
+    }
+
+    SearchSpace::SearchSpace()
+        : shell_diameter_min(0.2), shell_diameter_max(1.2), length_min(1.0), length_max(7.0),
+          baffle_ratio_min(0.2), baffle_ratio_max(1.0), pitch_ratio_min(1.25), pitch_ratio_max(1.5),
+          tube_sizes{{0.01905, 0.00165}, {0.0254, 0.00211}}, tube_passes{1, 2, 4},
+          layouts{HeatExchangerGeometry::TubeLayout::Triangular30}, wall_thermal_cond(50.0) {}
+
+    SearchSettings::SearchSettings()
+        : population(100), generations(1000), crossover_probability(0.9), crossover_eta(15.0),
+          mutation_eta(20.0), segments(20), max_tube_pressure_drop(70e3), max_shell_pressure_drop(70e3),
+          seed(1), num_threads(0) {}
+
+    void evaluate(ParetoDesign& design, const SearchSpace& space, const DesignOptimizer::Service& service,
+                  const DesignOptimizer::CostModel& cost_model, const SearchSettings& settings) {
+        GeometryProperties& geometry = design.geometry;
+        double tube_od = geometry.tube_diameter + 2.0 * geometry.tube_thickness;
+        double infinity = std::numeric_limits<double>::infinity();
+
+        TubeLayoutSpec spec(geometry.shell_diameter, tube_od, design.pitch_ratio, design.layout);
+        spec.tube_passes = design.tube_passes;
+        geometry.num_tubes = TubeLayoutGenerator::countTubes(spec);
+        if (geometry.num_tubes < design.tube_passes) {
+            design.duty = 0.0;
+            design.tube_pressure_drop = design.shell_pressure_drop = infinity;
+            design.tube_area = design.pumping_power = design.cost = infinity;
+            design.constraint_violation = 10.0;
+            return;
+        }
+        geometry.wall_thermal_cond = space.wall_thermal_cond;
+
+        BaffleConfiguration baffles;
+        baffles.baffle_spacing = design.baffle_spacing;
+        baffles.pitch_ratio = design.pitch_ratio;
+        baffles.layout = design.layout;
+
+        NumericalSolver solver(settings.segments, geometry, service.hot, service.cold);
+        solver.setShellSideModel(std::make_shared<const ShellSideModel>(geometry, baffles));
+        design.duty = solver.solveMultiPass(design.tube_passes).heat_duty;
+
+        design.tube_pressure_drop = HeatExchangerGeometry::tubePressureDrop(
+            service.cold.mass_flow, service.cold.density, service.cold.viscosity, geometry.tube_diameter,
+            geometry.length, geometry.num_tubes, design.tube_passes);
+        design.shell_pressure_drop = HeatExchangerGeometry::shellPressureDrop(
+            service.hot.mass_flow, service.hot.density, service.hot.viscosity, geometry.shell_diameter,
+            tube_od, HeatExchangerGeometry::tubePitch(tube_od, design.pitch_ratio), design.baffle_spacing,
+            geometry.length, design.layout);
+
+        design.tube_area = HeatExchangerGeometry::totalTubeArea(tube_od, geometry.length, geometry.num_tubes);
+        design.pumping_power = design.tube_pressure_drop * service.cold.mass_flow / service.cold.density +
+                               design.shell_pressure_drop * service.hot.mass_flow / service.hot.density;
+        design.cost = cost_model.cost(design.tube_area, geometry.shell_diameter, geometry.length,
+                                      design.tube_passes);
+
+        // Relative shortfalls and excesses
+        design.constraint_violation =
+            std::max(0.0, (service.required_duty - design.duty) / service.required_duty) +
+            std::max(0.0, design.tube_pressure_drop / settings.max_tube_pressure_drop - 1.0) +
+            std::max(0.0, design.shell_pressure_drop / settings.max_shell_pressure_drop - 1.0);
+    }
+
+    ParetoResult search(const SearchSpace& space, const DesignOptimizer::Service& service,
+                        const DesignOptimizer::CostModel& cost_model, const SearchSettings& settings) {
+        auto start = std::chrono::steady_clock::now();
+        ParetoResult result;
+        result.evaluations = 0;
+        result.generations = 0;
+
+        int N = std::max(4, settings.population + (settings.population & 1));
+        int int_range[NUM_INT] = {static_cast<int>(space.tube_sizes.size()),
+                                  static_cast<int>(space.tube_passes.size()),
+                                  static_cast<int>(space.layouts.size())};
+        double lower[NUM_REAL], upper[NUM_REAL];
+        bounds(space, lower, upper);
+
+        std::mt19937_64 rng(settings.seed);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        auto randomIndex = [&](int range) {
+            return std::min(range - 1, static_cast<int>(uniform(rng) * range));
+        };
+
+        auto evaluateAll = [&](std::vector<Individual>& pop, size_t begin) {
+            ParallelUtils::parallelFor(static_cast<long long>(begin), static_cast<long long>(pop.size()),
+                                       settings.num_threads, [&](long long i) {
+                decode(pop[i], space);
+                evaluate(pop[i].design, space, service, cost_model, settings);
+            });
+            result.evaluations += static_cast<long long>(pop.size() - begin);
+        };
+
+        std::vector<Individual> population(N);
+        for (Individual& individual : population) {
+            for (int v = 0; v < NUM_REAL; ++v) {
+                individual.x[v] = lower[v] + uniform(rng) * (upper[v] - lower[v]);
+            }
+            for (int v = 0; v < NUM_INT; ++v) {
+                individual.g[v] = randomIndex(int_range[v]);
+            }
+        }
+        evaluateAll(population, 0);
+        std::vector<std::vector<int>> fronts = sortFronts(population);
+        for (auto& front : fronts) {
+            assignCrowding(population, front);
+        }
+
+        auto tournament = [&]() -> const Individual& {
+            const Individual& a = population[randomIndex(N)];
+            const Individual& b = population[randomIndex(N)];
+            if (a.rank != b.rank) {
+                return a.rank < b.rank ? a : b;
+            }
+            return a.crowding >= b.crowding ? a : b;
+        };
+
+        double mutation_probability = 1.0 / (NUM_REAL + NUM_INT);
+        std::vector<Individual> combined;
+        for (int generation = 0; generation < settings.generations; ++generation) {
+            // Offspring are appended after the parents
+            combined = population;
+            combined.reserve(2 * N);
+            while (static_cast<int>(combined.size()) < 2 * N) {
+                Individual child1 = tournament();
+                Individual child2 = tournament();
+                if (uniform(rng) < settings.crossover_probability) {
+                    for (int v = 0; v < NUM_REAL; ++v) {
+                        sbx(child1.x[v], child2.x[v], lower[v], upper[v], settings.crossover_eta, rng);
+                    }
+                    for (int v = 0; v < NUM_INT; ++v) {
+                        if (uniform(rng) < 0.5) {
+                            std::swap(child1.g[v], child2.g[v]);
+                        }
+                    }
+                }
+                for (Individual* child : {&child1, &child2}) {
+                    for (int v = 0; v < NUM_REAL; ++v) {
+                        if (uniform(rng) < mutation_probability) {
+                            mutate(child->x[v], lower[v], upper[v], settings.mutation_eta, rng);
+                        }
+                    }
+                    for (int v = 0; v < NUM_INT; ++v) {
+                        if (uniform(rng) < mutation_probability) {
+                            child->g[v] = randomIndex(int_range[v]);
+                        }
+                    }
+                    combined.push_back(*child);
+                }
+            }
+            evaluateAll(combined, N);
+
+            // Environmental selection: whole fronts, then the least crowded of the last one
+            fronts = sortFronts(combined);
+            std::vector<Individual> next;
+            next.reserve(N);
+            for (auto& front : fronts) {
+                assignCrowding(combined, front);
+                if (static_cast<int>(next.size() + front.size()) <= N) {
+                    for (int i : front) {
+                        next.push_back(combined[i]);
+                    }
+                } else {
+                    std::sort(front.begin(), front.end(), [&](int a, int b) {
+                        return combined[a].crowding > combined[b].crowding;
+                    });
+                    for (size_t k = 0; static_cast<int>(next.size()) < N; ++k) {
+                        next.push_back(combined[front[k]]);
+                    }
+                }
+                if (static_cast<int>(next.size()) >= N) {
+                    break;
+                }
+            }
+            population.swap(next);
+            fronts = sortFronts(population);
+            for (auto& front : fronts) {
+                assignCrowding(population, front);
+            }
+            result.generations = generation + 1;
+        }
+
+        for (int i : fronts[0]) {
+            if (population[i].design.constraint_violation <= 0.0) {
+                result.front.push_back(population[i].design);
+            }
+        }
+        std::sort(result.front.begin(), result.front.end(),
+                  [](const ParetoDesign& a, const ParetoDesign& b) { return a.tube_area < b.tube_area; });
+
+        result.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+} // namespace ParetoSearch
@@ -0,0 +1,102 @@
+#ifndef PARETO_SEARCH_H
+#define PARETO_SEARCH_H
+
+#include <cstdint>
+#include <vector>
+#include "design_optimizer.h"
+
+/**
+ * @file pareto_search.h
+ * @brief NSGA-II search for designs trading tube area, pumping power and cost
+ *
+ * Continuous variables: shell diameter, length, baffle spacing / shell
+ * diameter, and pitch ratio. Integer variables: indices into the tube sizes,
+ * pass counts and layouts. Tube counts come from TubeLayoutGenerator. The
+ * shell side is rated with the Bell-Delaware ShellSideModel, and the duty
+ * comes from NumericalSolver::solveMultiPass. Pressure drops use
+ * HeatExchangerGeometry::tubePressureDrop and shellPressureDrop. Designs that
+ * miss the duty or a pressure-drop limit are handled by constraint
+ * domination. The objectives are minimised: outside tube area, total
+ * pumping power and cost.
+ * Each generation's offspring are evaluated in parallel. All random draws
+ * happen on the calling thread, so a seed reproduces a run exactly.
+ */
+
+namespace ParetoSearch {
+
+    struct SearchSpace {
+        double shell_diameter_min, shell_diameter_max;  // m
+        double length_min, length_max;                  // m
+        double baffle_ratio_min, baffle_ratio_max;      // Baffle spacing / shell diameter
+        double pitch_ratio_min, pitch_ratio_max;
+        std::vector<DesignOptimizer::TubeSize> tube_sizes;
+        std::vector<int> tube_passes;
+        std::vector<HeatExchangerGeometry::TubeLayout> layouts;
+        double wall_thermal_cond;                       // W/m·K
+
+        SearchSpace();
+    };
+
+    struct SearchSettings {
+        int population;
+        int generations;
+        double crossover_probability;
+        double crossover_eta;               // SBX distribution index
+        double mutation_eta;                // Polynomial mutation distribution index
+        int segments;                       // NumericalSolver segments per evaluation
+        double max_tube_pressure_drop;      // Pa
+        double max_shell_pressure_drop;     // Pa
+        uint64_t seed;
+        int num_threads;                    // 0 = hardware concurrency
+
+        SearchSettings();
+    };
+
+    struct ParetoDesign {
+        GeometryProperties geometry;
+        double pitch_ratio;
+        double baffle_spacing;              // m
+        HeatExchangerGeometry::TubeLayout layout;
+        int tube_passes;
+        double duty;                        // W
+        double tube_pressure_drop;          // Pa
+        double shell_pressure_drop;         // Pa
+        double tube_area;                   // Objective 1: outside tube surface (m²)
+        double pumping_power;               // Objective 2: W, both streams
+        double cost;                        // Objective 3
+        double constraint_violation;        // 0 when feasible
+    };
+
+    struct ParetoResult {
+        std::vector<ParetoDesign> front;    // Non-dominated feasible designs of the final population
+        long long evaluations;
+        int generations;
+        double elapsed_seconds;
+    };
+
+    /**
+     * Evaluate one design (tube count from the layout generator, duty and pressure drops)
+     * @param design Design with geometry variables set; results are filled in
+     * @param space Search space (wall conductivity)
+     * @param service Fluids, flows and required duty
+     * @param cost_model Capital cost estimate
+     * @param settings Solver resolution and pressure-drop limits
+     */
+    void evaluate(ParetoDesign& design, const SearchSpace& space, const DesignOptimizer::Service& service,
+                  const DesignOptimizer::CostModel& cost_model, const SearchSettings& settings);
+
+    /**
+     * Run NSGA-II
+     * @param space Variable bounds and discrete options
+     * @param service Fluids, flows and required duty
+     * @param cost_model Capital cost estimate
+     * @param settings Population, generations, operators and threads
+     * @return Pareto front and evaluation count
+     */
+    ParetoResult search(const SearchSpace& space, const DesignOptimizer::Service& service,
+                        const DesignOptimizer::CostModel& cost_model = DesignOptimizer::CostModel(),
+                        const SearchSettings& settings = SearchSettings());
+
+} // namespace ParetoSearch
+
+#endif // PARETO_SEARCH_H
@@ -0,0 +1,296 @@
+#include "phase_change_solver.h"
+#include "heat_exchanger_geometry.h"
+#include "heat_transfer_correlations.h"
+#include "numerical_solver.h"
+#include "thermal_calculations.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    const int MAX_ROOT_ITERATIONS = 200;
+    const int MAX_FILM_ITERATIONS = 50;
+
+    // 4-point Gauss-Legendre nodes and weights on [-1, 1]
+    const double GAUSS_NODES[4] = {-0.8611363115940526, -0.3399810435848563, 0.3399810435848563, 0.8611363115940526};
+    const double GAUSS_WEIGHTS[4] = {0.3478548451374538, 0.6521451548625461, 0.6521451548625461, 0.3478548451374538};
+
+    double logMeanDifference(double dT_a, double dT_b) {
+        if (std::abs(dT_a - dT_b) <= 1e-9 * std::max(dT_a, dT_b)) {
+            return 0.5 * (dT_a + dT_b);
+        }
+        return (dT_a - dT_b) / std::log(dT_a / dT_b);
+    }
+}
+
+PhaseChangeSolver::PhaseChangeSolver(const GeometryProperties& geom, const TwoPhaseFluid& phase_stream,
+                                     const FluidProperties& other_stream, Service type)
+    : geometry(geom), phase(phase_stream), other(other_stream), service(type) {
+    if (phase.mass_flow <= 0.0 || other.mass_flow <= 0.0) {
+        throw std::invalid_argument("Mass flow rates must be positive");
+    }
+    if (phase.latent_heat <= 0.0 || phase.liquid.specific_heat <= 0.0 || phase.vapor.specific_heat <= 0.0 ||
+        other.specific_heat <= 0.0) {
+        throw std::invalid_argument("Latent heat and specific heats must be positive");
+    }
+    if (phase.inlet_quality < 0.0 || phase.inlet_quality > 1.0) {
+        throw std::invalid_argument("Inlet quality must be between 0 and 1");
+    }
+
+    if (phase.inlet_temp > phase.saturation_temp) {
+        inlet_enthalpy = phase.latent_heat + phase.vapor.specific_heat * (phase.inlet_temp - phase.saturation_temp);
+    } else if (phase.inlet_temp < phase.saturation_temp) {
+        inlet_enthalpy = phase.liquid.specific_heat * (phase.inlet_temp - phase.saturation_temp);
+    } else {
+        inlet_enthalpy = phase.inlet_quality * phase.latent_heat;
+    }
+
+    // Single-phase zones use the solver's own correlations for the liquid or vapour alone
+    auto rate = [&](const FluidProperties& properties, double& phase_htc, double& other_htc) {
+        FluidProperties stream = properties;
+        stream.mass_flow = phase.mass_flow;
+        if (service == Service::Condenser) {
+            NumericalSolver::SolutionResults r = NumericalSolver(1, geometry, stream, other).ratingCoefficients();
+            phase_htc = r.hot_htc;
+            other_htc = r.cold_htc;
+        } else {
+            NumericalSolver::SolutionResults r = NumericalSolver(1, geometry, other, stream).ratingCoefficients();
+            phase_htc = r.cold_htc;
+            other_htc = r.hot_htc;
+        }
+    };
+    rate(phase.liquid, liquid_htc, other_htc_liquid);
+    rate(phase.vapor, vapor_htc, other_htc_vapor);
+}
+
+const char* PhaseChangeSolver::zoneName(ZoneType type) {
+    switch (type) {
+        case ZoneType::Desuperheating: return "desuperheating";
+        case ZoneType::Condensing:     return "condensing";
+        case ZoneType::Subcooling:     return "subcooling";
+        case ZoneType::Preheating:     return "preheating";
+        case ZoneType::Boiling:        return "boiling";
+        case ZoneType::Superheating:   return "superheating";
+    }
+    return "unknown";
+}
+
+double PhaseChangeSolver::temperatureAt(double enthalpy) const {
+    if (enthalpy < 0.0) {
+        return phase.saturation_temp + enthalpy / phase.liquid.specific_heat;
+    }
+    if (enthalpy > phase.latent_heat) {
+        return phase.saturation_temp + (enthalpy - phase.latent_heat) / phase.vapor.specific_heat;
+    }
+    return phase.saturation_temp;
+}
+
+double PhaseChangeSolver::qualityAt(double enthalpy) const {
+    return std::min(std::max(enthalpy / phase.latent_heat, 0.0), 1.0);
+}
+
+void PhaseChangeSolver::twoPhaseCoefficients(double quality_a, double quality_b, double lmtd,
+                                             double& phase_htc, double& other_htc, double& overall_htc) const {
+    double inner_radius = geometry.tube_diameter / 2.0;
+    double outer_radius = inner_radius + geometry.tube_thickness;
+    double outer_diameter = 2.0 * outer_radius;
+
+    if (service == Service::Condenser) {
+        // Shell-side film condensation depends on the wall subcooling, which depends on the film
+        other_htc = other_htc_liquid;
+        int tube_rows = std::max(1, static_cast<int>(std::lround(std::sqrt(static_cast<double>(geometry.num_tubes)))));
+        double subcooling = 0.5 * lmtd;
+        for (int i = 0; i < MAX_FILM_ITERATIONS; ++i) {
+            phase_htc = HeatTransferCorrelations::filmCondensationHorizontalTubes(
+                phase.liquid, phase.vapor.density, phase.latent_heat, subcooling, outer_diameter, tube_rows) *
+                phase.liquid.thermal_cond / outer_diameter;
+            overall_htc = ThermalCalculations::overallHTC(other_htc, phase_htc, inner_radius, outer_radius,
+                                                          geometry.wall_thermal_cond);
+            double next = overall_htc * lmtd * (inner_radius / outer_radius) / phase_htc;
+            if (std::abs(next - subcooling) <= 1e-10 * lmtd) {
+                break;
+            }
+            subcooling = next;
+        }
+        return;
+    }
+
+    // Tube-side flow boiling depends on the heat flux through the boiling number
+    other_htc = other_htc_vapor;
+    double mass_flux = phase.mass_flow /
+        (HeatExchangerGeometry::tubeArea(geometry.tube_diameter) * geometry.num_tubes);
+    double reynolds_liquid_only = mass_flux * geometry.tube_diameter / phase.liquid.viscosity;
+    double density_ratio = phase.liquid.density / phase.vapor.density;
+    double half_width = 0.5 * (quality_b - quality_a);
+    double middle = 0.5 * (quality_a + quality_b);
+    double flux = 0.0;
+    for (int i = 0; i < MAX_FILM_ITERATIONS; ++i) {
+        double boiling_number = flux / (mass_flux * phase.latent_heat);
+        double nusselt = 0.0;
+        for (int k = 0; k < 4; ++k) {
+            nusselt += 0.5 * GAUSS_WEIGHTS[k] * HeatTransferCorrelations::gungorWintertonBoiling(
+                reynolds_liquid_only, phase.liquid.prandtl, middle + half_width * GAUSS_NODES[k],
+                boiling_number, density_ratio);
+        }
+        phase_htc = nusselt * phase.liquid.thermal_cond / geometry.tube_diameter;
+        overall_htc = ThermalCalculations::overallHTC(phase_htc, other_htc, inner_radius, outer_radius,
+                                                      geometry.wall_thermal_cond);
+        double next = overall_htc * lmtd;
+        if (std::abs(next - flux) <= 1e-10 * next) {
+            break;
+        }
+        flux = next;
+    }
+}
+
+double PhaseChangeSolver::areaForDuty(double duty, std::vector<Zone>* zones) const {
+    const double infinite = std::numeric_limits<double>::infinity();
+    bool condenser = (service == Service::Condenser);
+    double sign = condenser ? 1.0 : -1.0;       // Phase-change stream temperature minus the other's, in sign
+    double C_other = other.mass_flow * other.specific_heat;
+    double inner_radius = geometry.tube_diameter / 2.0;
+    double outer_radius = inner_radius + geometry.tube_thickness;
+    double area_per_length = HeatExchangerGeometry::totalTubeArea(geometry.tube_diameter, 1.0, geometry.num_tubes);
+
+    double outlet_enthalpy = inlet_enthalpy - sign * duty / phase.mass_flow;
+    double h_a = inlet_enthalpy;
+    double T_other_a = other.inlet_temp + sign * duty / C_other;    // Counter-current: other stream's outlet
+    double tolerance = 1e-12 * phase.latent_heat;
+    double area = 0.0;
+    if (zones) {
+        zones->clear();
+    }
+
+    while (sign * (h_a - outlet_enthalpy) > tolerance) {
+        // Zone ends at the next saturation boundary or the outlet
+        double h_b;
+        if (condenser) {
+            h_b = h_a > phase.latent_heat + tolerance ? phase.latent_heat : (h_a > tolerance ? 0.0 : outlet_enthalpy);
+            h_b = std::max(h_b, outlet_enthalpy);
+        } else {
+            h_b = h_a < -tolerance ? 0.0 : (h_a < phase.latent_heat - tolerance ? phase.latent_heat : outlet_enthalpy);
+            h_b = std::min(h_b, outlet_enthalpy);
+        }
+
+        double zone_duty = phase.mass_flow * std::abs(h_a - h_b);
+        double T_phase_a = temperatureAt(h_a);
+        double T_phase_b = temperatureAt(h_b);
+        double T_other_b = T_other_a - sign * zone_duty / C_other;
+        double dT_a = sign * (T_phase_a - T_other_a);
+        double dT_b = sign * (T_phase_b - T_other_b);
+        if (dT_a <= 0.0 || dT_b <= 0.0) {
+            return infinite;        // Temperature cross: the trial duty is not reachable
+        }
+        double lmtd = logMeanDifference(dT_a, dT_b);
+
+        double middle = 0.5 * (h_a + h_b);
+        Zone zone;
+        if (middle < 0.0) {
+            zone.type = condenser ? ZoneType::Subcooling : ZoneType::Preheating;
+            zone.phase_htc = liquid_htc;
+            zone.other_htc = other_htc_liquid;
+        } else if (middle > phase.latent_heat) {
+            zone.type = condenser ? ZoneType::Desuperheating : ZoneType::Superheating;
+            zone.phase_htc = vapor_htc;
+            zone.other_htc = other_htc_vapor;
+        } else {
+            zone.type = condenser ? ZoneType::Condensing : ZoneType::Boiling;
+        }
+        if (middle < 0.0 || middle > phase.latent_heat) {
+            zone.overall_htc = condenser
+                ? ThermalCalculations::overallHTC(zone.other_htc, zone.phase_htc, inner_radius, outer_radius,
+                                                  geometry.wall_thermal_cond)
+                : ThermalCalculations::overallHTC(zone.phase_htc, zone.other_htc, inner_radius, outer_radius,
+                                                  geometry.wall_thermal_cond);
+        } else {
+            twoPhaseCoefficients(qualityAt(h_a), qualityAt(h_b), lmtd,
+                                 zone.phase_htc, zone.other_htc, zone.overall_htc);
+        }
+
+        double zone_area = zone_duty / (zone.overall_htc * lmtd);
+        if (zones) {
+            zone.start = area / area_per_length;
+            zone.length = zone_area / area_per_length;
+            zone.duty = zone_duty;
+            zone.lmtd = lmtd;
+            zone.phase_temp_in = T_phase_a;
+            zone.phase_temp_out = T_phase_b;
+            zone.quality_in = qualityAt(h_a);
+            zone.quality_out = qualityAt(h_b);
+            zone.other_temp_start = T_other_a;
+            zone.other_temp_end = T_other_b;
+            zones->push_back(zone);
+        }
+        area += zone_area;
+        h_a = h_b;
+        T_other_a = T_other_b;
+    }
+    return area;
+}
+
+PhaseChangeSolver::Results PhaseChangeSolver::solve() const {
+    bool condenser = (service == Service::Condenser);
+    double sign = condenser ? 1.0 : -1.0;
+    double C_other = other.mass_flow * other.specific_heat;
+    double total_area = HeatExchangerGeometry::totalTubeArea(geometry.tube_diameter, geometry.length, geometry.num_tubes);
+
+    // Largest duty either stream could deliver; the pinch is usually reached earlier
+    double T_other = other.inlet_temp;
+    double limit_enthalpy = T_other < phase.saturation_temp
+        ? phase.liquid.specific_heat * (T_other - phase.saturation_temp)
+        : phase.latent_heat + phase.vapor.specific_heat * (T_other - phase.saturation_temp);
+    double duty_limit = std::min(phase.mass_flow * sign * (inlet_enthalpy - limit_enthalpy),
+                                 C_other * sign * (temperatureAt(inlet_enthalpy) - T_other));
+
+    Results results;
+    results.iterations = 0;
+    results.converged = true;
+    double duty = 0.0;
+    if (duty_limit > 0.0 && total_area > 0.0) {
+        // Illinois false position on A(Q) - A_total; an unreachable trial duty bisects instead
+        double low = 0.0, f_low = -total_area;
+        double high = duty_limit, f_high = std::numeric_limits<double>::infinity();
+        int stale_side = 0;
+        results.converged = false;
+        for (int i = 0; i < MAX_ROOT_ITERATIONS; ++i) {
+            ++results.iterations;
+            double trial = std::isfinite(f_high)
+                ? (low * f_high - high * f_low) / (f_high - f_low)
+                : 0.5 * (low + high);
+            if (!(trial > low && trial < high)) {
+                trial = 0.5 * (low + high);
+            }
+            double f = areaForDuty(trial, nullptr) - total_area;
+            if (f < 0.0) {
+                low = trial;
+                f_low = f;
+                if (stale_side == -1 && std::isfinite(f_high)) {
+                    f_high *= 0.5;
+                }
+                stale_side = -1;
+            } else {
+                high = trial;
+                f_high = f;
+                if (stale_side == 1) {
+                    f_low *= 0.5;
+                }
+                stale_side = 1;
+            }
+            if (std::abs(f) <= 1e-10 * total_area || high - low <= 1e-12 * duty_limit) {
+                duty = trial;
+                results.converged = true;
+                break;
+            }
+            duty = low;
+        }
+    }
+
+    areaForDuty(duty, &results.zones);
+    double outlet_enthalpy = inlet_enthalpy - sign * duty / phase.mass_flow;
+    results.duty = duty;
+    results.phase_outlet_temp = temperatureAt(outlet_enthalpy);
+    results.phase_outlet_quality = qualityAt(outlet_enthalpy);
+    results.other_outlet_temp = other.inlet_temp + sign * duty / C_other;
+    return results;
+}
@@ -0,0 +1,105 @@
+#ifndef PHASE_CHANGE_SOLVER_H
+#define PHASE_CHANGE_SOLVER_H
+
+#include <vector>
+#include "fluid_properties.h"
+
+/**
+ * @file phase_change_solver.h
+ * @brief Zone-based counter-current rating of condensers and evaporators
+ *
+ * The phase-change stream is split at its saturated vapour and saturated
+ * liquid states into up to three zones: desuperheating, condensing and
+ * subcooling in a condenser, or preheating, boiling and superheating in an
+ * evaporator. Within a zone both streams have a constant heat capacity rate
+ * (infinite while the stream changes phase) and a constant overall
+ * coefficient, so each zone is integrated exactly by its log-mean
+ * temperature difference. The heat duty is found by root-finding on the
+ * energy balance: the zone areas implied by a trial duty must add up to the
+ * exchanger's area. Zone boundaries follow from the converged duty. The
+ * two-phase zone's coefficient is averaged over quality (Gauss-Legendre)
+ * and iterated with its wall temperature or heat flux.
+ *
+ * A condenser's phase-change stream is the hot shell-side fluid. An
+ * evaporator's is the cold tube-side fluid. The other stream is single-phase.
+ */
+
+class PhaseChangeSolver {
+public:
+    enum class Service {
+        Condenser,      // Phase-change stream is hot (shell side)
+        Evaporator      // Phase-change stream is cold (tube side)
+    };
+
+    enum class ZoneType {
+        Desuperheating, Condensing, Subcooling,
+        Preheating, Boiling, Superheating
+    };
+
+    struct Zone {
+        ZoneType type;
+        double start;               // m, from the phase-change stream inlet
+        double length;              // m
+        double duty;                // W
+        double overall_htc;         // W/m²·K (tube inner area)
+        double phase_htc;           // W/m²·K, phase-change side
+        double other_htc;           // W/m²·K, single-phase side
+        double lmtd;                // K
+        double phase_temp_in;       // K, phase-change stream at the zone's upstream end
+        double phase_temp_out;      // K
+        double quality_in;          // Vapour fraction (0 or 1 outside the two-phase zone)
+        double quality_out;
+        double other_temp_start;    // K, single-phase stream at the zone's upstream end
+        double other_temp_end;      // K
+    };
+
+    struct Results {
+        std::vector<Zone> zones;            // In phase-change stream flow order
+        double duty;                        // W
+        double phase_outlet_temp;           // K
+        double phase_outlet_quality;        // Vapour fraction at the outlet
+        double other_outlet_temp;           // K
+        int iterations;                     // Energy balance root-finding steps
+        bool converged;
+    };
+
+    /**
+     * @param geom Exchanger geometry
+     * @param phase_stream Condensing or boiling stream
+     * @param other Single-phase stream
+     * @param service Condenser (phase_stream hot, shell side) or evaporator (cold, tube side)
+     */
+    PhaseChangeSolver(const GeometryProperties& geom, const TwoPhaseFluid& phase_stream,
+                      const FluidProperties& other, Service service);
+
+    /**
+     * Rate the exchanger
+     * @return Zones, duty and outlet states
+     */
+    Results solve() const;
+
+    static const char* zoneName(ZoneType type);
+
+private:
+    GeometryProperties geometry;
+    TwoPhaseFluid phase;
+    FluidProperties other;
+    Service service;
+    double inlet_enthalpy;          // J/kg relative to saturated liquid
+    double liquid_htc;              // Phase-change side, liquid only (W/m²·K)
+    double vapor_htc;               // Phase-change side, vapour only
+    double other_htc_liquid;        // Single-phase side, rated against the liquid zone
+    double other_htc_vapor;         // Single-phase side, rated against the vapour zone
+
+    double temperatureAt(double enthalpy) const;
+    double qualityAt(double enthalpy) const;
+
+    // Two-phase zone coefficient for a zone mean temperature difference
+    void twoPhaseCoefficients(double quality_a, double quality_b, double lmtd,
+                              double& phase_htc, double& other_htc, double& overall_htc) const;
+
+    // Area needed for a trial duty (infinite if a zone pinches); fills zones when given
+    double areaForDuty(double duty, std::vector<Zone>* zones) const;
+};
+
+#endif // PHASE_CHANGE_SOLVER_H
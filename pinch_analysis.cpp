@@ -0,0 +1,179 @@
+#include "pinch_analysis.h"
+#include "parallel_utils.h"
+#include "thermal_calculations.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+PinchAnalysis::PinchAnalysis(const std::vector<FluidProperties>& streams)
+    : hot_streams(0), cold_streams(0), hot_duty(0.0), cold_duty(0.0) {
+    for (const FluidProperties& stream : streams) {
+        if (!std::isfinite(stream.inlet_temp) || !std::isfinite(stream.outlet_temp)) {
+            throw std::invalid_argument("Stream temperatures must be finite");
+        }
+        if (!(stream.mass_flow > 0.0) || !(stream.specific_heat > 0.0)) {
+            throw std::invalid_argument("Stream mass flow and specific heat must be positive");
+        }
+        double rate = ThermalCalculations::heatCapacityRate(stream.mass_flow, stream.specific_heat);
+        if (stream.inlet_temp > stream.outlet_temp) {
+            // Hot: starts at its supply temperature, stops at its target
+            hot_ends.push_back({stream.inlet_temp, rate});
+            hot_ends.push_back({stream.outlet_temp, -rate});
+            hot_duty += rate * (stream.inlet_temp - stream.outlet_temp);
+            hot_streams++;
+        } else if (stream.inlet_temp < stream.outlet_temp) {
+            // Cold: demand starts at its target temperature, stops at its supply
+            cold_ends.push_back({stream.outlet_temp, -rate});
+            cold_ends.push_back({stream.inlet_temp, rate});
+            cold_duty += rate * (stream.outlet_temp - stream.inlet_temp);
+            cold_streams++;
+        }
+    }
+
+    auto descending = [](const StreamEnd& a, const StreamEnd& b) { return a.temperature > b.temperature; };
+    std::sort(hot_ends.begin(), hot_ends.end(), descending);
+    std::sort(cold_ends.begin(), cold_ends.end(), descending);
+}
+
+void PinchAnalysis::validateApproach(double delta_t_min) {
+    if (!(delta_t_min >= 0.0) || !std::isfinite(delta_t_min)) {
+        throw std::invalid_argument("Minimum approach temperature must be finite and non-negative");
+    }
+}
+
+template <typename Visit>
+PinchAnalysis::Targets PinchAnalysis::cascade(double delta_t_min, Visit visit) const {
+    validateApproach(delta_t_min);
+
+    Targets result;
+    result.delta_t_min = delta_t_min;
+    result.hot_utility = 0.0;
+    result.cold_utility = 0.0;
+    result.heat_recovery = 0.0;
+    result.pinch_temperature = std::numeric_limits<double>::quiet_NaN();
+    result.hot_pinch_temperature = result.pinch_temperature;
+    result.cold_pinch_temperature = result.pinch_temperature;
+    result.threshold = true;
+
+    const double half = 0.5 * delta_t_min;
+    const std::size_t hot_count = hot_ends.size();
+    const std::size_t cold_count = cold_ends.size();
+    if (hot_count == 0 && cold_count == 0) {
+        return result;
+    }
+
+    // Differences below this are rounding in the running sum, not a lower pinch
+    const double tolerance = 1e-12 * (hot_duty + cold_duty);
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    auto nextTemperature = [&]() {
+        double t = -std::numeric_limits<double>::infinity();
+        if (i < hot_count) t = std::max(t, hot_ends[i].temperature - half);
+        if (j < cold_count) t = std::max(t, cold_ends[j].temperature + half);
+        return t;
+    };
+
+    double upper = nextTemperature();
+    double net_rate = 0.0;
+    double surplus = 0.0;               // Cascaded from the top without utility
+    double lowest = 0.0;
+    double pinch = upper;
+
+    while (i < hot_count || j < cold_count) {
+        double t = nextTemperature();
+        if (t < upper) {
+            surplus += net_rate * (upper - t);
+            visit(upper, t, net_rate, surplus);
+            if (surplus < lowest - tolerance) {
+                lowest = surplus;
+                pinch = t;
+            }
+            upper = t;
+        }
+        // Every end at this shifted temperature changes the rate of the interval below
+        while (i < hot_count && hot_ends[i].temperature - half >= t) {
+            net_rate += hot_ends[i++].rate_change;
+        }
+        while (j < cold_count && cold_ends[j].temperature + half >= t) {
+            net_rate += cold_ends[j++].rate_change;
+        }
+    }
+
+    result.hot_utility = lowest < 0.0 ? -lowest : 0.0;
+    result.cold_utility = std::max(0.0, surplus + result.hot_utility);
+    result.heat_recovery = std::max(0.0, hot_duty - result.cold_utility);
+    result.pinch_temperature = pinch;
+    result.hot_pinch_temperature = pinch + half;
+    result.cold_pinch_temperature = pinch - half;
+    result.threshold = result.hot_utility <= tolerance || result.cold_utility <= tolerance;
+    return result;
+}
+
+PinchAnalysis::Targets PinchAnalysis::targets(double delta_t_min) const {
+    return cascade(delta_t_min, [](double, double, double, double) {});
+}
+
+PinchAnalysis::Results PinchAnalysis::analyse(double delta_t_min) const {
+    Results results;
+    std::vector<double> cumulative;
+    results.targets = cascade(delta_t_min, [&](double upper, double lower, double net_rate, double surplus) {
+        CascadeInterval interval;
+        interval.upper_temperature = upper;
+        interval.lower_temperature = lower;
+        interval.net_heat_capacity_rate = net_rate;
+        interval.surplus = net_rate * (upper - lower);
+        interval.heat_flow = 0.0;
+        results.cascade.push_back(interval);
+        cumulative.push_back(surplus);
+    });
+
+    const double hot_utility = results.targets.hot_utility;
+    for (std::size_t k = 0; k < results.cascade.size(); ++k) {
+        results.cascade[k].heat_flow = cumulative[k] + hot_utility;
+    }
+
+    if (!results.cascade.empty()) {
+        results.grand_composite.reserve(results.cascade.size() + 1);
+        results.grand_composite.push_back({results.cascade.front().upper_temperature, hot_utility});
+        for (const CascadeInterval& interval : results.cascade) {
+            results.grand_composite.push_back({interval.lower_temperature, interval.heat_flow});
+        }
+    }
+
+    // Composite curves on actual temperatures, built upwards from the coldest end.
+    // Passing an end upwards undoes the rate change it makes downwards.
+    auto composite = [](const std::vector<StreamEnd>& ends, double sign, double start_enthalpy) {
+        std::vector<CurvePoint> curve;
+        double rate = 0.0;
+        double enthalpy = start_enthalpy;
+        for (std::size_t k = ends.size(); k-- > 0;) {
+            double t = ends[k].temperature;
+            if (curve.empty() || t > curve.back().temperature) {
+                if (!curve.empty()) {
+                    enthalpy += rate * (t - curve.back().temperature);
+                }
+                curve.push_back({t, enthalpy});
+            }
+            rate += sign * ends[k].rate_change;
+        }
+        return curve;
+    };
+    results.hot_composite = composite(hot_ends, -1.0, 0.0);
+    results.cold_composite = composite(cold_ends, 1.0, results.targets.cold_utility);
+    return results;
+}
+
+std::vector<PinchAnalysis::Targets> PinchAnalysis::sweep(const std::vector<double>& delta_t_min,
+                                                         int num_threads) const {
+    for (double value : delta_t_min) {
+        validateApproach(value);
+    }
+    std::vector<Targets> results(delta_t_min.size());
+    ParallelUtils::parallelFor(0, static_cast<long long>(delta_t_min.size()), num_threads,
+        [&](long long k) {
+            results[k] = targets(delta_t_min[k]);
+        });
+    return results;
+}
@@ -0,0 +1,119 @@
+#ifndef PINCH_ANALYSIS_H
+#define PINCH_ANALYSIS_H
+
+#include <vector>
+#include "fluid_properties.h"
+
+/**
+ * @file pinch_analysis.h
+ * @brief Site-wide heat recovery targets: problem table cascade, composite curves and pinch
+ *
+ * Process streams are given as FluidProperties: inlet_temp is the supply
+ * temperature, outlet_temp the target temperature, and mass_flow times
+ * specific_heat the heat capacity rate (ThermalCalculations::heatCapacityRate).
+ * A stream is hot if it must be cooled (supply above target) and cold
+ * otherwise. Streams with equal supply and target temperatures are ignored.
+ *
+ * Hot streams are shifted down by ΔTmin/2 and cold streams up by ΔTmin/2.
+ * The shifted start and end temperatures of all streams split the range into
+ * intervals, and the net heat surplus of each interval is cascaded from the
+ * top. The largest deficit in the cascade is the minimum hot utility; the
+ * bottom of the cascade, plus that hot utility, is the minimum cold utility.
+ * The pinch is where the cascade, including the hot utility, is zero.
+ *
+ * The stream ends are sorted once, at construction, in two lists (hot and
+ * cold). A shift moves every end of a list by the same amount and keeps its
+ * order, so for each ΔTmin the two lists are merged in O(n) and the cascade
+ * is swept in the same pass. Preparing n streams costs O(n log n), and each
+ * target after that costs O(n).
+ */
+
+class PinchAnalysis {
+public:
+    struct Targets {
+        double delta_t_min;             // K
+        double hot_utility;             // W, minimum
+        double cold_utility;            // W, minimum
+        double heat_recovery;           // W, hot stream duty recovered by cold streams
+        double pinch_temperature;       // K, shifted scale
+        double hot_pinch_temperature;   // K, hot streams at the pinch
+        double cold_pinch_temperature;  // K, cold streams at the pinch
+        bool threshold;                 // Only one utility is needed (the pinch is at an end of the cascade)
+    };
+
+    struct CascadeInterval {
+        double upper_temperature;       // K, shifted
+        double lower_temperature;       // K, shifted
+        double net_heat_capacity_rate;  // W/K, hot minus cold streams in the interval
+        double surplus;                 // W, net_heat_capacity_rate times the interval width
+        double heat_flow;               // W, cascaded to the interval below (hot utility included)
+    };
+
+    struct CurvePoint {
+        double temperature;             // K
+        double enthalpy;                // W
+    };
+
+    struct Results {
+        Targets targets;
+        std::vector<CascadeInterval> cascade;       // Hottest interval first
+        std::vector<CurvePoint> hot_composite;      // Ascending temperature, enthalpy from 0
+        std::vector<CurvePoint> cold_composite;     // Ascending temperature, enthalpy from the cold utility
+        std::vector<CurvePoint> grand_composite;    // Shifted temperature against cascaded heat, hottest first
+    };
+
+    /**
+     * @param streams Process streams (supply inlet_temp, target outlet_temp, mass_flow, specific_heat)
+     */
+    explicit PinchAnalysis(const std::vector<FluidProperties>& streams);
+
+    /**
+     * Minimum utilities and pinch (one O(n) merge and sweep)
+     * @param delta_t_min Minimum approach temperature (K)
+     */
+    Targets targets(double delta_t_min) const;
+
+    /**
+     * Targets together with the cascade and the composite and grand composite curves
+     * @param delta_t_min Minimum approach temperature (K)
+     */
+    Results analyse(double delta_t_min) const;
+
+    /**
+     * Targets for many ΔTmin values, split across threads
+     * @param delta_t_min Minimum approach temperatures (K)
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     * @return Targets in the order of delta_t_min
+     */
+    std::vector<Targets> sweep(const std::vector<double>& delta_t_min, int num_threads = 0) const;
+
+    int hotStreamCount() const { return hot_streams; }
+    int coldStreamCount() const { return cold_streams; }
+    double hotDuty() const { return hot_duty; }       // W, all hot streams
+    double coldDuty() const { return cold_duty; }     // W, all cold streams
+
+private:
+    // A stream end: where the stream starts (entering the cascade from above) or stops
+    struct StreamEnd {
+        double temperature;             // K, actual
+        double rate_change;             // W/K added to the net rate below this temperature
+    };
+
+    std::vector<StreamEnd> hot_ends;    // Descending temperature
+    std::vector<StreamEnd> cold_ends;   // Descending temperature
+    int hot_streams;
+    int cold_streams;
+    double hot_duty;
+    double cold_duty;
+
+    /**
+     * Merge the shifted ends and sweep the cascade from the top
+     * @param visit Called per interval with (upper, lower, net rate, cumulative surplus at lower), or null
+     */
+    template <typename Visit>
+    Targets cascade(double delta_t_min, Visit visit) const;
+
+    static void validateApproach(double delta_t_min);
+};
+
+#endif // PINCH_ANALYSIS_H
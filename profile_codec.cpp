@@ -0,0 +1,468 @@
+#include "profile_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    const char MAGIC[8] = {'T', 'C', 'P', 'R', 'O', 'F', 'L', '\0'};
+    const uint32_t ENDIAN_MARKER = 0x01020304;
+    const double MAX_RATE = 500.0;           // |z| bound; expm1 overflows beyond 709
+
+    struct RecordHeader {
+        uint32_t stations;
+        uint32_t segment_count;
+        float x_start;
+        float hot_start;
+        float cold_start;
+        float max_error;
+    };
+
+    static_assert(sizeof(ProfileCodec::Segment) == 5 * sizeof(float), "Segment must be unpadded");
+    static_assert(sizeof(RecordHeader) == 24, "RecordHeader must be unpadded");
+
+    // Fraction of a segment's temperature change reached at fraction s of its length
+    double shape(double z, double s) {
+        if (std::fabs(z) < 1e-9) {
+            return s;
+        }
+        return std::expm1(z * s) / std::expm1(z);
+    }
+
+    double shapeSlope(double z, double s) {
+        if (std::fabs(z) < 1e-6) {
+            return s * (s - 1.0) / 2.0;
+        }
+        double a = std::expm1(z * s);
+        double b = std::expm1(z);
+        return (s * (a + 1.0) * b - a * (b + 1.0)) / (b * b);
+    }
+
+    /**
+     * Rate z with shape(z, s) = r, for 0 < s < 1 and 0 < r < 1. shape() falls
+     * monotonically in z, so Newton steps are kept inside a shrinking bracket.
+     * The starting guess is exact for s = 1/2 and for small z.
+     */
+    double fitRate(double s, double r) {
+        double lo = -MAX_RATE;
+        double hi = MAX_RATE;
+        if (r >= shape(lo, s)) {
+            return lo;
+        }
+        if (r <= shape(hi, s)) {
+            return hi;
+        }
+        double z = 2.0 * (std::log(s / (1.0 - s)) - std::log(r / (1.0 - r)));
+        z = std::max(lo, std::min(hi, z));
+        for (int iter = 0; iter < 60; ++iter) {
+            double f = shape(z, s) - r;
+            if (f > 0.0) {
+                lo = z;
+            } else {
+                hi = z;
+            }
+            double next = z - f / shapeSlope(z, s);
+            if (!(next > lo && next < hi)) {
+                next = 0.5 * (lo + hi);
+            }
+            if (std::fabs(next - z) <= 1e-12 * (1.0 + std::fabs(z))) {
+                return next;
+            }
+            z = next;
+        }
+        return z;
+    }
+
+    /**
+     * One stream over one segment, with 1 / expm1(z) computed once for
+     * evaluation at many stations
+     */
+    struct StreamCurve {
+        double t0, dt, z, scale;
+
+        StreamCurve(double start, double end, double rate)
+            : t0(start), dt(end - start), z(rate),
+              scale(std::fabs(rate) < 1e-9 ? 0.0 : 1.0 / std::expm1(rate)) {}
+
+        double value(double s) const {
+            return t0 + dt * (scale == 0.0 ? s : std::expm1(z * s) * scale);
+        }
+    };
+
+    // Rate of one stream over stations [i, j], from the station nearest the middle
+    float streamRate(const std::vector<double>& x, const std::vector<double>& t,
+                     int i, int j, float x0, float x1, float t0, float t1) {
+        if (j - i < 2 || t1 == t0 || x1 <= x0) {
+            return 0.0f;
+        }
+        int m = i + (j - i) / 2;
+        double s = (x[m] - x0) / (static_cast<double>(x1) - x0);
+        double r = (t[m] - t0) / (static_cast<double>(t1) - t0);
+        if (!(s > 0.0 && s < 1.0 && r > 0.0 && r < 1.0)) {
+            return 0.0f;            // No exponential through these points; linear, checked below
+        }
+        return static_cast<float>(fitRate(s, r));
+    }
+
+    class SegmentFitter {
+    public:
+        SegmentFitter(const std::vector<double>& positions, const std::vector<double>& hot,
+                      const std::vector<double>& cold)
+            : x(positions), hot(hot), cold(cold) {}
+
+        /**
+         * Fit the segment over stations [i, j] starting from the stored values
+         * of station i, and measure its error after rounding
+         * @param limit Stop measuring once the error exceeds this (K)
+         * @return Worst station error, or a value above limit
+         */
+        double fit(int i, int j, float x0, float hot0, float cold0, double limit, ProfileCodec::Segment& segment) const {
+            segment.x_end = static_cast<float>(x[j]);
+            segment.hot_end = static_cast<float>(hot[j]);
+            segment.cold_end = static_cast<float>(cold[j]);
+            segment.hot_rate = streamRate(x, hot, i, j, x0, segment.x_end, hot0, segment.hot_end);
+            segment.cold_rate = streamRate(x, cold, i, j, x0, segment.x_end, cold0, segment.cold_end);
+
+            StreamCurve hot_curve(hot0, segment.hot_end, segment.hot_rate);
+            StreamCurve cold_curve(cold0, segment.cold_end, segment.cold_rate);
+            double span = static_cast<double>(segment.x_end) - x0;
+            double error = 0.0;
+            for (int k = i; k <= j; ++k) {
+                double s = span > 0.0 ? std::min(1.0, std::max(0.0, (x[k] - x0) / span)) : 1.0;
+                double dh = hot_curve.value(s) - hot[k];
+                double dc = cold_curve.value(s) - cold[k];
+                error = std::max(error, std::max(std::fabs(dh), std::fabs(dc)));
+                if (!(error <= limit)) {
+                    return std::numeric_limits<double>::infinity();
+                }
+            }
+            return error;
+        }
+
+    private:
+        const std::vector<double>& x;
+        const std::vector<double>& hot;
+        const std::vector<double>& cold;
+    };
+}
+
+namespace ProfileCodec {
+
+    void EncodedProfile::evaluate(double x, double& hot, double& cold) const {
+        if (segments.empty() || x <= x_start) {
+            hot = hot_start;
+            cold = cold_start;
+            return;
+        }
+        auto it = std::lower_bound(segments.begin(), segments.end(), x,
+                                   [](const Segment& segment, double value) { return segment.x_end < value; });
+        if (it == segments.end()) {
+            hot = segments.back().hot_end;
+            cold = segments.back().cold_end;
+            return;
+        }
+        double x0 = x_start, hot0 = hot_start, cold0 = cold_start;
+        if (it != segments.begin()) {
+            const Segment& previous = *(it - 1);
+            x0 = previous.x_end;
+            hot0 = previous.hot_end;
+            cold0 = previous.cold_end;
+        }
+        double span = it->x_end - x0;
+        double s = span > 0.0 ? (x - x0) / span : 1.0;
+        hot = StreamCurve(hot0, it->hot_end, it->hot_rate).value(s);
+        cold = StreamCurve(cold0, it->cold_end, it->cold_rate).value(s);
+    }
+
+    size_t EncodedProfile::encodedBytes() const {
+        return sizeof(RecordHeader) + segments.size() * sizeof(Segment);
+    }
+
+    EncodedProfile encode(const std::vector<double>& positions, const std::vector<double>& hot,
+                          const std::vector<double>& cold, double tolerance) {
+        if (hot.size() != positions.size() || cold.size() != positions.size()) {
+            throw std::invalid_argument("Profile positions and temperatures must have the same length");
+        }
+        if (!(tolerance > 0.0)) {
+            throw std::invalid_argument("Profile tolerance must be positive");
+        }
+        for (size_t k = 1; k < positions.size(); ++k) {
+            if (!(positions[k] > positions[k - 1])) {
+                throw std::invalid_argument("Profile positions must be strictly increasing");
+            }
+        }
+
+        EncodedProfile profile;
+        profile.stations = static_cast<uint32_t>(positions.size());
+        profile.x_start = positions.empty() ? 0.0f : static_cast<float>(positions[0]);
+        profile.hot_start = positions.empty() ? 0.0f : static_cast<float>(hot[0]);
+        profile.cold_start = positions.empty() ? 0.0f : static_cast<float>(cold[0]);
+        profile.max_error = 0.0f;
+        if (positions.empty()) {
+            return profile;
+        }
+        double max_error = std::max(std::fabs(profile.hot_start - hot[0]), std::fabs(profile.cold_start - cold[0]));
+
+        SegmentFitter fitter(positions, hot, cold);
+        int last = static_cast<int>(positions.size()) - 1;
+        int i = 0;
+        float x0 = profile.x_start, hot0 = profile.hot_start, cold0 = profile.cold_start;
+        while (i < last) {
+            Segment best, trial;
+            int best_end;
+            double best_error = fitter.fit(i, last, x0, hot0, cold0, tolerance, best);
+            if (best_error <= tolerance) {
+                best_end = last;
+            } else {
+                // A single interval is always kept, even if rounding alone exceeds the tolerance
+                best_end = i + 1;
+                best_error = fitter.fit(i, best_end, x0, hot0, cold0, std::numeric_limits<double>::infinity(), best);
+
+                // Grow by doubling, then bisect between the longest fit and the first failure
+                int fail = last;
+                for (int step = 2; i + step < fail; step *= 2) {
+                    double error = fitter.fit(i, i + step, x0, hot0, cold0, tolerance, trial);
+                    if (error > tolerance) {
+                        fail = i + step;
+                        break;
+                    }
+                    best = trial;
+                    best_end = i + step;
+                    best_error = error;
+                }
+                while (fail - best_end > 1) {
+                    int mid = best_end + (fail - best_end) / 2;
+                    double error = fitter.fit(i, mid, x0, hot0, cold0, tolerance, trial);
+                    if (error > tolerance) {
+                        fail = mid;
+                    } else {
+                        best = trial;
+                        best_end = mid;
+                        best_error = error;
+                    }
+                }
+            }
+            profile.segments.push_back(best);
+            max_error = std::max(max_error, best_error);
+            i = best_end;
+            x0 = best.x_end;
+            hot0 = best.hot_end;
+            cold0 = best.cold_end;
+        }
+        profile.max_error = static_cast<float>(max_error);
+        // Keep the stored bound conservative after rounding it to float
+        if (profile.max_error < max_error) {
+            profile.max_error = std::nextafter(profile.max_error, std::numeric_limits<float>::infinity());
+        }
+        return profile;
+    }
+
+    EncodedProfile encode(const NumericalSolver::SolutionResults& results, double tolerance) {
+        return encode(results.positions, results.hot_temperatures, results.cold_temperatures, tolerance);
+    }
+
+    void decode(const EncodedProfile& profile, const std::vector<double>& positions,
+                std::vector<double>& hot, std::vector<double>& cold) {
+        hot.resize(positions.size());
+        cold.resize(positions.size());
+        if (profile.segments.empty()) {
+            std::fill(hot.begin(), hot.end(), static_cast<double>(profile.hot_start));
+            std::fill(cold.begin(), cold.end(), static_cast<double>(profile.cold_start));
+            return;
+        }
+
+        // Curves of the current segment are reused while positions stay inside it
+        size_t current = 0;
+        double x0 = profile.x_start;
+        StreamCurve hot_curve(profile.hot_start, profile.segments[0].hot_end, profile.segments[0].hot_rate);
+        StreamCurve cold_curve(profile.cold_start, profile.segments[0].cold_end, profile.segments[0].cold_rate);
+        for (size_t k = 0; k < positions.size(); ++k) {
+            double x = std::max(static_cast<double>(profile.x_start), std::min(profile.xEnd(), positions[k]));
+            if (x < x0 || x > profile.segments[current].x_end) {
+                current = std::lower_bound(profile.segments.begin(), profile.segments.end(), x,
+                                           [](const Segment& segment, double value) { return segment.x_end < value; })
+                          - profile.segments.begin();
+                const Segment& segment = profile.segments[current];
+                x0 = current == 0 ? profile.x_start : profile.segments[current - 1].x_end;
+                double hot0 = current == 0 ? profile.hot_start : profile.segments[current - 1].hot_end;
+                double cold0 = current == 0 ? profile.cold_start : profile.segments[current - 1].cold_end;
+                hot_curve = StreamCurve(hot0, segment.hot_end, segment.hot_rate);
+                cold_curve = StreamCurve(cold0, segment.cold_end, segment.cold_rate);
+            }
+            double span = profile.segments[current].x_end - x0;
+            double s = span > 0.0 ? (x - x0) / span : 1.0;
+            hot[k] = hot_curve.value(s);
+            cold[k] = cold_curve.value(s);
+        }
+    }
+
+    bool ArchiveWriter::write(const void* data, size_t bytes) {
+        if (!failed && std::fwrite(data, 1, bytes, file) != bytes) {
+            failed = true;
+        }
+        offset += bytes;
+        return !failed;
+    }
+
+    ArchiveWriter::ArchiveWriter() : file(nullptr), offset(0), max_error(0.0), failed(false) {}
+
+    ArchiveWriter::~ArchiveWriter() {
+        close();
+    }
+
+    bool ArchiveWriter::open(const std::string& output_path) {
+        close();
+        file = std::fopen(output_path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Error: Could not open file " << output_path << " for writing\n";
+            return false;
+        }
+        path = output_path;
+        offset = 0;
+        max_error = 0.0;
+        failed = false;
+        offsets.clear();
+
+        // Placeholder header, rewritten by close()
+        Archive::FileHeader placeholder;
+        std::memset(&placeholder, 0, sizeof(placeholder));
+        return write(&placeholder, sizeof(placeholder));
+    }
+
+    bool ArchiveWriter::append(const EncodedProfile& profile) {
+        if (!file) {
+            return false;
+        }
+        RecordHeader record;
+        record.stations = profile.stations;
+        record.segment_count = static_cast<uint32_t>(profile.segments.size());
+        record.x_start = profile.x_start;
+        record.hot_start = profile.hot_start;
+        record.cold_start = profile.cold_start;
+        record.max_error = profile.max_error;
+        offsets.push_back(offset);
+        max_error = std::max(max_error, static_cast<double>(profile.max_error));
+        write(&record, sizeof(record));
+        return write(profile.segments.data(), profile.segments.size() * sizeof(Segment));
+    }
+
+    bool ArchiveWriter::close() {
+        if (!file) {
+            return !failed;
+        }
+        static const unsigned char padding[8] = {0};
+        write(padding, (8 - offset % 8) % 8);
+
+        Archive::FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = Archive::FORMAT_VERSION;
+        header.endian_marker = ENDIAN_MARKER;
+        header.profile_count = offsets.size();
+        header.index_offset = offset;
+        header.max_error = max_error;
+        write(offsets.data(), offsets.size() * sizeof(uint64_t));
+        header.file_size = offset;
+
+        if (!failed && (std::fseek(file, 0, SEEK_SET) != 0 ||
+                        std::fwrite(&header, 1, sizeof(header), file) != sizeof(header))) {
+            failed = true;
+        }
+        if (std::fclose(file) != 0) {
+            failed = true;
+        }
+        file = nullptr;
+        if (failed) {
+            std::cerr << "Error: Could not write profile archive " << path << "\n";
+        }
+        return !failed;
+    }
+
+    Archive::Archive() : header(nullptr), offsets(nullptr) {}
+
+    bool Archive::open(const std::string& path) {
+        close();
+        if (!file.open(path)) {
+            std::cerr << "Error: Could not open profile archive " << path << "\n";
+            return false;
+        }
+
+        const char* data = file.data();
+        size_t size = file.size();
+        const FileHeader* candidate = reinterpret_cast<const FileHeader*>(data);
+        if (size < sizeof(FileHeader) || std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) {
+            std::cerr << "Error: " << path << " is not a profile archive\n";
+            close();
+            return false;
+        }
+        if (candidate->endian_marker != ENDIAN_MARKER || candidate->version != FORMAT_VERSION) {
+            std::cerr << "Error: " << path << " has format version " << candidate->version
+                      << " or byte order unsupported by this build (expected version " << FORMAT_VERSION << ")\n";
+            close();
+            return false;
+        }
+        if (candidate->file_size != size || candidate->index_offset % 8 != 0 ||
+            candidate->index_offset + candidate->profile_count * sizeof(uint64_t) > size) {
+            std::cerr << "Error: " << path << " is truncated\n";
+            close();
+            return false;
+        }
+
+        // Bounds-check every record once so profile() can trust the index
+        const uint64_t* index = reinterpret_cast<const uint64_t*>(data + candidate->index_offset);
+        for (uint64_t i = 0; i < candidate->profile_count; ++i) {
+            bool valid = index[i] >= sizeof(FileHeader) && index[i] % 4 == 0 &&
+                         index[i] + sizeof(RecordHeader) <= candidate->index_offset;
+            if (valid) {
+                const RecordHeader* record = reinterpret_cast<const RecordHeader*>(data + index[i]);
+                valid = index[i] + sizeof(RecordHeader) + uint64_t(record->segment_count) * sizeof(Segment)
+                        <= candidate->index_offset;
+            }
+            if (!valid) {
+                std::cerr << "Error: " << path << " has a corrupt profile record " << i << "\n";
+                close();
+                return false;
+            }
+        }
+
+        header = candidate;
+        offsets = index;
+        return true;
+    }
+
+    void Archive::close() {
+        file.close();
+        header = nullptr;
+        offsets = nullptr;
+    }
+
+    long long Archive::profileCount() const {
+        return header ? static_cast<long long>(header->profile_count) : 0;
+    }
+
+    double Archive::maxError() const {
+        return header ? header->max_error : 0.0;
+    }
+
+    EncodedProfile Archive::profile(long long index) const {
+        if (index < 0 || index >= profileCount()) {
+            throw std::out_of_range("Profile index out of range");
+        }
+        const char* record_data = file.data() + offsets[index];
+        RecordHeader record;
+        std::memcpy(&record, record_data, sizeof(record));
+
+        EncodedProfile profile;
+        profile.stations = record.stations;
+        profile.x_start = record.x_start;
+        profile.hot_start = record.hot_start;
+        profile.cold_start = record.cold_start;
+        profile.max_error = record.max_error;
+        profile.segments.resize(record.segment_count);
+        std::memcpy(profile.segments.data(), record_data + sizeof(record), record.segment_count * sizeof(Segment));
+        return profile;
+    }
+
+} // namespace ProfileCodec
@@ -0,0 +1,181 @@
+#ifndef PROFILE_CODEC_H
+#define PROFILE_CODEC_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "numerical_solver.h"
+
+/**
+ * @file profile_codec.h
+ * @brief Compact piecewise-exponential encoding of temperature profiles
+ *
+ * Where U and both heat capacity rates are constant, each stream temperature
+ * is A + B exp(λx). A profile is therefore stored as a few segments. Each
+ * segment holds its end position, both end temperatures and one rate per
+ * stream, instead of one row per station. Between a segment's ends
+ *   T(x) = T0 + (T1 - T0) expm1(z s) / expm1(z),    s = (x - x0) / (x1 - x0)
+ * with z = λ (x1 - x0). This is linear when z = 0 and continuous across
+ * segments. The encoder grows each segment greedily while every station it
+ * covers reconstructs within the tolerance. A profile from the
+ * constant-coefficient solvers is one segment. Multi-pass and property-varying
+ * profiles need more.
+ *
+ * Parameters are stored in single precision. The reported error is measured
+ * at every encoded station, after rounding, so it is the true worst case over
+ * the original data. It exceeds the tolerance only if the tolerance is below
+ * single-precision resolution (about 3e-5 K at 400 K).
+ */
+
+namespace ProfileCodec {
+
+    struct Segment {
+        float x_end;                // m
+        float hot_end;              // K
+        float cold_end;             // K
+        float hot_rate;             // z = λ (x_end - x_start), dimensionless
+        float cold_rate;
+    };
+
+    struct EncodedProfile {
+        uint32_t stations;          // Stations encoded
+        float x_start;              // m
+        float hot_start;            // K
+        float cold_start;           // K
+        float max_error;            // K, worst reconstruction error at the encoded stations
+        std::vector<Segment> segments;
+
+        double xEnd() const { return segments.empty() ? x_start : segments.back().x_end; }
+
+        /**
+         * Reconstruct both temperatures at a position (clamped to the profile's range)
+         * @param x Position (m)
+         * @param hot Hot temperature (K)
+         * @param cold Cold temperature (K)
+         */
+        void evaluate(double x, double& hot, double& cold) const;
+
+        /** @return Bytes taken by this profile in an archive */
+        size_t encodedBytes() const;
+    };
+
+    /**
+     * Encode a sampled profile
+     * @param positions Station positions (m), strictly increasing
+     * @param hot Hot temperatures (K) at the stations
+     * @param cold Cold temperatures (K) at the stations
+     * @param tolerance Largest reconstruction error allowed at a station (K)
+     * @return Segments and achieved worst-case error
+     */
+    EncodedProfile encode(const std::vector<double>& positions, const std::vector<double>& hot,
+                          const std::vector<double>& cold, double tolerance = 1e-3);
+
+    /**
+     * Encode the profile of a NumericalSolver solution
+     */
+    EncodedProfile encode(const NumericalSolver::SolutionResults& results, double tolerance = 1e-3);
+
+    /**
+     * Reconstruct temperatures at any set of positions
+     * @param profile Encoded profile
+     * @param positions Positions (m); ascending order is fastest
+     * @param hot Receives hot temperatures (K)
+     * @param cold Receives cold temperatures (K)
+     */
+    void decode(const EncodedProfile& profile, const std::vector<double>& positions,
+                std::vector<double>& hot, std::vector<double>& cold);
+
+    /**
+     * Memory-mapped file of encoded profiles with random access by index
+     *
+     * Binary layout (native byte order, checked by an endian marker):
+     *   FileHeader | records (4-byte aligned) | uint64 offset[profile_count]
+     * A record is stations, segment count, x_start, hot_start, cold_start,
+     * max_error, then its segments.
+     */
+    class Archive {
+    public:
+        static const uint32_t FORMAT_VERSION = 1;
+
+        Archive();
+
+        /**
+         * Map an archive
+         * @param path Archive written by ArchiveWriter
+         * @return false if the file is missing, truncated or has another format version
+         */
+        bool open(const std::string& path);
+        void close();
+
+        long long profileCount() const;
+        double maxError() const;                // K, worst error over all profiles
+        size_t fileBytes() const { return file.size(); }
+
+        /**
+         * Decode one profile
+         * @param index Profile index (as appended)
+         */
+        EncodedProfile profile(long long index) const;
+
+    private:
+        friend class ArchiveWriter;
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t endian_marker;
+            uint64_t profile_count;
+            uint64_t index_offset;
+            uint64_t file_size;
+            double max_error;
+        };
+
+        MappedFile file;
+        const FileHeader* header;
+        const uint64_t* offsets;
+    };
+
+    /**
+     * Appends encoded profiles to an archive (memory bounded by the offset index)
+     */
+    class ArchiveWriter {
+    public:
+        ArchiveWriter();
+        ~ArchiveWriter();
+
+        ArchiveWriter(const ArchiveWriter&) = delete;
+        ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+        /**
+         * Create an archive
+         * @param path Output file
+         * @return false if the file cannot be created
+         */
+        bool open(const std::string& path);
+
+        bool append(const EncodedProfile& profile);
+
+        /**
+         * Write the offset index and the header
+         * @return false if any write failed
+         */
+        bool close();
+
+        long long profilesWritten() const { return static_cast<long long>(offsets.size()); }
+
+    private:
+        std::FILE* file;
+        std::string path;
+        uint64_t offset;
+        double max_error;
+        bool failed;
+        std::vector<uint64_t> offsets;
+
+        bool write(const void* data, size_t bytes);
+    };
+
+} // namespace ProfileCodec
+
+#endif // PROFILE_CODEC_H
@@ -0,0 +1,150 @@
+#include "profile_stream.h"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace ProfileStream {
+
+    namespace {
+        constexpr size_t FILE_BUFFER_BYTES = 1 << 20;
+
+        // Sign, the 309 integer digits of DBL_MAX and the decimal point
+        constexpr size_t MAX_FIXED_BYTES = std::numeric_limits<double>::max_exponent10 + 3;
+
+        int checkedPrecision(int precision) {
+            if (precision < 0 || precision > FileSink::MAX_PRECISION) {
+                throw std::invalid_argument("CSV precision must be between 0 and " +
+                                            std::to_string(FileSink::MAX_PRECISION) + " digits");
+            }
+            return precision;
+        }
+
+        // nullptr if the value and its separator do not fit
+        char* appendFixed(char* out, char* end, double value, int precision) {
+            std::to_chars_result result = std::to_chars(out, end, value, std::chars_format::fixed, precision);
+            return result.ec == std::errc() && result.ptr < end ? result.ptr : nullptr;
+        }
+    }
+
+    FileSink::FileSink(const std::string& filename, int precision)
+        : precision(checkedPrecision(precision)), row_bytes(5 * (MAX_FIXED_BYTES + precision + 1)),
+          file(std::fopen(filename.c_str(), "wb")), failed(false), buffer(FILE_BUFFER_BYTES), used(0) {
+        if (!file) {
+            std::cerr << "Error: Could not open file " << filename << " for writing\n";
+            return;
+        }
+        static const char header[] = "Position_m,Hot_Temp_K,Hot_Temp_C,Cold_Temp_K,Cold_Temp_C\n";
+        std::copy(header, header + sizeof(header) - 1, buffer.data());
+        used = sizeof(header) - 1;
+    }
+
+    FileSink::~FileSink() {
+        close();
+    }
+
+    bool FileSink::flushBuffer() {
+        if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+            failed = true;
+        }
+        used = 0;
+        return !failed;
+    }
+
+    bool FileSink::operator()(const ProfileChunk& chunk) {
+        if (!file || failed) {
+            return false;
+        }
+        char* end = buffer.data() + buffer.size();
+        for (int k = 0; k < chunk.count; ++k) {
+            if (buffer.size() - used < row_bytes && !flushBuffer()) {
+                return false;
+            }
+            const double values[5] = {chunk.position(k), chunk.hot[k], chunk.hot[k] - 273.15,
+                                      chunk.cold[k], chunk.cold[k] - 273.15};
+            char* out = buffer.data() + used;
+            for (int v = 0; v < 5; ++v) {
+                out = appendFixed(out, end, values[v], precision);
+                if (!out) {
+                    failed = true;
+                    return false;
+                }
+                *out++ = v < 4 ? ',' : '\n';
+            }
+            used = static_cast<size_t>(out - buffer.data());
+        }
+        return true;
+    }
+
+    bool FileSink::close() {
+        if (file) {
+            flushBuffer();
+            if (std::fclose(file) != 0) {
+                failed = true;
+            }
+            file = nullptr;
+        }
+        return !failed;
+    }
+
+    Sink FileSink::sink() {
+        return [this](const ProfileChunk& chunk) { return (*this)(chunk); };
+    }
+
+    Decimator::Decimator(long long stride, Sink downstream, int chunk_stations)
+        : stride(stride), downstream(std::move(downstream)), capacity(chunk_stations), forwarded(0) {
+        if (stride < 1 || chunk_stations < 1) {
+            throw std::invalid_argument("Decimation stride and chunk size must be at least 1");
+        }
+        hot.reserve(capacity);
+        cold.reserve(capacity);
+        positions.reserve(capacity);
+    }
+
+    bool Decimator::forward(bool last) {
+        ProfileChunk out{forwarded, static_cast<int>(hot.size()), 0.0,
+                         hot.data(), cold.data(), positions.data(), last};
+        forwarded += out.count;
+        bool keep_going = downstream(out);
+        hot.clear();
+        cold.clear();
+        positions.clear();
+        return keep_going;
+    }
+
+    bool Decimator::operator()(const ProfileChunk& chunk) {
+        long long first = chunk.first_station;
+        long long k = (stride - first % stride) % stride;   // First multiple of the stride in this chunk
+        bool final_kept = false;
+        for (; k < chunk.count; k += stride) {
+            hot.push_back(chunk.hot[k]);
+            cold.push_back(chunk.cold[k]);
+            positions.push_back(chunk.position(static_cast<int>(k)));
+            final_kept = (k == chunk.count - 1);
+            if (static_cast<int>(hot.size()) == capacity && !(chunk.last && final_kept)) {
+                if (!forward(false)) {
+                    return false;
+                }
+            }
+        }
+        if (!chunk.last) {
+            return true;
+        }
+        if (!final_kept && chunk.count > 0) {
+            if (static_cast<int>(hot.size()) == capacity && !forward(false)) {
+                return false;
+            }
+            int k_last = chunk.count - 1;
+            hot.push_back(chunk.hot[k_last]);
+            cold.push_back(chunk.cold[k_last]);
+            positions.push_back(chunk.position(k_last));
+        }
+        return forward(true);
+    }
+
+    Sink Decimator::sink() {
+        return [this](const ProfileChunk& chunk) { return (*this)(chunk); };
+    }
+
+} // namespace ProfileStream
@@ -0,0 +1,118 @@
+#ifndef PROFILE_STREAM_H
+#define PROFILE_STREAM_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file profile_stream.h
+ * @brief Chunked delivery of temperature profiles (see NumericalSolver::solveTemperatureDistributionStreaming)
+ *
+ * A streaming solve hands the profile to a sink as consecutive chunks of
+ * stations. Within a chunk, hot[k] and cold[k] belong to the same station,
+ * the pairing used by writeResultsToFile(). The solver does not store
+ * positions; they are computed from the station index. Chunk arrays are
+ * only valid during the call.
+ */
+
+namespace ProfileStream {
+
+    struct ProfileChunk {
+        long long first_station;    // Index of hot[0] / cold[0] in the delivered sequence
+        int count;                  // Stations in this chunk
+        double dx;                  // Segment length (m)
+        const double* hot;          // Hot temperatures (K)
+        const double* cold;         // Cold temperatures (K) at the same stations
+        const double* positions;    // Explicit positions (m), or null for (first_station + k) * dx
+        bool last;                  // true for the chunk holding the final station
+
+        double position(int k) const {
+            return positions ? positions[k] : static_cast<double>(first_station + k) * dx;
+        }
+    };
+
+    /**
+     * Receives chunks in station order
+     * @return false to stop the solve early
+     */
+    using Sink = std::function<bool(const ProfileChunk&)>;
+
+    /**
+     * Writes chunks as CSV in the format of writeResultsToFile()
+     * (position, hot and cold temperatures in K and °C) through one
+     * fixed-size buffer
+     */
+    class FileSink {
+    public:
+        /** Largest precision the constructor accepts */
+        static const int MAX_PRECISION = 64;
+
+        /**
+         * @param filename Output CSV
+         * @param precision Digits after the decimal point (writeResultsToFile uses 4);
+         *                  throws std::invalid_argument outside 0 to MAX_PRECISION
+         */
+        explicit FileSink(const std::string& filename, int precision = 4);
+        ~FileSink();
+
+        FileSink(const FileSink&) = delete;
+        FileSink& operator=(const FileSink&) = delete;
+
+        bool isOpen() const { return file != nullptr; }
+
+        /** @return false if the file is not open or a write failed */
+        bool operator()(const ProfileChunk& chunk);
+
+        /**
+         * Flush and close the file
+         * @return false if any write failed
+         */
+        bool close();
+
+        /** @return Sink forwarding to this object (which must outlive the solve) */
+        Sink sink();
+
+    private:
+        int precision;
+        size_t row_bytes;               // Longest possible row, including DBL_MAX in fixed format
+        std::FILE* file;
+        bool failed;
+        std::vector<char> buffer;
+        size_t used;
+
+        bool flushBuffer();
+    };
+
+    /**
+     * Forwards every stride-th station, and always the final one, to another
+     * sink in chunks of at most the given size
+     */
+    class Decimator {
+    public:
+        /**
+         * @param stride Keep stations whose index is a multiple of stride
+         * @param downstream Receiver of the kept stations
+         * @param chunk_stations Largest chunk forwarded downstream
+         */
+        Decimator(long long stride, Sink downstream, int chunk_stations = 4096);
+
+        bool operator()(const ProfileChunk& chunk);
+
+        /** @return Sink forwarding to this object (which must outlive the solve) */
+        Sink sink();
+
+    private:
+        long long stride;
+        Sink downstream;
+        int capacity;
+        std::vector<double> hot, cold, positions;
+        long long forwarded;        // Stations already sent downstream
+
+        bool forward(bool last);
+    };
+
+} // namespace ProfileStream
+
+#endif // PROFILE_STREAM_H
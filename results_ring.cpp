@@ -0,0 +1,382 @@
+#include "results_ring.h"
+#include "thermal_calculations.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ResultsRing {
+
+    namespace {
+        const char RING_MAGIC[8] = {'T', 'C', 'R', 'I', 'N', 'G', '0', '1'};
+        const std::uint32_t FORMAT_VERSION = 1;
+        const std::uint32_t ENDIAN_MARKER = 0x01020304;
+        const std::size_t ALIGNMENT = 64;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                      "The results ring needs lock-free 64-bit atomics in shared memory");
+        static_assert(std::is_trivially_copyable<Summary>::value,
+                      "Summaries are copied into shared memory byte for byte");
+
+        // Ring: RingHeader | slot[slot_count], each slot SlotHeader | Summary | positions | hot | cold
+        struct RingHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t endian_marker;
+            std::uint32_t slot_count;
+            std::uint32_t max_stations;
+            std::uint64_t slot_bytes;
+            std::uint64_t total_bytes;
+            alignas(ALIGNMENT) std::atomic<std::uint64_t> published;    // Completed publications
+            std::atomic<std::uint32_t> closed;                          // Set when the publisher goes away
+        };
+
+        // The counter has its own cache line so polling readers do not share it with data
+        struct alignas(ALIGNMENT) SlotHeader {
+            std::atomic<std::uint64_t> sequence;    // 2 (n + 1) when publication n is complete, odd while writing
+        };
+
+        size_t alignUp(size_t value) {
+            return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        size_t slotBytes(int max_stations) {
+            return alignUp(sizeof(SlotHeader) + sizeof(Summary) + 3 * sizeof(double) * static_cast<size_t>(max_stations));
+        }
+
+        std::string sharedName(const std::string& name) {
+            return (!name.empty() && name[0] == '/') ? name : "/" + name;
+        }
+
+        const RingHeader* ringHeader(const void* address) {
+            return static_cast<const RingHeader*>(address);
+        }
+
+        const char* slotAddress(const void* address, std::uint64_t publication) {
+            const RingHeader* header = ringHeader(address);
+            return static_cast<const char*>(address) + alignUp(sizeof(RingHeader)) +
+                   (publication % header->slot_count) * header->slot_bytes;
+        }
+
+        const SlotHeader* slotHeader(const char* slot) {
+            return reinterpret_cast<const SlotHeader*>(slot);
+        }
+
+        const Summary* slotSummary(const char* slot) {
+            return reinterpret_cast<const Summary*>(slot + sizeof(SlotHeader));
+        }
+
+        const double* slotProfile(const char* slot, std::uint32_t max_stations, int array) {
+            return reinterpret_cast<const double*>(slot + sizeof(SlotHeader) + sizeof(Summary)) +
+                   static_cast<size_t>(array) * max_stations;
+        }
+    }
+
+    Publisher::Publisher() : address(nullptr), bytes(0) {}
+
+    Publisher::~Publisher() {
+        close();
+    }
+
+    Subscriber::Subscriber() : address(nullptr), bytes(0) {}
+
+    Subscriber::~Subscriber() {
+        detach();
+    }
+
+    std::uint64_t Publisher::publish(const NumericalSolver::SolutionResults& results,
+                                     const FluidProperties& hot, const FluidProperties& cold) {
+        size_t stations = results.positions.size();
+        if (results.hot_temperatures.size() != stations || results.cold_temperatures.size() != stations) {
+            throw std::invalid_argument("Profile positions and temperatures must have the same length");
+        }
+        Summary summary;
+        std::memset(&summary, 0, sizeof(summary));
+        summary.hot_inlet = hot.inlet_temp;
+        summary.cold_inlet = cold.inlet_temp;
+        summary.hot_outlet = stations ? results.hot_temperatures[stations - 1] : hot.inlet_temp;
+        summary.cold_outlet = stations ? results.cold_temperatures[0] : cold.inlet_temp;
+        summary.duty = ThermalCalculations::heatCapacityRate(hot.mass_flow, hot.specific_heat) * (summary.hot_inlet - summary.hot_outlet);
+        summary.overall_htc = results.overall_htc;
+        summary.hot_reynolds = results.hot_reynolds;
+        summary.cold_reynolds = results.cold_reynolds;
+        summary.hot_nusselt = results.hot_nusselt;
+        summary.cold_nusselt = results.cold_nusselt;
+        summary.hot_htc = results.hot_htc;
+        summary.cold_htc = results.cold_htc;
+
+        // Counter-current pairing of writeResultsToFile()
+        reordered.assign(results.cold_temperatures.rbegin(), results.cold_temperatures.rend());
+        return publish(summary, results.positions.data(), results.hot_temperatures.data(), reordered.data(), stations);
+    }
+
+#if !defined(_WIN32)
+
+    bool Publisher::create(const std::string& ring_name, int slot_count, int max_stations) {
+        if (slot_count < 2) {
+            throw std::invalid_argument("A results ring needs at least two slots");
+        }
+        if (max_stations < 1) {
+            throw std::invalid_argument("Ring slots must hold at least one station");
+        }
+        close();
+        std::string shm_name = sharedName(ring_name);
+
+        // Tell readers of an earlier ring of this name to re-attach
+        int old_fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+        if (old_fd >= 0) {
+            struct stat info;
+            if (fstat(old_fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(RingHeader)) {
+                void* old = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, old_fd, 0);
+                if (old != MAP_FAILED) {
+                    RingHeader* header = static_cast<RingHeader*>(old);
+                    if (std::memcmp(header->magic, RING_MAGIC, sizeof(RING_MAGIC)) == 0) {
+                        header->closed.store(1, std::memory_order_release);
+                    }
+                    munmap(old, static_cast<size_t>(info.st_size));
+                }
+            }
+            ::close(old_fd);
+            shm_unlink(shm_name.c_str());
+        }
+
+        size_t total = alignUp(sizeof(RingHeader)) + static_cast<size_t>(slot_count) * slotBytes(max_stations);
+        int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(total)) != 0) {
+            std::cerr << "Error: Could not create results ring " << shm_name << "\n";
+            if (fd >= 0) {
+                ::close(fd);
+                shm_unlink(shm_name.c_str());
+            }
+            return false;
+        }
+        void* mapped = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error: Could not map results ring " << shm_name << "\n";
+            shm_unlink(shm_name.c_str());
+            return false;
+        }
+
+        // The new object is zero-filled by ftruncate; counters start at 0
+        RingHeader* header = new (mapped) RingHeader();
+        header->version = FORMAT_VERSION;
+        header->endian_marker = ENDIAN_MARKER;
+        header->slot_count = static_cast<std::uint32_t>(slot_count);
+        header->max_stations = static_cast<std::uint32_t>(max_stations);
+        header->slot_bytes = slotBytes(max_stations);
+        header->total_bytes = total;
+        header->published.store(0, std::memory_order_relaxed);
+        header->closed.store(0, std::memory_order_relaxed);
+        for (int s = 0; s < slot_count; ++s) {
+            new (const_cast<char*>(slotAddress(mapped, static_cast<std::uint64_t>(s)))) SlotHeader{{0}};
+        }
+        // Readers check the magic last
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, RING_MAGIC, sizeof(RING_MAGIC));
+
+        name = shm_name;
+        address = mapped;
+        bytes = total;
+        return true;
+    }
+
+    void Publisher::close() {
+        if (!address) {
+            return;
+        }
+        static_cast<RingHeader*>(address)->closed.store(1, std::memory_order_release);
+        munmap(address, bytes);
+        shm_unlink(name.c_str());
+        address = nullptr;
+        bytes = 0;
+    }
+
+    bool Subscriber::attach(const std::string& ring_name) {
+        detach();
+        std::string shm_name = sharedName(ring_name);
+        int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            std::cerr << "Error: Could not attach to results ring " << shm_name << "\n";
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(RingHeader)) {
+            std::cerr << "Error: " << shm_name << " is not a results ring\n";
+            ::close(fd);
+            return false;
+        }
+        size_t total = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error: Could not map results ring " << shm_name << "\n";
+            return false;
+        }
+        const RingHeader* header = ringHeader(mapped);
+        if (std::memcmp(header->magic, RING_MAGIC, sizeof(RING_MAGIC)) != 0 || header->total_bytes != total ||
+            header->version != FORMAT_VERSION || header->endian_marker != ENDIAN_MARKER ||
+            header->slot_count < 2 || header->slot_bytes != slotBytes(static_cast<int>(header->max_stations)) ||
+            alignUp(sizeof(RingHeader)) + header->slot_count * header->slot_bytes != total) {
+            std::cerr << "Error: " << shm_name << " is not a results ring of format version " << FORMAT_VERSION << "\n";
+            munmap(mapped, total);
+            return false;
+        }
+        address = mapped;
+        bytes = total;
+        return true;
+    }
+
+    void Subscriber::detach() {
+        if (address) {
+            munmap(const_cast<void*>(address), bytes);
+        }
+        address = nullptr;
+        bytes = 0;
+    }
+
+#else
+
+    bool Publisher::create(const std::string& ring_name, int slot_count, int max_stations) {
+        if (slot_count < 2) {
+            throw std::invalid_argument("A results ring needs at least two slots");
+        }
+        if (max_stations < 1) {
+            throw std::invalid_argument("Ring slots must hold at least one station");
+        }
+        std::cerr << "Error: Results ring " << ring_name << " needs POSIX shared memory\n";
+        return false;
+    }
+
+    void Publisher::close() {}
+
+    bool Subscriber::attach(const std::string& ring_name) {
+        std::cerr << "Error: Results ring " << ring_name << " needs POSIX shared memory\n";
+        return false;
+    }
+
+    void Subscriber::detach() {}
+
+#endif
+
+    std::uint64_t Publisher::publish(const Summary& summary, const double* positions, const double* hot,
+                                     const double* cold, std::size_t stations) {
+        if (!address) {
+            throw std::logic_error("Results ring is not open");
+        }
+        RingHeader* header = static_cast<RingHeader*>(address);
+        if (stations > header->max_stations) {
+            throw std::invalid_argument("Profile has more stations than the ring's slots hold");
+        }
+        std::uint64_t publication = header->published.load(std::memory_order_relaxed);
+        char* slot = const_cast<char*>(slotAddress(address, publication));
+        std::atomic<std::uint64_t>& sequence = reinterpret_cast<SlotHeader*>(slot)->sequence;
+
+        // Odd while writing; the fence keeps the data stores after it
+        sequence.store(2 * publication + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Summary stamped = summary;
+        stamped.publication = publication;
+        stamped.timestamp = std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        stamped.stations = static_cast<std::uint32_t>(stations);
+        std::memcpy(slot + sizeof(SlotHeader), &stamped, sizeof(stamped));
+        double* arrays = reinterpret_cast<double*>(slot + sizeof(SlotHeader) + sizeof(Summary));
+        std::memcpy(arrays, positions, stations * sizeof(double));
+        std::memcpy(arrays + header->max_stations, hot, stations * sizeof(double));
+        std::memcpy(arrays + 2 * static_cast<size_t>(header->max_stations), cold, stations * sizeof(double));
+
+        sequence.store(2 * publication + 2, std::memory_order_release);
+        header->published.store(publication + 1, std::memory_order_release);
+        return publication;
+    }
+
+    std::uint64_t Publisher::published() const {
+        return address ? ringHeader(address)->published.load(std::memory_order_acquire) : 0;
+    }
+
+    std::uint64_t Subscriber::published() const {
+        return address ? ringHeader(address)->published.load(std::memory_order_acquire) : 0;
+    }
+
+    bool Subscriber::publisherClosed() const {
+        return !address || ringHeader(address)->closed.load(std::memory_order_acquire) != 0;
+    }
+
+    int Subscriber::slotCount() const {
+        return address ? static_cast<int>(ringHeader(address)->slot_count) : 0;
+    }
+
+    int Subscriber::maxStations() const {
+        return address ? static_cast<int>(ringHeader(address)->max_stations) : 0;
+    }
+
+    bool Subscriber::beginRead(std::uint64_t publication, View& view) const {
+        if (!address) {
+            return false;
+        }
+        const RingHeader* header = ringHeader(address);
+        const char* slot = slotAddress(address, publication);
+        std::uint64_t sequence = slotHeader(slot)->sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * publication + 2) {
+            return false;
+        }
+        const Summary* summary = slotSummary(slot);
+        view.publication = publication;
+        view.summary = summary;
+        view.positions = slotProfile(slot, header->max_stations, 0);
+        view.hot = slotProfile(slot, header->max_stations, 1);
+        view.cold = slotProfile(slot, header->max_stations, 2);
+        view.stations = std::min(summary->stations, header->max_stations);
+        view.sequence = sequence;
+        return true;
+    }
+
+    bool Subscriber::latest(View& view) const {
+        std::uint64_t count = published();
+        return count > 0 && beginRead(count - 1, view);
+    }
+
+    bool Subscriber::validate(const View& view) const {
+        if (!address) {
+            return false;
+        }
+        // Loads made through the view complete before the counter is re-read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slotHeader(slotAddress(address, view.publication))->sequence.load(std::memory_order_relaxed) == view.sequence;
+    }
+
+    bool Subscriber::copyLatest(Snapshot& snapshot, int max_attempts) const {
+        for (int attempt = 0; attempt < max_attempts; ++attempt) {
+            View view;
+            if (!latest(view)) {
+                if (published() == 0) {
+                    return false;
+                }
+                continue;           // The latest slot is already being rewritten
+            }
+            std::memcpy(&snapshot.summary, view.summary, sizeof(Summary));
+            snapshot.positions.assign(view.positions, view.positions + view.stations);
+            snapshot.hot.assign(view.hot, view.hot + view.stations);
+            snapshot.cold.assign(view.cold, view.cold + view.stations);
+            if (validate(view)) {
+                snapshot.summary.stations = view.stations;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace ResultsRing
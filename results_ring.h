@@ -0,0 +1,190 @@
+#ifndef RESULTS_RING_H
+#define RESULTS_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fluid_properties.h"
+#include "numerical_solver.h"
+
+/**
+ * @file results_ring.h
+ * @brief Live solve results in a POSIX shared-memory ring for local reader processes
+ *
+ * One publisher process writes each solve result (summary scalars and
+ * temperature profile) into the next slot of a fixed ring. Any number of
+ * reader processes map the ring read-only. They read slots in place, without
+ * copying and without locks. Each slot is guarded by a sequence counter
+ * (seqlock). The publisher makes it odd while it writes the slot and sets it
+ * to 2 (n + 1) once publication n is complete. A reader notes the counter,
+ * reads, and checks that the counter has not changed. If it has, the slot was
+ * rewritten underneath it, and the read is retried or the next publication is
+ * taken. A reader never blocks the publisher. A reader that falls more than
+ * slot_count publications behind loses the overwritten ones, but never gets
+ * a mix of two.
+ *
+ * Profiles are stored in the station order and hot/cold pairing of
+ * NumericalSolver::writeResultsToFile(), so the ring can replace the
+ * temperature_profile.csv and heat_transfer_summary.txt files.
+ */
+
+namespace ResultsRing {
+
+    struct Summary {
+        std::uint64_t publication;      // 0, 1, 2, ... in publish order
+        double timestamp;               // s since the epoch (system clock) at publish
+        double hot_inlet;               // K
+        double hot_outlet;
+        double cold_inlet;
+        double cold_outlet;
+        double duty;                    // W, hot side
+        double overall_htc;             // W/m²·K
+        double hot_reynolds;
+        double cold_reynolds;
+        double hot_nusselt;
+        double cold_nusselt;
+        double hot_htc;                 // W/m²·K
+        double cold_htc;
+        std::uint32_t stations;         // Profile length
+        std::uint32_t reserved;
+    };
+
+    /**
+     * A slot read in place. The pointers refer to shared memory, which the
+     * publisher may overwrite at any time; values read through them are only
+     * valid if Subscriber::validate() returns true afterwards.
+     */
+    struct View {
+        std::uint64_t publication;
+        const Summary* summary;
+        const double* positions;        // m
+        const double* hot;              // K
+        const double* cold;             // K, paired with hot as in writeResultsToFile()
+        std::uint32_t stations;
+        std::uint64_t sequence;         // Slot counter seen by the read
+    };
+
+    struct Snapshot {
+        Summary summary;
+        std::vector<double> positions;
+        std::vector<double> hot;
+        std::vector<double> cold;
+    };
+
+    /**
+     * Creates the ring and publishes results into it (single producer)
+     */
+    class Publisher {
+    public:
+        Publisher();
+        ~Publisher();
+
+        Publisher(const Publisher&) = delete;
+        Publisher& operator=(const Publisher&) = delete;
+
+        /**
+         * Create the shared-memory ring, replacing any ring of the same name.
+         * Readers of a replaced ring see Subscriber::publisherClosed().
+         * @param name Shared-memory name ("/thermocore-live"; a leading '/' is added if missing)
+         * @param slot_count Publications kept (at least 2)
+         * @param max_stations Largest profile a slot holds
+         * @return false if the ring cannot be created
+         */
+        bool create(const std::string& name, int slot_count = 8, int max_stations = 4096);
+
+        /** Mark the ring closed for readers and remove its name */
+        void close();
+
+        /**
+         * Publish a NumericalSolver result
+         * @param results Solution with profile
+         * @param hot Hot stream (inlet temperature and capacity rate for the duty)
+         * @param cold Cold stream
+         * @return Publication number
+         */
+        std::uint64_t publish(const NumericalSolver::SolutionResults& results,
+                              const FluidProperties& hot, const FluidProperties& cold);
+
+        /**
+         * Publish a summary and a profile of any solver
+         * @param summary Scalars; publication, timestamp and stations are filled in
+         * @param positions Station positions (m)
+         * @param hot Hot temperatures (K)
+         * @param cold Cold temperatures (K)
+         * @param stations Profile length (at most max_stations)
+         * @return Publication number
+         */
+        std::uint64_t publish(const Summary& summary, const double* positions, const double* hot,
+                              const double* cold, std::size_t stations);
+
+        std::uint64_t published() const;
+        bool isOpen() const { return address != nullptr; }
+
+    private:
+        std::string name;
+        void* address;
+        std::size_t bytes;
+        std::vector<double> reordered;        // Cold profile in file pairing
+    };
+
+    /**
+     * Maps a ring read-only and reads its slots in place
+     */
+    class Subscriber {
+    public:
+        Subscriber();
+        ~Subscriber();
+
+        Subscriber(const Subscriber&) = delete;
+        Subscriber& operator=(const Subscriber&) = delete;
+
+        /**
+         * Attach to a ring
+         * @param name Name given to Publisher::create()
+         * @return false if no ring of that name exists
+         */
+        bool attach(const std::string& name);
+        void detach();
+
+        /** @return Publications so far (the latest is published() - 1) */
+        std::uint64_t published() const;
+
+        /** @return true once the publisher has closed or replaced this ring */
+        bool publisherClosed() const;
+
+        int slotCount() const;
+        int maxStations() const;
+
+        /**
+         * Start reading a publication in place
+         * @param publication Publication number
+         * @param view Receives pointers into the slot
+         * @return false if the publication is not yet written, is being written or was overwritten
+         */
+        bool beginRead(std::uint64_t publication, View& view) const;
+
+        /** beginRead() of the latest publication */
+        bool latest(View& view) const;
+
+        /**
+         * @return true if nothing read through the view since beginRead() was torn
+         */
+        bool validate(const View& view) const;
+
+        /**
+         * Copy the latest publication, retrying torn reads
+         * @param snapshot Receives the summary and profile
+         * @param max_attempts Reads tried before giving up
+         * @return false if nothing is published or every attempt was torn
+         */
+        bool copyLatest(Snapshot& snapshot, int max_attempts = 64) const;
+
+    private:
+        const void* address;
+        std::size_t bytes;
+    };
+
+} // namespace ResultsRing
+
+#endif // RESULTS_RING_H
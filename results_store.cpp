@@ -0,0 +1,727 @@
+#include "results_store.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+    const char MAGIC[8] = {'T', 'C', 'R', 'S', 'T', 'O', 'R', '\0'};
+    const uint32_t ENDIAN_MARKER = 0x01020304;
+    const size_t ALIGNMENT = 8;
+    const int MAX_ROWS_PER_BLOCK = 1 << 24;
+
+    enum Encoding : uint32_t {
+        ENCODING_CONSTANT = 0,
+        ENCODING_DICTIONARY = 1,
+        ENCODING_XOR = 2,
+        ENCODING_RAW = 3
+    };
+    const uint32_t ENCODING_MASK = 0xff;
+    const uint32_t CONTAINS_NAN = 0x100;     // Flag on ChunkEntry::encoding
+
+    size_t alignUp(size_t value) {
+        return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    uint64_t toBits(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double fromBits(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    int leadingZeroBytes(uint64_t x) {
+        int bytes = 0;
+        while (bytes < 8 && (x >> (56 - 8 * bytes)) == 0) {
+            ++bytes;
+        }
+        return bytes;
+    }
+
+    int trailingZeroBytes(uint64_t x) {
+        int bytes = 0;
+        while (bytes < 8 && ((x >> (8 * bytes)) & 0xffU) == 0) {
+            ++bytes;
+        }
+        return bytes;
+    }
+
+    /**
+     * Distinct values of a chunk, up to 256 (open addressing on the bit patterns)
+     * @return false if there are more than 256
+     */
+    bool collectDictionary(const double* values, int rows, std::vector<uint64_t>& dictionary,
+                           std::vector<unsigned char>& indices) {
+        const int SLOTS = 1024;
+        uint64_t keys[SLOTS];
+        int codes[SLOTS];
+        std::fill(codes, codes + SLOTS, -1);
+        dictionary.clear();
+        indices.resize(rows);
+        for (int r = 0; r < rows; ++r) {
+            uint64_t bits = toBits(values[r]);
+            uint64_t slot = (bits * 0x9e3779b97f4a7c15ULL) >> 54;
+            while (codes[slot] >= 0 && keys[slot] != bits) {
+                slot = (slot + 1) & (SLOTS - 1);
+            }
+            if (codes[slot] < 0) {
+                if (dictionary.size() == 256) {
+                    return false;
+                }
+                keys[slot] = bits;
+                codes[slot] = static_cast<int>(dictionary.size());
+                dictionary.push_back(bits);
+            }
+            indices[r] = static_cast<unsigned char>(codes[slot]);
+        }
+        return true;
+    }
+
+    /**
+     * Encode one block column with the smallest of the four encodings
+     * @param values Column values of the block
+     * @param rows Number of rows
+     * @param out Encoded chunk
+     * @return Encoding used
+     */
+    uint32_t encodeChunk(const double* values, int rows, std::vector<unsigned char>& out) {
+        bool constant = true;
+        uint64_t first = toBits(values[0]);
+        for (int r = 1; r < rows && constant; ++r) {
+            constant = toBits(values[r]) == first;
+        }
+        if (constant) {
+            out.resize(8);
+            std::memcpy(out.data(), &first, 8);
+            return ENCODING_CONSTANT;
+        }
+
+        size_t raw_bytes = static_cast<size_t>(rows) * 8;
+        size_t xor_bytes = static_cast<size_t>(rows);
+        uint64_t previous = 0;
+        for (int r = 0; r < rows; ++r) {
+            uint64_t x = toBits(values[r]) ^ previous;
+            previous ^= x;
+            if (x != 0) {
+                xor_bytes += 8 - leadingZeroBytes(x) - trailingZeroBytes(x);
+            }
+        }
+        xor_bytes += 8;     // Slack so the decoder can always load eight bytes
+
+        std::vector<uint64_t> dictionary;
+        std::vector<unsigned char> indices;
+        if (collectDictionary(values, rows, dictionary, indices)) {
+            size_t dictionary_bytes = 8 + dictionary.size() * 8 + static_cast<size_t>(rows);
+            if (dictionary_bytes <= xor_bytes && dictionary_bytes <= raw_bytes) {
+                out.resize(dictionary_bytes);
+                uint32_t header[2] = {static_cast<uint32_t>(dictionary.size()), 0};
+                std::memcpy(out.data(), header, 8);
+                std::memcpy(out.data() + 8, dictionary.data(), dictionary.size() * 8);
+                std::memcpy(out.data() + 8 + dictionary.size() * 8, indices.data(), rows);
+                return ENCODING_DICTIONARY;
+            }
+        }
+
+        if (xor_bytes < raw_bytes) {
+            // Control bytes (trailing zero bytes << 4 | significant bytes), then the significant bytes
+            out.assign(xor_bytes, 0);
+            unsigned char* payload = out.data() + rows;
+            previous = 0;
+            for (int r = 0; r < rows; ++r) {
+                uint64_t x = toBits(values[r]) ^ previous;
+                previous ^= x;
+                if (x == 0) {
+                    out[r] = 0;
+                    continue;
+                }
+                int trailing = trailingZeroBytes(x);
+                int significant = 8 - leadingZeroBytes(x) - trailing;
+                out[r] = static_cast<unsigned char>((trailing << 4) | significant);
+                uint64_t shifted = x >> (8 * trailing);
+                for (int k = 0; k < significant; ++k) {
+                    *payload++ = static_cast<unsigned char>(shifted >> (8 * k));
+                }
+            }
+            return ENCODING_XOR;
+        }
+
+        out.resize(raw_bytes);
+        std::memcpy(out.data(), values, raw_bytes);
+        return ENCODING_RAW;
+    }
+
+    // The payload always has eight readable bytes left (see encodeChunk)
+    uint64_t loadLittleEndian(const unsigned char* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+#else
+        uint64_t word = 0;
+        for (int k = 0; k < 8; ++k) {
+            word |= static_cast<uint64_t>(p[k]) << (8 * k);
+        }
+        return word;
+#endif
+    }
+
+    /**
+     * Decode one chunk, checking every length and index against its size
+     * @param data Chunk bytes
+     * @param bytes Chunk size from the directory
+     * @param encoding Encoding from the directory
+     * @param rows Rows in the block
+     * @param out Receives rows values
+     * @return false if the chunk is too short for its encoding or holds an invalid index
+     */
+    bool decodeChunk(const unsigned char* data, size_t bytes, uint32_t encoding, int rows, double* out) {
+        size_t count = static_cast<size_t>(rows);
+        switch (encoding) {
+            case ENCODING_CONSTANT: {
+                if (bytes < 8) {
+                    return false;
+                }
+                double value;
+                std::memcpy(&value, data, 8);
+                std::fill(out, out + rows, value);
+                break;
+            }
+            case ENCODING_DICTIONARY: {
+                if (bytes < 8) {
+                    return false;
+                }
+                uint32_t size;
+                std::memcpy(&size, data, 4);
+                if (size > 256 || 8 + static_cast<size_t>(size) * 8 + count > bytes) {
+                    return false;
+                }
+                double dictionary[256];
+                std::memcpy(dictionary, data + 8, static_cast<size_t>(size) * 8);
+                const unsigned char* indices = data + 8 + static_cast<size_t>(size) * 8;
+                for (int r = 0; r < rows; ++r) {
+                    if (indices[r] >= size) {
+                        return false;
+                    }
+                    out[r] = dictionary[indices[r]];
+                }
+                break;
+            }
+            case ENCODING_XOR: {
+                // Control bytes, the significant bytes they describe and the eight bytes of slack
+                if (count + 8 > bytes) {
+                    return false;
+                }
+                size_t payload_bytes = 0;
+                for (int r = 0; r < rows; ++r) {
+                    unsigned control = data[r];
+                    if ((control >> 4) + (control & 0x0fU) > 8) {
+                        return false;
+                    }
+                    payload_bytes += control & 0x0fU;
+                }
+                if (count + payload_bytes + 8 > bytes) {
+                    return false;
+                }
+                const unsigned char* payload = data + rows;
+                uint64_t previous = 0;
+                for (int r = 0; r < rows; ++r) {
+                    unsigned control = data[r];
+                    unsigned significant = control & 0x0fU;
+                    uint64_t word = loadLittleEndian(payload);
+                    uint64_t mask = (significant == 8) ? ~0ULL : ((1ULL << (8 * significant)) - 1);
+                    previous ^= (word & mask) << (8 * (control >> 4));
+                    payload += significant;
+                    out[r] = fromBits(previous);
+                }
+                break;
+            }
+            default:
+                if (count * 8 > bytes) {
+                    return false;
+                }
+                std::memcpy(out, data, count * 8);
+                break;
+        }
+        return true;
+    }
+
+    bool inRange(double value, double low, double high) {
+        return value >= low && value <= high;
+    }
+}
+
+ResultsStore::Predicate ResultsStore::Predicate::greaterThan(Column column, double value) {
+    return {column, std::nextafter(value, HUGE_VAL), HUGE_VAL};
+}
+
+ResultsStore::Predicate ResultsStore::Predicate::atLeast(Column column, double value) {
+    return {column, value, HUGE_VAL};
+}
+
+ResultsStore::Predicate ResultsStore::Predicate::lessThan(Column column, double value) {
+    return {column, -HUGE_VAL, std::nextafter(value, -HUGE_VAL)};
+}
+
+ResultsStore::Predicate ResultsStore::Predicate::atMost(Column column, double value) {
+    return {column, -HUGE_VAL, value};
+}
+
+ResultsStore::Predicate ResultsStore::Predicate::between(Column column, double low, double high) {
+    return {column, low, high};
+}
+
+ResultsStore::Row ResultsStore::makeRow(const GeometryProperties& geometry, const FluidProperties& hot,
+                                        const FluidProperties& cold,
+                                        const NumericalSolver::SolutionResults& coefficients,
+                                        double hot_outlet, double cold_outlet, double duty) {
+    Row row;
+    row[LENGTH] = geometry.length;
+    row[SHELL_DIAMETER] = geometry.shell_diameter;
+    row[TUBE_DIAMETER] = geometry.tube_diameter;
+    row[TUBE_THICKNESS] = geometry.tube_thickness;
+    row[NUM_TUBES] = geometry.num_tubes;
+    row[WALL_CONDUCTIVITY] = geometry.wall_thermal_cond;
+    row[HOT_INLET] = hot.inlet_temp;
+    row[COLD_INLET] = cold.inlet_temp;
+    row[HOT_FLOW] = hot.mass_flow;
+    row[COLD_FLOW] = cold.mass_flow;
+    row[HOT_REYNOLDS] = coefficients.hot_reynolds;
+    row[COLD_REYNOLDS] = coefficients.cold_reynolds;
+    row[HOT_NUSSELT] = coefficients.hot_nusselt;
+    row[COLD_NUSSELT] = coefficients.cold_nusselt;
+    row[HOT_HTC] = coefficients.hot_htc;
+    row[COLD_HTC] = coefficients.cold_htc;
+    row[OVERALL_HTC] = coefficients.overall_htc;
+    row[HOT_OUTLET] = hot_outlet;
+    row[COLD_OUTLET] = cold_outlet;
+    row[DUTY] = duty;
+    double C_min = std::min(hot.mass_flow * hot.specific_heat, cold.mass_flow * cold.specific_heat);
+    row[EFFECTIVENESS] = duty / (C_min * (hot.inlet_temp - cold.inlet_temp));
+    return row;
+}
+
+const char* ResultsStore::columnName(Column column) {
+    static const char* const names[COLUMN_COUNT] = {
+        "length", "shell_diameter", "tube_diameter", "tube_thickness", "num_tubes", "wall_conductivity",
+        "hot_inlet", "cold_inlet", "hot_flow", "cold_flow",
+        "hot_reynolds", "cold_reynolds", "hot_nusselt", "cold_nusselt", "hot_htc", "cold_htc", "overall_htc",
+        "hot_outlet", "cold_outlet", "duty", "effectiveness"};
+    return (column >= 0 && column < COLUMN_COUNT) ? names[column] : "unknown";
+}
+
+ResultsStore::ResultsStore() : header(nullptr), directory(nullptr) {}
+
+bool ResultsStore::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        std::cerr << "Error: Could not open results store " << path << "\n";
+        return false;
+    }
+
+    const char* data = file.data();
+    size_t size = file.size();
+    const FileHeader* candidate = reinterpret_cast<const FileHeader*>(data);
+    if (size < sizeof(FileHeader) || std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Error: " << path << " is not a results store\n";
+        close();
+        return false;
+    }
+    if (candidate->endian_marker != ENDIAN_MARKER || candidate->version != FORMAT_VERSION ||
+        candidate->column_count != COLUMN_COUNT) {
+        std::cerr << "Error: " << path << " has format version " << candidate->version
+                  << " or byte order unsupported by this build (expected version " << FORMAT_VERSION << ")\n";
+        close();
+        return false;
+    }
+    uint64_t entries = candidate->block_count * COLUMN_COUNT;
+    if (candidate->file_size != size || candidate->rows_per_block < 1 ||
+        candidate->directory_offset + entries * sizeof(ChunkEntry) > size ||
+        candidate->block_count != (candidate->row_count + candidate->rows_per_block - 1) / candidate->rows_per_block) {
+        std::cerr << "Error: " << path << " is truncated\n";
+        close();
+        return false;
+    }
+
+    // Bounds-check the directory once so queries can trust it
+    const ChunkEntry* chunks = reinterpret_cast<const ChunkEntry*>(data + candidate->directory_offset);
+    for (uint64_t i = 0; i < entries; ++i) {
+        if (chunks[i].offset + chunks[i].bytes > candidate->directory_offset || (chunks[i].encoding & ~CONTAINS_NAN) > ENCODING_RAW) {
+            std::cerr << "Error: " << path << " has a corrupt chunk entry " << i << "\n";
+            close();
+            return false;
+        }
+    }
+
+    header = candidate;
+    directory = chunks;
+    return true;
+}
+
+void ResultsStore::close() {
+    file.close();
+    header = nullptr;
+    directory = nullptr;
+}
+
+long long ResultsStore::rowCount() const {
+    return header ? static_cast<long long>(header->row_count) : 0;
+}
+
+int ResultsStore::blockCount() const {
+    return header ? static_cast<int>(header->block_count) : 0;
+}
+
+int ResultsStore::rowsPerBlock() const {
+    return header ? static_cast<int>(header->rows_per_block) : 0;
+}
+
+const ResultsStore::ChunkEntry& ResultsStore::entry(int block, Column column) const {
+    return directory[static_cast<size_t>(block) * COLUMN_COUNT + column];
+}
+
+int ResultsStore::blockRows(int block) const {
+    long long first = static_cast<long long>(block) * header->rows_per_block;
+    return static_cast<int>(std::min<long long>(header->rows_per_block, rowCount() - first));
+}
+
+int ResultsStore::readBlock(int block, Column column, double* out) const {
+    if (block < 0 || block >= blockCount() || column < 0 || column >= COLUMN_COUNT) {
+        throw std::out_of_range("Block or column out of range");
+    }
+    const ChunkEntry& chunk = entry(block, column);
+    int rows = blockRows(block);
+    if (!decodeChunk(reinterpret_cast<const unsigned char*>(file.data() + chunk.offset), chunk.bytes,
+                     chunk.encoding & ENCODING_MASK, rows, out)) {
+        throw std::runtime_error("Corrupt chunk in block " + std::to_string(block));
+    }
+    return rows;
+}
+
+ResultsStore::Row ResultsStore::row(long long index) const {
+    if (index < 0 || index >= rowCount()) {
+        throw std::out_of_range("Row index out of range");
+    }
+    int block = static_cast<int>(index / header->rows_per_block);
+    std::vector<double> values(header->rows_per_block);
+    Row result;
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        readBlock(block, static_cast<Column>(c), values.data());
+        result.values[c] = values[index % header->rows_per_block];
+    }
+    return result;
+}
+
+int ResultsStore::zoneVerdict(int block, const std::vector<Predicate>& predicates) const {
+    bool all = true;
+    for (const Predicate& p : predicates) {
+        const ChunkEntry& chunk = entry(block, p.column);
+        if (chunk.min > chunk.max || chunk.max < p.low || chunk.min > p.high) {
+            return -1;
+        }
+        // NaN rows fall outside the zone map, so only a NaN-free chunk can be accepted whole
+        if (!(chunk.min >= p.low && chunk.max <= p.high) || (chunk.encoding & CONTAINS_NAN)) {
+            all = false;
+        }
+    }
+    return all ? 1 : 0;
+}
+
+void ResultsStore::matchBlock(int block, const std::vector<Predicate>& predicates,
+                              std::vector<double>& scratch, std::vector<unsigned char>& match) const {
+    int rows = blockRows(block);
+    match.assign(rows, 1);
+    scratch.resize(header->rows_per_block);
+    for (const Predicate& p : predicates) {
+        readBlock(block, p.column, scratch.data());
+        unsigned char any = 0;
+        for (int r = 0; r < rows; ++r) {
+            match[r] &= static_cast<unsigned char>(inRange(scratch[r], p.low, p.high));
+            any |= match[r];
+        }
+        if (!any) {
+            return;     // Remaining columns need not be decoded
+        }
+    }
+}
+
+std::vector<long long> ResultsStore::filter(const std::vector<Predicate>& predicates, int num_threads,
+                                            QueryStats* stats) const {
+    auto start = std::chrono::steady_clock::now();
+    int blocks = blockCount();
+    std::vector<std::vector<long long>> block_rows(blocks);
+    std::vector<int> verdicts(blocks);
+
+    ParallelUtils::parallelFor(0, blocks, num_threads, [&](long long b) {
+        int block = static_cast<int>(b);
+        long long first = static_cast<long long>(block) * header->rows_per_block;
+        int rows = blockRows(block);
+        verdicts[block] = zoneVerdict(block, predicates);
+        if (verdicts[block] < 0) {
+            return;
+        }
+        std::vector<long long>& out = block_rows[block];
+        if (verdicts[block] > 0) {
+            out.resize(rows);
+            for (int r = 0; r < rows; ++r) {
+                out[r] = first + r;
+            }
+            return;
+        }
+        thread_local std::vector<double> scratch;
+        thread_local std::vector<unsigned char> match;
+        matchBlock(block, predicates, scratch, match);
+        for (int r = 0; r < rows; ++r) {
+            if (match[r]) {
+                out.push_back(first + r);
+            }
+        }
+    });
+
+    std::vector<long long> result;
+    QueryStats local{0, 0, 0, 0, 0.0};
+    for (int block = 0; block < blocks; ++block) {
+        local.blocks_skipped += verdicts[block] < 0;
+        local.blocks_accepted += verdicts[block] > 0;
+        local.blocks_decoded += verdicts[block] == 0;
+        result.insert(result.end(), block_rows[block].begin(), block_rows[block].end());
+    }
+    local.rows_matched = static_cast<long long>(result.size());
+    local.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats) {
+        *stats = local;
+    }
+    return result;
+}
+
+long long ResultsStore::count(const std::vector<Predicate>& predicates, int num_threads, QueryStats* stats) const {
+    auto start = std::chrono::steady_clock::now();
+    int blocks = blockCount();
+    std::vector<long long> counts(blocks, 0);
+    std::vector<int> verdicts(blocks);
+
+    ParallelUtils::parallelFor(0, blocks, num_threads, [&](long long b) {
+        int block = static_cast<int>(b);
+        verdicts[block] = zoneVerdict(block, predicates);
+        if (verdicts[block] > 0) {
+            counts[block] = blockRows(block);
+        } else if (verdicts[block] == 0) {
+            thread_local std::vector<double> scratch;
+            thread_local std::vector<unsigned char> match;
+            matchBlock(block, predicates, scratch, match);
+            long long matched = 0;
+            for (unsigned char m : match) {
+                matched += m;
+            }
+            counts[block] = matched;
+        }
+    });
+
+    QueryStats local{0, 0, 0, 0, 0.0};
+    for (int block = 0; block < blocks; ++block) {
+        local.blocks_skipped += verdicts[block] < 0;
+        local.blocks_accepted += verdicts[block] > 0;
+        local.blocks_decoded += verdicts[block] == 0;
+        local.rows_matched += counts[block];
+    }
+    local.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats) {
+        *stats = local;
+    }
+    return local.rows_matched;
+}
+
+std::vector<long long> ResultsStore::topK(const std::vector<Predicate>& predicates, Column order_by, int k,
+                                          bool descending, QueryStats* stats) const {
+    auto start = std::chrono::steady_clock::now();
+    QueryStats local{0, 0, 0, 0, 0.0};
+    double sign = descending ? 1.0 : -1.0;      // Rank by sign * value, largest first
+
+    // Candidate blocks ordered by the best value their zone map allows
+    std::vector<std::pair<double, int>> candidates;
+    for (int block = 0; block < blockCount(); ++block) {
+        const ChunkEntry& chunk = entry(block, order_by);
+        if (chunk.min > chunk.max || zoneVerdict(block, predicates) < 0) {
+            ++local.blocks_skipped;
+            continue;
+        }
+        candidates.push_back({descending ? chunk.max : -chunk.min, block});
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first > b.first; });
+
+    // Min-heap of (ranked value, -row): the top is the weakest of the current best k
+    using Entry = std::pair<double, long long>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> best;
+    std::vector<double> scratch, values(rowsPerBlock());
+    std::vector<unsigned char> match;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (k <= 0 || (static_cast<int>(best.size()) == k && candidates[i].first <= best.top().first)) {
+            local.blocks_skipped += static_cast<long long>(candidates.size() - i);
+            break;
+        }
+        int block = candidates[i].second;
+        long long first = static_cast<long long>(block) * header->rows_per_block;
+        int rows = blockRows(block);
+        if (zoneVerdict(block, predicates) > 0) {
+            match.assign(rows, 1);
+            ++local.blocks_accepted;
+        } else {
+            matchBlock(block, predicates, scratch, match);
+            ++local.blocks_decoded;
+        }
+        readBlock(block, order_by, values.data());
+        for (int r = 0; r < rows; ++r) {
+            if (!match[r] || std::isnan(values[r])) {
+                continue;
+            }
+            ++local.rows_matched;
+            Entry candidate{sign * values[r], -(first + r)};
+            if (static_cast<int>(best.size()) < k) {
+                best.push(candidate);
+            } else if (candidate > best.top()) {
+                best.pop();
+                best.push(candidate);
+            }
+        }
+    }
+
+    std::vector<long long> result(best.size());
+    for (size_t i = result.size(); i-- > 0;) {
+        result[i] = -best.top().second;
+        best.pop();
+    }
+    local.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats) {
+        *stats = local;
+    }
+    return result;
+}
+
+ResultsStoreWriter::ResultsStoreWriter()
+    : file(nullptr), rows_per_block(0), rows(0), offset(0), failed(false) {}
+
+ResultsStoreWriter::~ResultsStoreWriter() {
+    close();
+}
+
+bool ResultsStoreWriter::write(const void* data, size_t bytes) {
+    if (!failed && std::fwrite(data, 1, bytes, file) != bytes) {
+        failed = true;
+    }
+    offset += bytes;
+    return !failed;
+}
+
+bool ResultsStoreWriter::open(const std::string& output_path, int block_rows) {
+    close();
+    if (block_rows < 1 || block_rows > MAX_ROWS_PER_BLOCK) {
+        throw std::invalid_argument("Rows per block must be between 1 and 16777216");
+    }
+    file = std::fopen(output_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Could not open file " << output_path << " for writing\n";
+        return false;
+    }
+    path = output_path;
+    rows_per_block = block_rows;
+    rows = 0;
+    offset = 0;
+    failed = false;
+    directory.clear();
+    columns.assign(ResultsStore::COLUMN_COUNT, std::vector<double>());
+    for (std::vector<double>& column : columns) {
+        column.reserve(rows_per_block);
+    }
+
+    // Placeholder header, rewritten by close()
+    ResultsStore::FileHeader placeholder;
+    std::memset(&placeholder, 0, sizeof(placeholder));
+    return write(&placeholder, sizeof(placeholder));
+}
+
+bool ResultsStoreWriter::append(const ResultsStore::Row& row) {
+    if (!file) {
+        return false;
+    }
+    for (int c = 0; c < ResultsStore::COLUMN_COUNT; ++c) {
+        columns[c].push_back(row.values[c]);
+    }
+    ++rows;
+    if (static_cast<int>(columns[0].size()) == rows_per_block) {
+        return flushBlock();
+    }
+    return !failed;
+}
+
+bool ResultsStoreWriter::flushBlock() {
+    int block_rows = static_cast<int>(columns[0].size());
+    if (block_rows == 0) {
+        return !failed;
+    }
+    static const unsigned char padding[ALIGNMENT] = {0};
+    for (int c = 0; c < ResultsStore::COLUMN_COUNT; ++c) {
+        const std::vector<double>& values = columns[c];
+        ResultsStore::ChunkEntry chunk;
+        chunk.offset = offset;
+        chunk.encoding = encodeChunk(values.data(), block_rows, encoded);
+        chunk.bytes = static_cast<uint32_t>(encoded.size());
+        chunk.min = HUGE_VAL;
+        chunk.max = -HUGE_VAL;
+        for (double value : values) {
+            if (std::isnan(value)) {
+                chunk.encoding |= CONTAINS_NAN;
+            } else {
+                chunk.min = std::min(chunk.min, value);
+                chunk.max = std::max(chunk.max, value);
+            }
+        }
+        directory.push_back(chunk);
+        write(encoded.data(), encoded.size());
+        write(padding, alignUp(encoded.size()) - encoded.size());
+        columns[c].clear();
+    }
+    return !failed;
+}
+
+bool ResultsStoreWriter::close() {
+    if (!file) {
+        return !failed;
+    }
+    flushBlock();
+
+    ResultsStore::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = ResultsStore::FORMAT_VERSION;
+    header.endian_marker = ENDIAN_MARKER;
+    header.column_count = ResultsStore::COLUMN_COUNT;
+    header.rows_per_block = static_cast<uint32_t>(rows_per_block);
+    header.row_count = static_cast<uint64_t>(rows);
+    header.block_count = directory.size() / ResultsStore::COLUMN_COUNT;
+    header.directory_offset = offset;
+    write(directory.data(), directory.size() * sizeof(ResultsStore::ChunkEntry));
+    header.file_size = offset;
+
+    if (!failed && (std::fseek(file, 0, SEEK_SET) != 0 ||
+                    std::fwrite(&header, 1, sizeof(header), file) != sizeof(header))) {
+        failed = true;
+    }
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    if (failed) {
+        std::cerr << "Error: Could not write results store " << path << "\n";
+    }
+    return !failed;
+}
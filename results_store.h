@@ -0,0 +1,236 @@
+#ifndef RESULTS_STORE_H
+#define RESULTS_STORE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "fluid_properties.h"
+#include "mapped_file.h"
+#include "numerical_solver.h"
+
+/**
+ * @file results_store.h
+ * @brief Compressed columnar file of sweep inputs and scalar results, with zone-map queries
+ *
+ * Rows are grouped into blocks. Each column of a block is stored as a
+ * separate chunk, encoded with whichever of four encodings is smallest:
+ *   constant    one value for the whole block
+ *   dictionary  up to 256 distinct values and one byte per row
+ *   xor         each value XOR the previous one, with leading and trailing
+ *               zero bytes dropped (one control byte per row)
+ *   raw         plain doubles
+ * All four are lossless. The directory keeps the minimum and maximum of
+ * every block column (NaN excluded). Queries only decode chunks of blocks
+ * that the zone maps cannot rule out. If the zone maps show that every row
+ * of a block matches, the block is not decoded at all.
+ *
+ * Binary layout (native byte order, checked by an endian marker):
+ *   FileHeader | chunks (8-byte aligned) | ChunkEntry[block_count][COLUMN_COUNT]
+ */
+
+class ResultsStore {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    enum Column {
+        // Case inputs
+        LENGTH, SHELL_DIAMETER, TUBE_DIAMETER, TUBE_THICKNESS, NUM_TUBES, WALL_CONDUCTIVITY,
+        HOT_INLET, COLD_INLET, HOT_FLOW, COLD_FLOW,
+        // Scalar results
+        HOT_REYNOLDS, COLD_REYNOLDS, HOT_NUSSELT, COLD_NUSSELT, HOT_HTC, COLD_HTC, OVERALL_HTC,
+        HOT_OUTLET, COLD_OUTLET, DUTY, EFFECTIVENESS,
+        COLUMN_COUNT
+    };
+
+    struct Row {
+        double values[COLUMN_COUNT];
+
+        double& operator[](Column column) { return values[column]; }
+        double operator[](Column column) const { return values[column]; }
+    };
+
+    /**
+     * Closed interval condition on one column (NaN never matches)
+     */
+    struct Predicate {
+        Column column;
+        double low;
+        double high;
+
+        static Predicate greaterThan(Column column, double value);
+        static Predicate atLeast(Column column, double value);
+        static Predicate lessThan(Column column, double value);
+        static Predicate atMost(Column column, double value);
+        static Predicate between(Column column, double low, double high);
+    };
+
+    struct QueryStats {
+        long long blocks_decoded;       // Blocks whose chunks were decoded
+        long long blocks_skipped;       // Ruled out by the zone maps
+        long long blocks_accepted;      // Every row matched according to the zone maps
+        long long rows_matched;
+        double elapsed_seconds;
+    };
+
+    /**
+     * Build a row from a rating
+     * @param geometry Exchanger geometry
+     * @param hot Shell-side stream (inlet and flow are recorded)
+     * @param cold Tube-side stream
+     * @param coefficients Reynolds, Nusselt and film coefficients (NumericalSolver::ratingCoefficients)
+     * @param hot_outlet Hot outlet temperature (K)
+     * @param cold_outlet Cold outlet temperature (K)
+     * @param duty Heat duty (W); effectiveness is duty / (C_min (T_hot,in - T_cold,in))
+     */
+    static Row makeRow(const GeometryProperties& geometry, const FluidProperties& hot, const FluidProperties& cold,
+                       const NumericalSolver::SolutionResults& coefficients,
+                       double hot_outlet, double cold_outlet, double duty);
+
+    static const char* columnName(Column column);
+
+    ResultsStore();
+
+    /**
+     * Map a results store
+     * @param path Store written by ResultsStoreWriter
+     * @return false if the file is missing, truncated or has another format version
+     */
+    bool open(const std::string& path);
+    void close();
+
+    long long rowCount() const;
+    int blockCount() const;
+    int rowsPerBlock() const;
+    size_t fileBytes() const { return file.size(); }
+
+    /**
+     * Rows satisfying every predicate, in row order
+     * @param predicates Conditions combined with AND (empty = all rows)
+     * @param num_threads Worker threads (0 = hardware concurrency)
+     * @param stats Optional block and timing statistics
+     * @return Matching row indices
+     */
+    std::vector<long long> filter(const std::vector<Predicate>& predicates, int num_threads = 0,
+                                  QueryStats* stats = nullptr) const;
+
+    /**
+     * Number of rows satisfying every predicate
+     */
+    long long count(const std::vector<Predicate>& predicates, int num_threads = 0,
+                    QueryStats* stats = nullptr) const;
+
+    /**
+     * The k matching rows with the largest (or smallest) value of a column.
+     * Blocks are visited in order of their zone-map bound, and the scan stops
+     * once no remaining block can beat the current k-th value.
+     * @param predicates Conditions combined with AND
+     * @param order_by Ranking column
+     * @param k Number of rows
+     * @param descending true for the largest values
+     * @param stats Optional block and timing statistics
+     * @return Row indices, best first
+     */
+    std::vector<long long> topK(const std::vector<Predicate>& predicates, Column order_by, int k,
+                                bool descending = true, QueryStats* stats = nullptr) const;
+
+    /**
+     * Decode one row
+     * @param index Row index
+     */
+    Row row(long long index) const;
+
+    /**
+     * Decode a column of one block (throws std::runtime_error if the chunk is
+     * shorter than its encoding needs or holds an invalid dictionary index)
+     * @param block Block index
+     * @param column Column
+     * @param out Receives the block's rows (at least rowsPerBlock() elements)
+     * @return Number of rows in the block
+     */
+    int readBlock(int block, Column column, double* out) const;
+
+private:
+    friend class ResultsStoreWriter;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t endian_marker;
+        uint32_t column_count;
+        uint32_t rows_per_block;
+        uint64_t row_count;
+        uint64_t block_count;
+        uint64_t directory_offset;
+        uint64_t file_size;
+    };
+
+    struct ChunkEntry {
+        uint64_t offset;            // Absolute, 8-byte aligned
+        uint32_t bytes;
+        uint32_t encoding;          // Chunk encoding, with 0x100 set if the chunk holds NaN
+        double min;                 // Zone map over non-NaN values (min > max if none)
+        double max;
+    };
+
+    MappedFile file;
+    const FileHeader* header;
+    const ChunkEntry* directory;
+
+    const ChunkEntry& entry(int block, Column column) const;
+    int blockRows(int block) const;
+
+    // -1: no row can match, 1: every row matches, 0: rows must be checked
+    int zoneVerdict(int block, const std::vector<Predicate>& predicates) const;
+
+    // Rows of a block that satisfy the predicates (match[r] = 1)
+    void matchBlock(int block, const std::vector<Predicate>& predicates,
+                    std::vector<double>& scratch, std::vector<unsigned char>& match) const;
+};
+
+/**
+ * Writes a ResultsStore file one block at a time (memory bounded by one block)
+ */
+class ResultsStoreWriter {
+public:
+    ResultsStoreWriter();
+    ~ResultsStoreWriter();
+
+    ResultsStoreWriter(const ResultsStoreWriter&) = delete;
+    ResultsStoreWriter& operator=(const ResultsStoreWriter&) = delete;
+
+    /**
+     * Create a store
+     * @param path Output file
+     * @param rows_per_block Rows per block (zone-map granularity)
+     * @return false if the file cannot be created
+     */
+    bool open(const std::string& path, int rows_per_block = 65536);
+
+    /** Buffer a row; a full block is encoded and written */
+    bool append(const ResultsStore::Row& row);
+
+    /**
+     * Write the last block, the directory and the header
+     * @return false if any write failed
+     */
+    bool close();
+
+    long long rowsWritten() const { return rows; }
+
+private:
+    std::FILE* file;
+    std::string path;
+    int rows_per_block;
+    long long rows;
+    uint64_t offset;
+    bool failed;
+    std::vector<std::vector<double>> columns;     // Current block, column-major
+    std::vector<ResultsStore::ChunkEntry> directory;
+    std::vector<unsigned char> encoded;
+
+    bool flushBlock();
+    bool write(const void* data, size_t bytes);
+};
+
+#endif // RESULTS_STORE_H
@@ -0,0 +1,399 @@
+#include "sharded_sweep.h"
+#include "mapped_file.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace ShardedSweep {
+
+    namespace {
+        const char QUEUE_MAGIC[8] = {'T', 'C', 'S', 'H', 'A', 'R', 'D', 'Q'};
+        const char SHARD_MAGIC[8] = {'T', 'C', 'S', 'H', 'A', 'R', 'D', '1'};
+        const char WORKER_FLAG[] = "--shard-worker";
+        const int MAX_WORKERS = 256;
+        const size_t ALIGNMENT = 64;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                      "The shard queue needs lock-free 64-bit atomics in shared memory");
+        static_assert(std::is_trivially_copyable<BatchSolver::BatchCase>::value,
+                      "Cases are copied into shared memory byte for byte");
+
+        // Shared-memory queue: QueueHeader | BatchCase[case_count]
+        struct QueueHeader {
+            std::atomic<std::uint32_t> ready;                   // 1 once the rest of the queue is written
+            char magic[8];
+            std::uint64_t total_bytes;
+            std::uint64_t case_count;
+            std::uint64_t shard_count;
+            std::uint64_t shard_cases;
+            std::int32_t segments;
+            std::int32_t precision;
+            std::int32_t threads_per_worker;
+            std::int32_t reserved;
+            char output_prefix[512];
+            std::atomic<std::uint64_t> next_shard;              // Shard claims (fetch-and-add)
+            std::atomic<std::uint32_t> workers_attached;        // Worker id allocation
+            std::atomic<std::int32_t> worker_pids[MAX_WORKERS]; // 0 until the worker has registered
+        };
+
+        // Shard file: SHARD_MAGIC, then per shard a ShardRecord followed by
+        // hot outlets, cold outlets, duties and overall coefficients of its cases
+        struct ShardRecord {
+            std::uint64_t shard;
+            std::int64_t begin;
+            std::int64_t end;
+        };
+
+        size_t alignUp(size_t value) {
+            return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        std::string shardPath(const std::string& prefix, int worker) {
+            return prefix + ".worker" + std::to_string(worker);
+        }
+
+        BatchSolver::BatchSettings shardSettings(const QueueHeader& header) {
+            BatchSolver::BatchSettings batch;
+            batch.segments = header.segments;
+            batch.precision = static_cast<BatchSolver::Precision>(header.precision);
+            batch.num_threads = header.threads_per_worker;
+            batch.store_profiles = false;
+            return batch;
+        }
+
+        BatchSolver::BatchResults rateShard(const QueueHeader& header, const BatchSolver::BatchCase* cases,
+                                            long long begin, long long end) {
+            std::vector<BatchSolver::BatchCase> block(cases + begin, cases + end);
+            return BatchSolver::solve(block, shardSettings(header));
+        }
+
+        bool writeShard(std::FILE* out, std::uint64_t shard, long long begin, long long end,
+                        const BatchSolver::BatchResults& rated) {
+            ShardRecord record{shard, begin, end};
+            size_t count = static_cast<size_t>(end - begin);
+            return std::fwrite(&record, sizeof(record), 1, out) == 1 &&
+                   std::fwrite(rated.hot_outlet.data(), sizeof(double), count, out) == count &&
+                   std::fwrite(rated.cold_outlet.data(), sizeof(double), count, out) == count &&
+                   std::fwrite(rated.duty.data(), sizeof(double), count, out) == count &&
+                   std::fwrite(rated.overall_htc.data(), sizeof(double), count, out) == count &&
+                   std::fflush(out) == 0;
+        }
+
+        /**
+         * Copy the intact records of one shard file into the results
+         * @return Number of shards merged
+         */
+        long long mergeShardFile(const std::string& path, const QueueHeader& header,
+                                 ShardedResults& results, std::vector<char>& merged) {
+            MappedFile file;
+            if (!file.open(path) || file.size() < sizeof(SHARD_MAGIC) ||
+                std::memcmp(file.data(), SHARD_MAGIC, sizeof(SHARD_MAGIC)) != 0) {
+                return 0;
+            }
+            long long shards = 0;
+            size_t position = sizeof(SHARD_MAGIC);
+            while (position + sizeof(ShardRecord) <= file.size()) {
+                ShardRecord record;
+                std::memcpy(&record, file.data() + position, sizeof(record));
+                long long expected_begin = static_cast<long long>(record.shard * header.shard_cases);
+                long long expected_end = std::min<long long>(expected_begin + header.shard_cases, header.case_count);
+                if (record.shard >= header.shard_count || record.begin != expected_begin ||
+                    record.end != expected_end) {
+                    break;      // Not a record of this sweep
+                }
+                size_t column = static_cast<size_t>(record.end - record.begin) * sizeof(double);
+                const char* data = file.data() + position + sizeof(record);
+                position += sizeof(record) + 4 * column;
+                if (position > file.size()) {
+                    break;      // Torn by a worker that died while writing
+                }
+                if (merged[record.shard]) {
+                    continue;
+                }
+                std::memcpy(results.hot_outlet.data() + record.begin, data, column);
+                std::memcpy(results.cold_outlet.data() + record.begin, data + column, column);
+                std::memcpy(results.duty.data() + record.begin, data + 2 * column, column);
+                std::memcpy(results.overall_htc.data() + record.begin, data + 3 * column, column);
+                merged[record.shard] = 1;
+                ++shards;
+            }
+            return shards;
+        }
+
+#if !defined(_WIN32)
+        std::atomic<int> queue_counter(0);
+
+        bool processAlive(pid_t pid) {
+            return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+        }
+#endif
+    }
+
+    ShardSettings::ShardSettings()
+        : workers(0), shard_cases(16384), keep_shards(false), worker_wait_seconds(30.0) {
+        batch.num_threads = 1;
+    }
+
+    bool isWorkerInvocation(int argc, char** argv) {
+        return argc >= 3 && std::strcmp(argv[1], WORKER_FLAG) == 0;
+    }
+
+    int workerMain(int argc, char** argv) {
+        if (!isWorkerInvocation(argc, argv)) {
+            std::cerr << "Usage: " << (argc > 0 ? argv[0] : "worker") << " " << WORKER_FLAG << " <queue>\n";
+            return 2;
+        }
+        return runWorker(argv[2]) ? 0 : 1;
+    }
+
+#if !defined(_WIN32)
+
+    bool runWorker(const std::string& queue_name) {
+        int fd = shm_open(queue_name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            std::cerr << "Error: Could not attach to shard queue " << queue_name << "\n";
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(QueueHeader)) {
+            std::cerr << "Error: " << queue_name << " is not a shard queue\n";
+            ::close(fd);
+            return false;
+        }
+        size_t bytes = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            std::cerr << "Error: Could not map shard queue " << queue_name << "\n";
+            return false;
+        }
+        QueueHeader* header = static_cast<QueueHeader*>(address);
+        // Pairs with the coordinator's release store: a ready queue is visible in full
+        if (header->ready.load(std::memory_order_acquire) != 1 ||
+            std::memcmp(header->magic, QUEUE_MAGIC, sizeof(QUEUE_MAGIC)) != 0 || header->total_bytes != bytes) {
+            std::cerr << "Error: " << queue_name << " is not a shard queue\n";
+            munmap(address, bytes);
+            return false;
+        }
+        const BatchSolver::BatchCase* cases = reinterpret_cast<const BatchSolver::BatchCase*>(
+            static_cast<const char*>(address) + alignUp(sizeof(QueueHeader)));
+
+        int id = static_cast<int>(header->workers_attached.fetch_add(1));
+        if (id >= MAX_WORKERS) {
+            munmap(address, bytes);
+            return true;        // The queue has as many workers as it can track
+        }
+        header->worker_pids[id].store(static_cast<std::int32_t>(getpid()));
+
+        std::string path = shardPath(header->output_prefix, id);
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        bool ok = out && std::fwrite(SHARD_MAGIC, sizeof(SHARD_MAGIC), 1, out) == 1;
+        while (ok) {
+            std::uint64_t shard = header->next_shard.fetch_add(1);
+            if (shard >= header->shard_count) {
+                break;
+            }
+            long long begin = static_cast<long long>(shard * header->shard_cases);
+            long long end = std::min<long long>(begin + header->shard_cases, header->case_count);
+            ok = writeShard(out, shard, begin, end, rateShard(*header, cases, begin, end));
+        }
+        if (out && std::fclose(out) != 0) {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Error: Could not write shard file " << path << "\n";
+        }
+        munmap(address, bytes);
+        return ok;
+    }
+
+    ShardedResults run(const std::vector<BatchSolver::BatchCase>& cases, const ShardSettings& settings) {
+        if (settings.shard_cases < 1) {
+            throw std::invalid_argument("Shard size must be at least one case");
+        }
+        if (settings.batch.segments < 1) {
+            throw std::invalid_argument("Number of segments must be at least 1");
+        }
+        if (settings.batch.tube_correlation || settings.batch.shell_correlation) {
+            throw std::invalid_argument("User correlations are not passed to shard workers");
+        }
+        auto start = std::chrono::steady_clock::now();
+        long long n = static_cast<long long>(cases.size());
+
+        ShardedResults results;
+        results.hot_outlet.assign(cases.size(), 0.0);
+        results.cold_outlet.assign(cases.size(), 0.0);
+        results.duty.assign(cases.size(), 0.0);
+        results.overall_htc.assign(cases.size(), 0.0);
+        results.shards = (n + settings.shard_cases - 1) / settings.shard_cases;
+        results.workers_attached = 0;
+        results.recovered_shards = 0;
+        results.ok = true;
+
+        std::string tag = std::to_string(getpid()) + "-" + std::to_string(queue_counter.fetch_add(1));
+        std::string queue_name = "/thermocore-" + tag;
+        std::string prefix = settings.output_prefix.empty()
+            ? (std::filesystem::temp_directory_path() / ("thermocore-" + tag)).string()
+            : settings.output_prefix;
+        if (prefix.size() >= sizeof(QueueHeader::output_prefix)) {
+            throw std::invalid_argument("Shard output prefix is too long");
+        }
+
+        size_t bytes = alignUp(sizeof(QueueHeader)) + cases.size() * sizeof(BatchSolver::BatchCase);
+        int fd = shm_open(queue_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            std::cerr << "Error: Could not create shard queue " << queue_name << "\n";
+            if (fd >= 0) {
+                ::close(fd);
+                shm_unlink(queue_name.c_str());
+            }
+            results.ok = false;
+            return results;
+        }
+        void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            std::cerr << "Error: Could not map shard queue " << queue_name << "\n";
+            shm_unlink(queue_name.c_str());
+            results.ok = false;
+            return results;
+        }
+
+        QueueHeader* header = new (address) QueueHeader();
+        std::memcpy(header->magic, QUEUE_MAGIC, sizeof(QUEUE_MAGIC));
+        header->total_bytes = bytes;
+        header->case_count = static_cast<std::uint64_t>(n);
+        header->shard_count = static_cast<std::uint64_t>(results.shards);
+        header->shard_cases = static_cast<std::uint64_t>(settings.shard_cases);
+        header->segments = settings.batch.segments;
+        header->precision = static_cast<std::int32_t>(settings.batch.precision);
+        header->threads_per_worker = settings.batch.num_threads;
+        std::strncpy(header->output_prefix, prefix.c_str(), sizeof(header->output_prefix) - 1);
+        header->next_shard.store(0);
+        header->workers_attached.store(0);
+        for (std::atomic<std::int32_t>& pid : header->worker_pids) {
+            pid.store(0);
+        }
+        BatchSolver::BatchCase* shared_cases = reinterpret_cast<BatchSolver::BatchCase*>(
+            static_cast<char*>(address) + alignUp(sizeof(QueueHeader)));
+        if (n > 0) {
+            std::memcpy(static_cast<void*>(shared_cases), cases.data(), cases.size() * sizeof(BatchSolver::BatchCase));
+        }
+        // Published last: a worker that sees ready sees a complete queue
+        header->ready.store(1, std::memory_order_release);
+
+        // Spawn the workers and wait for them
+        std::string executable = settings.worker_executable.empty() ? "/proc/self/exe" : settings.worker_executable;
+        int workers = static_cast<int>(std::min<long long>(ParallelUtils::resolveThreadCount(settings.workers),
+                                                           std::max<long long>(results.shards, 1)));
+        std::vector<pid_t> children;
+        for (int w = 0; w < workers && results.shards > 0; ++w) {
+            char* argv[] = {const_cast<char*>(executable.c_str()), const_cast<char*>(WORKER_FLAG),
+                            const_cast<char*>(queue_name.c_str()), nullptr};
+            pid_t child;
+            if (posix_spawn(&child, executable.c_str(), nullptr, nullptr, argv, environ) != 0) {
+                std::cerr << "Error: Could not start worker " << executable << "\n";
+                break;
+            }
+            children.push_back(child);
+        }
+        for (pid_t child : children) {
+            int status;
+            while (waitpid(child, &status, 0) < 0 && errno == EINTR) {
+            }
+        }
+
+        // Close the queue, then let hand-started workers finish their current shard. Spawned
+        // workers are already reaped, and their PIDs may have been reused, so only the others are
+        // polled. A PID can be reused while it is polled too, hence the bound on the wait.
+        header->next_shard.store(header->shard_count);
+        int attached = static_cast<int>(std::min<std::uint32_t>(header->workers_attached.load(), MAX_WORKERS));
+        auto wait_end = std::chrono::steady_clock::now() +
+                        std::chrono::duration<double>(std::max(0.0, settings.worker_wait_seconds));
+        for (int w = 0; w < attached; ++w) {
+            pid_t pid = static_cast<pid_t>(header->worker_pids[w].load());
+            if (std::find(children.begin(), children.end(), pid) != children.end()) {
+                continue;
+            }
+            while (processAlive(pid) && std::chrono::steady_clock::now() < wait_end) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        results.workers_attached = attached;
+
+        // Merge the shard files in case order; shards no file holds intact are rated here
+        std::vector<char> merged(static_cast<size_t>(results.shards), 0);
+        for (int w = 0; w < attached; ++w) {
+            std::string path = shardPath(prefix, w);
+            mergeShardFile(path, *header, results, merged);
+            if (!settings.keep_shards) {
+                std::remove(path.c_str());
+            }
+        }
+        for (long long shard = 0; shard < results.shards; ++shard) {
+            if (merged[shard]) {
+                continue;
+            }
+            long long begin = shard * settings.shard_cases;
+            long long end = std::min<long long>(begin + settings.shard_cases, n);
+            BatchSolver::BatchResults rated = rateShard(*header, shared_cases, begin, end);
+            std::copy(rated.hot_outlet.begin(), rated.hot_outlet.end(), results.hot_outlet.begin() + begin);
+            std::copy(rated.cold_outlet.begin(), rated.cold_outlet.end(), results.cold_outlet.begin() + begin);
+            std::copy(rated.duty.begin(), rated.duty.end(), results.duty.begin() + begin);
+            std::copy(rated.overall_htc.begin(), rated.overall_htc.end(), results.overall_htc.begin() + begin);
+            ++results.recovered_shards;
+        }
+
+        header->~QueueHeader();
+        munmap(address, bytes);
+        shm_unlink(queue_name.c_str());
+        results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return results;
+    }
+
+#else
+
+    bool runWorker(const std::string& queue_name) {
+        std::cerr << "Error: Shard queue " << queue_name << " needs POSIX shared memory\n";
+        return false;
+    }
+
+    ShardedResults run(const std::vector<BatchSolver::BatchCase>& cases, const ShardSettings& settings) {
+        if (settings.shard_cases < 1) {
+            throw std::invalid_argument("Shard size must be at least one case");
+        }
+        std::cerr << "Error: Sharded sweeps need POSIX shared memory and processes\n";
+        ShardedResults results;
+        results.shards = (static_cast<long long>(cases.size()) + settings.shard_cases - 1) / settings.shard_cases;
+        results.workers_attached = 0;
+        results.recovered_shards = 0;
+        results.elapsed_seconds = 0.0;
+        results.ok = false;
+        return results;
+    }
+
+#endif
+
+} // namespace ShardedSweep
@@ -0,0 +1,85 @@
+#ifndef SHARDED_SWEEP_H
+#define SHARDED_SWEEP_H
+
+#include <string>
+#include <vector>
+#include "batch_solver.h"
+
+/**
+ * @file sharded_sweep.h
+ * @brief Multi-process sweeps: a coordinator hands out shards to worker processes through shared memory
+ *
+ * The coordinator copies the cases into a POSIX shared-memory queue and
+ * splits them into fixed-size shards. Worker processes attach to the queue
+ * by name and claim shards with an atomic fetch-and-add on the next-shard
+ * counter, so there is no lock and no shard is handed out twice. Each worker
+ * rates its shards with BatchSolver and appends the results to its own
+ * shard file (<prefix>.worker<id>), then marks the shard done. Workers have
+ * separate heaps and can be placed on any socket by the OS. Once the
+ * workers have exited, the coordinator rates any shard a crashed worker
+ * left unfinished and merges the shard files in case order.
+ *
+ * Worker processes are started by running an executable with
+ * "--shard-worker <queue>". Programs that call run() with the default
+ * worker_executable must forward that invocation to workerMain() at the
+ * top of main(). Extra workers started by hand with the same arguments
+ * join the running sweep. Spawned workers are reaped with waitpid(). A
+ * hand-started worker is polled by PID for at most worker_wait_seconds;
+ * shards it has not finished by then are rated by the coordinator.
+ */
+
+namespace ShardedSweep {
+
+    struct ShardSettings {
+        int workers;                            // Worker processes to spawn (0 = hardware concurrency)
+        long long shard_cases;                  // Cases per shard
+        BatchSolver::BatchSettings batch;       // Segments and precision (no user correlations); num_threads is per worker
+        std::string output_prefix;              // Shard files; empty = temporary directory
+        std::string worker_executable;          // Empty = the running executable
+        bool keep_shards;                       // Leave the shard files after merging
+        double worker_wait_seconds;             // Longest wait for hand-started workers once the queue closes
+
+        ShardSettings();
+    };
+
+    struct ShardedResults {
+        std::vector<double> hot_outlet;         // K, per case
+        std::vector<double> cold_outlet;        // K
+        std::vector<double> duty;               // W
+        std::vector<double> overall_htc;        // W/m²·K
+        long long shards;
+        int workers_attached;                   // Spawned and hand-started workers that claimed the queue
+        long long recovered_shards;             // Rated by the coordinator after a worker failed
+        double elapsed_seconds;
+        bool ok;                                // false if the queue could not be created
+    };
+
+    /**
+     * Rate every case on worker processes and merge their shards
+     * @param cases Cases to rate
+     * @param settings Workers, shard size and batch settings
+     * @return Per-case results in case order
+     */
+    ShardedResults run(const std::vector<BatchSolver::BatchCase>& cases, const ShardSettings& settings);
+
+    /**
+     * @return true if the arguments are a worker invocation ("--shard-worker <queue>")
+     */
+    bool isWorkerInvocation(int argc, char** argv);
+
+    /**
+     * Worker entry point for main()
+     * @return Process exit code (0 when the queue was drained)
+     */
+    int workerMain(int argc, char** argv);
+
+    /**
+     * Attach to a queue and rate shards until none are left
+     * @param queue_name Shared-memory name passed by the coordinator
+     * @return false if the queue could not be attached or a shard file could not be written
+     */
+    bool runWorker(const std::string& queue_name);
+
+} // namespace ShardedSweep
+
+#endif // SHARDED_SWEEP_H
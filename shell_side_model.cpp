@@ -0,0 +1,188 @@
+#include "shell_side_model.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Taborek ideal tube bank coefficients: {Re lower bound, a1, a2} per layout
+    struct IdealCoefficientRow {
+        double re_min;
+        double a1;
+        double a2;
+    };
+
+    const IdealCoefficientRow IDEAL_ROWS[3][5] = {
+        // 30° (also used for 60°)
+        {{1e4, 0.321, -0.388}, {1e3, 0.321, -0.388}, {1e2, 0.593, -0.477}, {10, 1.360, -0.657}, {0, 1.400, -0.667}},
+        // 45°
+        {{1e4, 0.370, -0.396}, {1e3, 0.370, -0.396}, {1e2, 0.730, -0.500}, {10, 0.498, -0.656}, {0, 1.550, -0.667}},
+        // 90°
+        {{1e4, 0.370, -0.395}, {1e3, 0.107, -0.266}, {1e2, 0.408, -0.460}, {10, 0.900, -0.631}, {0, 0.970, -0.667}}
+    };
+    const double IDEAL_A3[3] = {1.450, 1.930, 1.187};
+    const double IDEAL_A4[3] = {0.519, 0.500, 0.370};
+}
+
+BaffleConfiguration::BaffleConfiguration()
+    : baffle_spacing(0), inlet_spacing(0), outlet_spacing(0), baffle_cut(0.25), pitch_ratio(1.25),
+      layout(HeatExchangerGeometry::TubeLayout::Triangular30),
+      shell_baffle_clearance(0.004), tube_baffle_clearance(0.0008), bundle_clearance(0.015),
+      pass_lane_width(0), sealing_strip_pairs(0) {}
+
+ShellSideModel::ShellSideModel(const GeometryProperties& geom, const BaffleConfiguration& baffles)
+    : geometry(geom), config(baffles) {
+    using HeatExchangerGeometry::TubeLayout;
+
+    double Ds = geometry.shell_diameter;
+    tube_outer_diameter = geometry.tube_diameter + 2.0 * geometry.tube_thickness;
+    double Do = tube_outer_diameter;
+    tube_pitch = HeatExchangerGeometry::tubePitch(Do, config.pitch_ratio);
+    double Pt = tube_pitch;
+
+    if (config.baffle_spacing <= 0) {
+        config.baffle_spacing = HeatExchangerGeometry::recommendedBaffleSpacing(Ds);
+    }
+    if (config.inlet_spacing <= 0) {
+        config.inlet_spacing = config.baffle_spacing;
+    }
+    if (config.outlet_spacing <= 0) {
+        config.outlet_spacing = config.baffle_spacing;
+    }
+    double Lbc = config.baffle_spacing;
+    double Bc = config.baffle_cut;
+    if (Bc <= 0.0 || Bc >= 0.5) {
+        throw std::invalid_argument("Baffle cut must lie between 0 and 0.5 of the shell diameter");
+    }
+
+    // Row pitch in the flow direction and effective transverse pitch per layout
+    double row_pitch, transverse_pitch;
+    switch (config.layout) {
+        case TubeLayout::RotatedSquare45:
+            row_pitch = 0.707 * Pt;
+            transverse_pitch = 0.707 * Pt;
+            layout_table = 1;
+            break;
+        case TubeLayout::Square90:
+            row_pitch = Pt;
+            transverse_pitch = Pt;
+            layout_table = 2;
+            break;
+        case TubeLayout::RotatedTriangular60:
+            row_pitch = 0.5 * Pt;
+            transverse_pitch = Pt;
+            layout_table = 0;
+            break;
+        case TubeLayout::Triangular30:
+        default:
+            row_pitch = 0.866 * Pt;
+            transverse_pitch = Pt;
+            layout_table = 0;
+            break;
+    }
+    pitch_factor = 1.33 / config.pitch_ratio;
+
+    // Bundle and window geometry
+    double Dotl = Ds - config.bundle_clearance;
+    double Dctl = Dotl - Do;
+    double theta_ds = 2.0 * std::acos(1.0 - 2.0 * Bc);
+    double theta_ctl = 2.0 * std::acos(std::max(-1.0, std::min(1.0, Ds * (1.0 - 2.0 * Bc) / Dctl)));
+
+    window_fraction = theta_ctl / (2.0 * M_PI) - std::sin(theta_ctl) / (2.0 * M_PI);
+    crossflow_fraction = 1.0 - 2.0 * window_fraction;
+
+    double window_tubes = window_fraction * geometry.num_tubes;
+    double gross_window_area = Ds * Ds / 4.0 * (theta_ds / 2.0 - std::sin(theta_ds) / 2.0);
+    window_area = gross_window_area - window_tubes * M_PI * Do * Do / 4.0;
+
+    crossflow_area = Lbc * ((Ds - Dotl) + Dctl / transverse_pitch * (Pt - Do));
+
+    // Leakage and bypass flow areas
+    double shell_baffle_leak = M_PI * Ds * (config.shell_baffle_clearance / 2.0) * (1.0 - theta_ds / (2.0 * M_PI));
+    double tube_baffle_leak = M_PI / 4.0 * (std::pow(Do + config.tube_baffle_clearance, 2) - Do * Do) *
+                              geometry.num_tubes * (1.0 - window_fraction);
+    double bypass_area = Lbc * ((Ds - Dotl) + config.pass_lane_width);
+
+    tube_rows_crossflow = Ds * (1.0 - 2.0 * Bc) / row_pitch;
+    tube_rows_window = 0.8 * Bc * Ds / row_pitch;
+    num_baffles = std::max(1, static_cast<int>(std::floor(
+        (geometry.length - config.inlet_spacing - config.outlet_spacing) / Lbc)) + 1);
+
+    // Baffle cut correction
+    J_c = 0.55 + 0.72 * crossflow_fraction;
+
+    // Leakage correction
+    double leak_total = shell_baffle_leak + tube_baffle_leak;
+    double r_s = (leak_total > 0) ? shell_baffle_leak / leak_total : 0.0;
+    double r_lm = leak_total / crossflow_area;
+    J_l = 0.44 * (1.0 - r_s) + (1.0 - 0.44 * (1.0 - r_s)) * std::exp(-2.2 * r_lm);
+
+    // Bypass correction
+    double F_sbp = bypass_area / crossflow_area;
+    double strips_ratio = config.sealing_strip_pairs / tube_rows_crossflow;
+    if (strips_ratio >= 0.5) {
+        J_b_laminar = 1.0;
+        J_b_turbulent = 1.0;
+    } else {
+        double strip_term = 1.0 - std::cbrt(2.0 * strips_ratio);
+        J_b_laminar = std::exp(-1.35 * F_sbp * strip_term);
+        J_b_turbulent = std::exp(-1.25 * F_sbp * strip_term);
+    }
+
+    // Unequal inlet/outlet spacing correction
+    double L_in = config.inlet_spacing / Lbc;
+    double L_out = config.outlet_spacing / Lbc;
+    auto spacingCorrection = [&](double n) {
+        return (num_baffles - 1 + std::pow(L_in, 1.0 - n) + std::pow(L_out, 1.0 - n)) /
+               (num_baffles - 1 + L_in + L_out);
+    };
+    J_s_laminar = spacingCorrection(1.0 / 3.0);
+    J_s_turbulent = spacingCorrection(0.6);
+
+    // Adverse temperature gradient correction in deep laminar flow
+    double rows_total = (num_baffles + 1) * (tube_rows_crossflow + tube_rows_window);
+    J_r_laminar_limit = std::pow(10.0 / rows_total, 0.18);
+}
+
+ShellSideModel::ShellSideResults ShellSideModel::rate(const FluidProperties& shell_fluid) const {
+    ShellSideResults results;
+
+    double mass_velocity = shell_fluid.mass_flow / crossflow_area;
+    results.reynolds = tube_outer_diameter * mass_velocity / shell_fluid.viscosity;
+    double Re = results.reynolds;
+
+    const IdealCoefficientRow* row = &IDEAL_ROWS[layout_table][4];
+    for (int i = 0; i < 5; ++i) {
+        if (Re >= IDEAL_ROWS[layout_table][i].re_min) {
+            row = &IDEAL_ROWS[layout_table][i];
+            break;
+        }
+    }
+    double a = IDEAL_A3[layout_table] / (1.0 + 0.14 * std::pow(Re, IDEAL_A4[layout_table]));
+    double j_ideal = row->a1 * std::pow(pitch_factor, a) * std::pow(Re, row->a2);
+
+    results.ideal_htc = j_ideal * shell_fluid.specific_heat * mass_velocity *
+                        std::pow(shell_fluid.prandtl, -2.0 / 3.0);
+
+    bool laminar = Re < 100.0;
+    results.J_c = J_c;
+    results.J_l = J_l;
+    results.J_b = laminar ? J_b_laminar : J_b_turbulent;
+    results.J_s = laminar ? J_s_laminar : J_s_turbulent;
+    if (Re <= 20.0) {
+        results.J_r = J_r_laminar_limit;
+    } else if (Re < 100.0) {
+        results.J_r = J_r_laminar_limit + (20.0 - Re) / 80.0 * (J_r_laminar_limit - 1.0);
+    } else {
+        results.J_r = 1.0;
+    }
+
+    results.shell_htc = results.ideal_htc * results.J_c * results.J_l * results.J_b *
+                        results.J_s * results.J_r;
+    results.nusselt = results.shell_htc * tube_outer_diameter / shell_fluid.thermal_cond;
+
+    return results;
+}
@@ -0,0 +1,88 @@
+#ifndef SHELL_SIDE_MODEL_H
+#define SHELL_SIDE_MODEL_H
+
+#include "fluid_properties.h"
+#include "heat_exchanger_geometry.h"
+
+/**
+ * @file shell_side_model.h
+ * @brief Bell-Delaware shell-side heat transfer with cached geometry factors
+ *
+ * The shell is split into baffle compartments with a cross-flow zone between
+ * the baffle tips and window zones at the cuts. Everything that depends only on
+ * geometry (flow areas, window fractions, leakage and bypass ratios, row counts)
+ * is computed once in the constructor; rate() only evaluates the flow-dependent
+ * terms, so repeated ratings of the same shell cost a few pow() calls.
+ */
+
+struct BaffleConfiguration {
+    double baffle_spacing;          // Central baffle spacing (m), 0 = recommendedBaffleSpacing
+    double inlet_spacing;           // Inlet baffle spacing (m), 0 = central spacing
+    double outlet_spacing;          // Outlet baffle spacing (m), 0 = central spacing
+    double baffle_cut;              // Baffle cut as a fraction of shell diameter
+    double pitch_ratio;             // Tube pitch / tube outer diameter
+    HeatExchangerGeometry::TubeLayout layout;
+    double shell_baffle_clearance;  // Diametral shell-to-baffle clearance (m)
+    double tube_baffle_clearance;   // Diametral tube-to-baffle-hole clearance (m)
+    double bundle_clearance;        // Shell diameter minus outer tube limit (m)
+    double pass_lane_width;         // Pass-partition lane width parallel to cross-flow (m)
+    int sealing_strip_pairs;
+
+    // Constructors
+    BaffleConfiguration();
+};
+
+class ShellSideModel {
+public:
+    struct ShellSideResults {
+        double reynolds;        // Based on tube outer diameter and cross-flow area
+        double ideal_htc;       // Ideal tube bank coefficient (W/m²·K)
+        double J_c;             // Baffle cut / window correction
+        double J_l;             // Baffle leakage correction
+        double J_b;             // Bundle bypass correction
+        double J_s;             // Unequal end spacing correction
+        double J_r;             // Laminar adverse gradient correction
+        double shell_htc;       // Corrected shell-side coefficient (W/m²·K)
+        double nusselt;         // shell_htc * D_o / k
+    };
+
+    ShellSideModel(const GeometryProperties& geom, const BaffleConfiguration& baffles = BaffleConfiguration());
+
+    /**
+     * Rate the shell side for one fluid/flow using the cached geometry factors
+     * @param shell_fluid Shell-side fluid properties and mass flow
+     * @return Ideal coefficient, correction factors and corrected coefficient
+     */
+    ShellSideResults rate(const FluidProperties& shell_fluid) const;
+
+    double crossflowArea() const { return crossflow_area; }
+    double windowArea() const { return window_area; }
+    int numberOfBaffles() const { return num_baffles; }
+    int numberOfCompartments() const { return num_baffles + 1; }
+
+private:
+    GeometryProperties geometry;
+    BaffleConfiguration config;
+
+    // Cached geometry-only quantities
+    double tube_outer_diameter;
+    double tube_pitch;
+    double crossflow_area;          // S_m
+    double window_area;             // S_w
+    double window_fraction;         // F_w
+    double crossflow_fraction;      // F_c
+    double tube_rows_crossflow;     // N_c
+    double tube_rows_window;        // N_cw
+    int num_baffles;                // N_b
+    double J_c;
+    double J_l;
+    double J_b_laminar;             // C_bh = 1.35 (Re < 100)
+    double J_b_turbulent;           // C_bh = 1.25
+    double J_s_laminar;
+    double J_s_turbulent;
+    double J_r_laminar_limit;       // J_r for Re <= 20
+    double pitch_factor;            // 1.33 / (Pt / Do)
+    int layout_table;               // 0 = 30/60 deg, 1 = 45 deg, 2 = 90 deg
+};
+
+#endif // SHELL_SIDE_MODEL_H
@@ -0,0 +1,387 @@
+#include "solver_variants.h"
+#include "dimensionless_numbers.h"
+#include "heat_exchanger_geometry.h"
+#include "thermal_calculations.h"
+#include "parallel_utils.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace SolverVariants {
+
+    namespace {
+        using namespace Policies;
+
+        // Regime buckets; the boundaries follow getTubeSideNusselt() and getShellSideNusselt()
+        enum TubeRegime { TUBE_LAMINAR, TUBE_DITTUS_BOELTER, TUBE_GNIELINSKI, TUBE_POWER_LAW, TUBE_REGIMES };
+        enum ShellRegime { SHELL_LAMINAR, SHELL_TURBULENT, SHELL_REGIMES };
+
+        struct Bucket {
+            const RatingJob& job;
+            const std::vector<OperatingPoint>& points;
+            const long long* indices;                  // nullptr = every point
+            long long count;
+            std::vector<Rating>& ratings;
+            const StreamProperties<double>* hot_cache; // Table jobs
+            const StreamProperties<double>* cold_cache;
+
+            long long point(long long i) const { return indices ? indices[i] : i; }
+        };
+
+        int tubeRegime(const RatingJob& job, double reynolds) {
+            if (reynolds <= 2300) {
+                return TUBE_LAMINAR;
+            }
+            if (job.correlations) {
+                return TUBE_POWER_LAW;
+            }
+            return (reynolds > 10000 && reynolds <= 5e6) ? TUBE_GNIELINSKI : TUBE_DITTUS_BOELTER;
+        }
+
+        int shellRegime(double reynolds) {
+            return (reynolds < 2000) ? SHELL_LAMINAR : SHELL_TURBULENT;
+        }
+
+        void validate(const RatingJob& job) {
+            if (job.arrangement == Arrangement::SegmentMarch && job.segments < 1) {
+                throw std::invalid_argument("Number of segments must be at least 1");
+            }
+            if (job.property_model == PropertyModel::Table &&
+                (!job.database || job.hot_fluid < 0 || job.cold_fluid < 0 ||
+                 job.hot_fluid >= job.database->fluidCount() || job.cold_fluid >= job.database->fluidCount())) {
+                throw std::invalid_argument("Table property model needs an open database and valid fluid indices");
+            }
+        }
+
+        FluidProperties streamProperties(const RatingJob& job, bool hot_side, double inlet, double flow) {
+            FluidProperties fluid;
+            if (job.property_model == PropertyModel::Table) {
+                fluid = job.database->properties(hot_side ? job.hot_fluid : job.cold_fluid, inlet);
+            } else {
+                fluid = hot_side ? job.hot : job.cold;
+            }
+            fluid.inlet_temp = inlet;
+            fluid.mass_flow = flow;
+            return fluid;
+        }
+
+        // Smallest and largest viscosity over a temperature interval (log-linear between table nodes)
+        void viscosityRange(const RatingJob& job, bool hot_side, double T_low, double T_high,
+                            double& mu_low, double& mu_high) {
+            if (job.property_model == PropertyModel::Constant) {
+                mu_low = mu_high = hot_side ? job.hot.viscosity : job.cold.viscosity;
+                return;
+            }
+            int fluid = hot_side ? job.hot_fluid : job.cold_fluid;
+            double mu_a = job.database->properties(fluid, T_low).viscosity;
+            double mu_b = job.database->properties(fluid, T_high).viscosity;
+            mu_low = std::min(mu_a, mu_b);
+            mu_high = std::max(mu_a, mu_b);
+            FluidDatabase::PropertyTable view = job.database->table(fluid);
+            for (int i = 0; i < view.points; ++i) {
+                if (view.temperature[i] > T_low && view.temperature[i] < T_high) {
+                    mu_low = std::min(mu_low, view.viscosity[i]);
+                    mu_high = std::max(mu_high, view.viscosity[i]);
+                }
+            }
+        }
+
+        // One non-template thread fan-out shared by every kernel keeps the instantiations small
+        void forEachBlock(const Bucket& bucket, const std::function<void(long long, long long)>& block) {
+            ParallelUtils::parallelForBlocks(0, bucket.count, bucket.job.num_threads, block, 1024);
+        }
+
+        template <typename A, typename T, typename S, typename P, typename Real>
+        void runKernel(const Bucket& bucket, const A& arrangement, const T& tube, const S& shell, const P& properties) {
+            SpecializedSolver<A, T, S, P, Real> solver(bucket.job.geometry, arrangement, tube, shell, properties);
+            forEachBlock(bucket, [&](long long begin, long long end) {
+                for (long long i = begin; i < end; ++i) {
+                    long long point = bucket.point(i);
+                    bucket.ratings[point] = solver.rate(bucket.points[point], point);
+                }
+            });
+        }
+
+        template <typename A, typename T, typename S>
+        void dispatchProperties(const Bucket& bucket, const A& arrangement, const T& tube, const S& shell) {
+            const RatingJob& job = bucket.job;
+            if (job.property_model == PropertyModel::Table && !bucket.hot_cache) {
+                TableProperties properties{job.database->table(job.hot_fluid), job.database->table(job.cold_fluid)};
+                if (job.scalar == Scalar::Single) {
+                    runKernel<A, T, S, TableProperties, float>(bucket, arrangement, tube, shell, properties);
+                } else {
+                    runKernel<A, T, S, TableProperties, double>(bucket, arrangement, tube, shell, properties);
+                }
+            } else if (job.property_model == PropertyModel::Table) {
+                CachedProperties properties{bucket.hot_cache, bucket.cold_cache};
+                if (job.scalar == Scalar::Single) {
+                    runKernel<A, T, S, CachedProperties, float>(bucket, arrangement, tube, shell, properties);
+                } else {
+                    runKernel<A, T, S, CachedProperties, double>(bucket, arrangement, tube, shell, properties);
+                }
+            } else {
+                ConstantProperties properties{job.hot, job.cold};
+                if (job.scalar == Scalar::Single) {
+                    runKernel<A, T, S, ConstantProperties, float>(bucket, arrangement, tube, shell, properties);
+                } else {
+                    runKernel<A, T, S, ConstantProperties, double>(bucket, arrangement, tube, shell, properties);
+                }
+            }
+        }
+
+        template <typename A, typename T>
+        void dispatchShell(const Bucket& bucket, int shell_regime, const A& arrangement, const T& tube) {
+            const RatingJob& job = bucket.job;
+            if (shell_regime == SHELL_LAMINAR) {
+                dispatchProperties(bucket, arrangement, tube, ShellLaminar());
+            } else if (job.correlations) {
+                dispatchProperties(bucket, arrangement, tube, ShellPowerLaw{job.correlations->shell});
+            } else if (job.shell_tube_arrangement == 0) {
+                dispatchProperties(bucket, arrangement, tube, ShellInline());
+            } else {
+                dispatchProperties(bucket, arrangement, tube, ShellStaggered());
+            }
+        }
+
+        template <typename A>
+        void dispatchTube(const Bucket& bucket, int tube_regime, int shell_regime, const A& arrangement) {
+            switch (tube_regime) {
+                case TUBE_LAMINAR:
+                    dispatchShell(bucket, shell_regime, arrangement, TubeLaminar());
+                    break;
+                case TUBE_DITTUS_BOELTER:
+                    dispatchShell(bucket, shell_regime, arrangement, TubeDittusBoelter());
+                    break;
+                case TUBE_GNIELINSKI:
+                    dispatchShell(bucket, shell_regime, arrangement, TubeGnielinski());
+                    break;
+                default:
+                    dispatchShell(bucket, shell_regime, arrangement, TubePowerLaw{bucket.job.correlations->tube});
+                    break;
+            }
+        }
+
+        void dispatchArrangement(const Bucket& bucket, int tube_regime, int shell_regime) {
+            switch (bucket.job.arrangement) {
+                case Arrangement::SegmentMarch:
+                    dispatchTube(bucket, tube_regime, shell_regime, SegmentMarch{bucket.job.segments});
+                    break;
+                case Arrangement::CounterFlow:
+                    dispatchTube(bucket, tube_regime, shell_regime, CounterFlow());
+                    break;
+                case Arrangement::ParallelFlow:
+                    dispatchTube(bucket, tube_regime, shell_regime, ParallelFlow());
+                    break;
+                case Arrangement::ShellAndTube1_2N:
+                    dispatchTube(bucket, tube_regime, shell_regime, ShellAndTube1_2N());
+                    break;
+            }
+        }
+
+        // Reynolds numbers exactly as NumericalSolver::calculateCoefficients() forms them
+        void reynoldsNumbers(const RatingJob& job, const FluidProperties& hot, const FluidProperties& cold,
+                             double& hot_reynolds, double& cold_reynolds) {
+            const GeometryProperties& g = job.geometry;
+            double tube_flow_area = HeatExchangerGeometry::tubeArea(g.tube_diameter) * g.num_tubes;
+            double shell_flow_area = HeatExchangerGeometry::shellFlowArea(
+                g.shell_diameter, g.tube_diameter + 2 * g.tube_thickness, g.num_tubes);
+            cold_reynolds = DimensionlessNumbers::calculateReynolds(
+                cold.mass_flow / (cold.density * tube_flow_area), g.tube_diameter, cold.density, cold.viscosity);
+            hot_reynolds = DimensionlessNumbers::calculateReynolds(
+                hot.mass_flow / (hot.density * shell_flow_area), g.shell_diameter, hot.density, hot.viscosity);
+        }
+
+        Rating genericRating(const RatingJob& job, const OperatingPoint& point) {
+            const GeometryProperties& g = job.geometry;
+            FluidProperties hot = streamProperties(job, true, point.hot_inlet, point.hot_flow);
+            FluidProperties cold = streamProperties(job, false, point.cold_inlet, point.cold_flow);
+
+            double hot_reynolds, cold_reynolds;
+            reynoldsNumbers(job, hot, cold, hot_reynolds, cold_reynolds);
+            double cold_nusselt, hot_nusselt;
+            if (job.correlations) {
+                cold_nusselt = HeatTransferCorrelations::getTubeSideNusselt(cold_reynolds, cold.prandtl, job.correlations->tube);
+                hot_nusselt = HeatTransferCorrelations::getShellSideNusselt(hot_reynolds, hot.prandtl, job.correlations->shell);
+            } else {
+                cold_nusselt = HeatTransferCorrelations::getTubeSideNusselt(cold_reynolds, cold.prandtl, true);
+                hot_nusselt = HeatTransferCorrelations::getShellSideNusselt(hot_reynolds, hot.prandtl,
+                                                                            job.shell_tube_arrangement);
+            }
+            double cold_htc = cold_nusselt * cold.thermal_cond / g.tube_diameter;
+            double hot_htc = hot_nusselt * hot.thermal_cond / g.shell_diameter;
+            double inner_radius = g.tube_diameter / 2.0;
+            double overall_htc = ThermalCalculations::overallHTC(cold_htc, hot_htc, inner_radius,
+                                                                 inner_radius + g.tube_thickness, g.wall_thermal_cond);
+
+            double UA = overall_htc * HeatExchangerGeometry::totalTubeArea(g.tube_diameter, g.length, g.num_tubes);
+            double C_hot = ThermalCalculations::heatCapacityRate(hot.mass_flow, hot.specific_heat);
+            double C_cold = ThermalCalculations::heatCapacityRate(cold.mass_flow, cold.specific_heat);
+
+            Rating rating;
+            rating.overall_htc = overall_htc;
+            if (job.arrangement == Arrangement::SegmentMarch) {
+                Outlets<double> out = SegmentMarch{job.segments}.outlets<double>(UA, C_hot, C_cold, hot.inlet_temp,
+                                                                                 cold.inlet_temp);
+                rating.hot_outlet = out.hot_outlet;
+                rating.cold_outlet = out.cold_outlet;
+                rating.duty = out.duty;
+                return rating;
+            }
+
+            int flow_type = 0;
+            switch (job.arrangement) {
+                case Arrangement::ParallelFlow:     flow_type = 1; break;
+                case Arrangement::ShellAndTube1_2N: flow_type = 3; break;
+                default:                            flow_type = 0; break;
+            }
+            double C_min = std::min(C_hot, C_cold);
+            double C_ratio = C_min / std::max(C_hot, C_cold);
+            double eff = ThermalCalculations::effectiveness_NTU(ThermalCalculations::calculateNTU(UA, C_min), C_ratio, flow_type);
+            rating.duty = eff * ThermalCalculations::maximumHeatTransfer(C_min, hot.inlet_temp, cold.inlet_temp);
+            rating.hot_outlet = hot.inlet_temp - rating.duty / C_hot;
+            rating.cold_outlet = cold.inlet_temp + rating.duty / C_cold;
+            return rating;
+        }
+    }
+
+    RatingJob::RatingJob()
+        : geometry(), arrangement(Arrangement::SegmentMarch), segments(100), shell_tube_arrangement(1),
+          property_model(PropertyModel::Constant), hot(), cold(), database(nullptr), hot_fluid(-1), cold_fluid(-1),
+          scalar(Scalar::Double), num_threads(0) {}
+
+    JobResults rate(const RatingJob& job, const std::vector<OperatingPoint>& points) {
+        validate(job);
+        auto start = std::chrono::steady_clock::now();
+        long long n = static_cast<long long>(points.size());
+
+        JobResults results;
+        results.ratings.assign(points.size(), Rating());
+        results.variants_used = 0;
+        results.bucketed = false;
+        if (n == 0) {
+            results.elapsed_seconds = 0.0;
+            return results;
+        }
+
+        const GeometryProperties& g = job.geometry;
+        double tube_area = HeatExchangerGeometry::tubeArea(g.tube_diameter) * g.num_tubes;
+        double shell_area = HeatExchangerGeometry::shellFlowArea(
+            g.shell_diameter, g.tube_diameter + 2 * g.tube_thickness, g.num_tubes);
+        bool table = job.property_model == PropertyModel::Table;
+
+        // Reynolds bounds (Re = m d / (A mu)) decide whether one kernel covers the whole job
+        double hot_flow_min = HUGE_VAL, hot_flow_max = 0.0, cold_flow_min = HUGE_VAL, cold_flow_max = 0.0;
+        double hot_T_min = HUGE_VAL, hot_T_max = -HUGE_VAL, cold_T_min = HUGE_VAL, cold_T_max = -HUGE_VAL;
+        for (const OperatingPoint& point : points) {
+            hot_flow_min = std::min(hot_flow_min, point.hot_flow);
+            hot_flow_max = std::max(hot_flow_max, point.hot_flow);
+            cold_flow_min = std::min(cold_flow_min, point.cold_flow);
+            cold_flow_max = std::max(cold_flow_max, point.cold_flow);
+            hot_T_min = std::min(hot_T_min, point.hot_inlet);
+            hot_T_max = std::max(hot_T_max, point.hot_inlet);
+            cold_T_min = std::min(cold_T_min, point.cold_inlet);
+            cold_T_max = std::max(cold_T_max, point.cold_inlet);
+        }
+        double hot_mu_low, hot_mu_high, cold_mu_low, cold_mu_high;
+        viscosityRange(job, true, hot_T_min, hot_T_max, hot_mu_low, hot_mu_high);
+        viscosityRange(job, false, cold_T_min, cold_T_max, cold_mu_low, cold_mu_high);
+        const double margin = 1e-9;     // Leaves points within rounding of a boundary to the per-point pass
+        double tube_scale = g.tube_diameter / tube_area;
+        double shell_scale = g.shell_diameter / shell_area;
+        double tube_re_low = (1.0 - margin) * cold_flow_min * tube_scale / cold_mu_high;
+        double tube_re_high = (1.0 + margin) * cold_flow_max * tube_scale / cold_mu_low;
+        int tube_low = tubeRegime(job, tube_re_low);
+        int shell_low = shellRegime((1.0 - margin) * hot_flow_min * shell_scale / hot_mu_high);
+        // Dittus-Boelter applies on both sides of the Gnielinski band, so equal end regimes are not enough
+        bool one_tube_regime = tube_low == tubeRegime(job, tube_re_high) &&
+                               !(tube_low == TUBE_DITTUS_BOELTER && tube_re_low <= 10000 && tube_re_high > 10000);
+        bool one_shell_regime = shell_low == shellRegime((1.0 + margin) * hot_flow_max * shell_scale / hot_mu_low);
+        if (one_tube_regime && one_shell_regime) {
+            results.variants_used = 1;
+            dispatchArrangement(Bucket{job, points, nullptr, n, results.ratings, nullptr, nullptr},
+                                tube_low, shell_low);
+            results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return results;
+        }
+
+        // Classify each point (and for table jobs keep its properties for the kernels)
+        results.bucketed = true;
+        std::vector<unsigned char> bucket_of(n);
+        std::vector<StreamProperties<double>> hot_cache(table ? n : 0), cold_cache(table ? n : 0);
+        TableProperties tables{};
+        if (table) {
+            tables = {job.database->table(job.hot_fluid), job.database->table(job.cold_fluid)};
+        }
+        ParallelUtils::parallelForBlocks(0, n, job.num_threads, [&](long long begin, long long end) {
+            StreamProperties<double> hot = ConstantProperties::convert<double>(job.hot);
+            StreamProperties<double> cold = ConstantProperties::convert<double>(job.cold);
+            for (long long i = begin; i < end; ++i) {
+                const OperatingPoint& point = points[i];
+                if (table) {
+                    hot = hot_cache[i] = tables.hot<double>(i, point.hot_inlet);
+                    cold = cold_cache[i] = tables.cold<double>(i, point.cold_inlet);
+                }
+                // Same operation order as calculateCoefficients(), so boundary points land in the same regime
+                double cold_reynolds = DimensionlessNumbers::calculateReynolds(
+                    point.cold_flow / (cold.density * tube_area), g.tube_diameter, cold.density, cold.viscosity);
+                double hot_reynolds = DimensionlessNumbers::calculateReynolds(
+                    point.hot_flow / (hot.density * shell_area), g.shell_diameter, hot.density, hot.viscosity);
+                bucket_of[i] = static_cast<unsigned char>(tubeRegime(job, cold_reynolds) * SHELL_REGIMES +
+                                                          shellRegime(hot_reynolds));
+            }
+        }, 4096);
+
+        // Counting sort of the point indices by bucket
+        const int bucket_count = TUBE_REGIMES * SHELL_REGIMES;
+        std::vector<long long> offsets(bucket_count + 1, 0);
+        for (long long i = 0; i < n; ++i) {
+            ++offsets[bucket_of[i] + 1];
+        }
+        for (int b = 0; b < bucket_count; ++b) {
+            offsets[b + 1] += offsets[b];
+        }
+        std::vector<long long> order(n);
+        std::vector<long long> fill(offsets.begin(), offsets.end() - 1);
+        for (long long i = 0; i < n; ++i) {
+            order[fill[bucket_of[i]]++] = i;
+        }
+
+        for (int b = 0; b < bucket_count; ++b) {
+            if (offsets[b] == offsets[b + 1]) {
+                continue;
+            }
+            ++results.variants_used;
+            Bucket bucket{job, points, order.data() + offsets[b], offsets[b + 1] - offsets[b], results.ratings,
+                          hot_cache.data(), cold_cache.data()};
+            // A single bucket covering the job needs no index indirection
+            if (bucket.count == n) {
+                bucket.indices = nullptr;
+            }
+            dispatchArrangement(bucket, b / SHELL_REGIMES, b % SHELL_REGIMES);
+        }
+
+        results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return results;
+    }
+
+    JobResults rateGeneric(const RatingJob& job, const std::vector<OperatingPoint>& points) {
+        validate(job);
+        auto start = std::chrono::steady_clock::now();
+
+        JobResults results;
+        results.ratings.assign(points.size(), Rating());
+        results.variants_used = 0;
+        results.bucketed = false;
+        ParallelUtils::parallelForBlocks(0, static_cast<long long>(points.size()), job.num_threads,
+            [&](long long begin, long long end) {
+                for (long long i = begin; i < end; ++i) {
+                    results.ratings[i] = genericRating(job, points[i]);
+                }
+            }, 1024);
+
+        results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return results;
+    }
+
+} // namespace SolverVariants
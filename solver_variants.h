@@ -0,0 +1,398 @@
+#ifndef SOLVER_VARIANTS_H
+#define SOLVER_VARIANTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "fluid_properties.h"
+#include "fluid_database.h"
+#include "heat_transfer_correlations.h"
+
+/**
+ * @file solver_variants.h
+ * @brief Rating kernels specialised at compile time on flow arrangement, correlations,
+ *        property model and scalar type
+ *
+ * NumericalSolver and the correlation functions choose the regime, the
+ * bundle arrangement, the property source and the ε-NTU formula at runtime,
+ * on every evaluation. SpecializedSolver takes each of these choices as a
+ * policy template parameter, so one instantiation compiles to a
+ * straight-line kernel with the correlation constants folded in.
+ *
+ * SolverVariants::rate() makes the runtime choices once per job. If the
+ * job's flow and viscosity bounds keep both Reynolds numbers inside one
+ * regime, a single kernel with fixed-regime correlations rates every point.
+ * Otherwise the points are bucketed by regime first. Table jobs look up each
+ * point's properties once during this pass, and the kernels read them from a
+ * cache. Either way no kernel contains a regime branch. rateGeneric() is the runtime-dispatched
+ * reference and gives the same results in double precision.
+ */
+
+namespace SolverVariants {
+
+    enum class Arrangement {
+        SegmentMarch,       // Segment recurrence of NumericalSolver::solveTemperatureDistributionScan()
+        CounterFlow,        // ε-NTU, counter-current
+        ParallelFlow,       // ε-NTU, co-current
+        ShellAndTube1_2N    // ε-NTU, one shell pass and 2N tube passes
+    };
+
+    enum class PropertyModel {
+        Constant,           // RatingJob::hot / cold properties for every point
+        Table               // FluidDatabase tables at each stream's inlet temperature
+    };
+
+    enum class Scalar { Double, Single };
+
+    struct RatingJob {
+        GeometryProperties geometry;
+        Arrangement arrangement;
+        int segments;                       // SegmentMarch only
+        int shell_tube_arrangement;         // Built-in bundle correlation: 0 = inline, 1 = staggered
+        PropertyModel property_model;
+        FluidProperties hot;                // Constant model (shell side)
+        FluidProperties cold;               // Constant model (tube side)
+        const FluidDatabase* database;      // Table model
+        int hot_fluid;
+        int cold_fluid;
+        std::shared_ptr<const HeatTransferCorrelations::CorrelationSet> correlations;  // Optional fitted turbulent coefficients
+        Scalar scalar;
+        int num_threads;                    // 0 = hardware concurrency
+
+        RatingJob();
+    };
+
+    struct OperatingPoint {
+        double hot_inlet;       // K
+        double cold_inlet;      // K
+        double hot_flow;        // kg/s
+        double cold_flow;       // kg/s
+    };
+
+    struct Rating {
+        double hot_outlet;      // K
+        double cold_outlet;     // K
+        double duty;            // W
+        double overall_htc;     // W/m²·K
+    };
+
+    struct JobResults {
+        std::vector<Rating> ratings;    // One per operating point, in input order
+        int variants_used;              // Distinct kernels run (regime buckets)
+        bool bucketed;                  // Points were classified one by one (job straddles a regime boundary)
+        double elapsed_seconds;
+    };
+
+    namespace Policies {
+
+        template <typename Real>
+        struct StreamProperties {
+            Real density, specific_heat, thermal_cond, viscosity, prandtl;
+        };
+
+        // Property models -------------------------------------------------------
+
+        struct ConstantProperties {
+            static constexpr bool constant = true;     // Lets the kernel fold Prandtl terms at construction
+            FluidProperties hot_fluid, cold_fluid;
+
+            template <typename Real>
+            static StreamProperties<Real> convert(const FluidProperties& f) {
+                return {Real(f.density), Real(f.specific_heat), Real(f.thermal_cond), Real(f.viscosity), Real(f.prandtl)};
+            }
+            template <typename Real>
+            StreamProperties<Real> hot(long long, double) const { return convert<Real>(hot_fluid); }
+            template <typename Real>
+            StreamProperties<Real> cold(long long, double) const { return convert<Real>(cold_fluid); }
+        };
+
+        struct TableProperties {
+            static constexpr bool constant = false;
+            FluidDatabase::PropertyTable hot_table, cold_table;
+
+            // Same interpolation as FluidDatabase::properties()
+            template <typename Real>
+            static StreamProperties<Real> lookup(const FluidDatabase::PropertyTable& view, double temperature) {
+                const double* T = view.temperature;
+                double clamped = std::max(T[0], std::min(T[view.points - 1], temperature));
+                int i = static_cast<int>(std::upper_bound(T, T + view.points, clamped) - T) - 1;
+                i = std::max(0, std::min(view.points - 2, i));
+                double f = (clamped - T[i]) / (T[i + 1] - T[i]);
+                double density = view.density[i] + f * (view.density[i + 1] - view.density[i]);
+                double cp = view.specific_heat[i] + f * (view.specific_heat[i + 1] - view.specific_heat[i]);
+                double k = view.thermal_cond[i] + f * (view.thermal_cond[i + 1] - view.thermal_cond[i]);
+                double mu = std::exp(view.log_viscosity[i] + f * (view.log_viscosity[i + 1] - view.log_viscosity[i]));
+                return {Real(density), Real(cp), Real(k), Real(mu), Real((cp * mu) / k)};
+            }
+            template <typename Real>
+            StreamProperties<Real> hot(long long, double temperature) const { return lookup<Real>(hot_table, temperature); }
+            template <typename Real>
+            StreamProperties<Real> cold(long long, double temperature) const { return lookup<Real>(cold_table, temperature); }
+        };
+
+        // Properties evaluated beforehand, one entry per operating point (used by rate() for table jobs)
+        struct CachedProperties {
+            static constexpr bool constant = false;
+            const StreamProperties<double>* hot_cache;
+            const StreamProperties<double>* cold_cache;
+
+            template <typename Real>
+            static StreamProperties<Real> convert(const StreamProperties<double>& p) {
+                return {Real(p.density), Real(p.specific_heat), Real(p.thermal_cond), Real(p.viscosity), Real(p.prandtl)};
+            }
+            template <typename Real>
+            StreamProperties<Real> hot(long long index, double) const { return convert<Real>(hot_cache[index]); }
+            template <typename Real>
+            StreamProperties<Real> cold(long long index, double) const { return convert<Real>(cold_cache[index]); }
+        };
+
+        /**
+         * Correlations are split into a Prandtl part, computed once per job when the
+         * properties are constant, and a Reynolds part evaluated per point
+         */
+        template <typename Real>
+        struct PrandtlTerms {
+            Real prandtl;
+            Real power;         // Pr^n of the correlation
+        };
+
+        // Tube-side correlations (one regime each) ------------------------------
+
+        struct TubeLaminar {
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const { return {prandtl, Real(1)}; }
+            template <typename Real>
+            Real nusselt(Real, const PrandtlTerms<Real>&) const { return Real(3.66); }
+        };
+
+        struct TubeDittusBoelter {     // Heating exponent, as used by NumericalSolver
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const { return {prandtl, std::pow(prandtl, Real(0.4))}; }
+            template <typename Real>
+            Real nusselt(Real reynolds, const PrandtlTerms<Real>& pr) const {
+                return Real(0.023) * std::pow(reynolds, Real(0.8)) * pr.power;
+            }
+        };
+
+        struct TubeGnielinski {
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const {
+                return {prandtl, std::pow(prandtl, Real(2.0 / 3.0)) - Real(1)};
+            }
+            template <typename Real>
+            Real nusselt(Real reynolds, const PrandtlTerms<Real>& pr) const {
+                Real root = Real(0.79) * std::log(reynolds) - Real(1.64);
+                Real f = Real(1) / (root * root);
+                return (f / Real(8)) * (reynolds - Real(1000)) * pr.prandtl /
+                       (Real(1) + Real(12.7) * std::sqrt(f / Real(8)) * pr.power);
+            }
+        };
+
+        struct TubePowerLaw {
+            HeatTransferCorrelations::PowerLawCoefficients coefficients;
+
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const {
+                return {prandtl, std::pow(prandtl, Real(coefficients.n))};
+            }
+            template <typename Real>
+            Real nusselt(Real reynolds, const PrandtlTerms<Real>& pr) const {
+                return Real(coefficients.C) * std::pow(reynolds, Real(coefficients.m)) * pr.power;
+            }
+        };
+
+        // Shell-side correlations (one regime each) -----------------------------
+
+        struct ShellLaminar {
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const { return {prandtl, std::cbrt(prandtl)}; }
+            template <typename Real>
+            Real nusselt(Real reynolds, const PrandtlTerms<Real>& pr) const {
+                return Real(0.664) * std::sqrt(reynolds) * pr.power;
+            }
+        };
+
+        struct ShellStaggered {
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const { return {prandtl, std::pow(prandtl, Real(0.36))}; }
+            template <typename Real>
+            Real nusselt(Real reynolds, const PrandtlTerms<Real>& pr) const {
+                return Real(0.36) * std::pow(reynolds, Real(0.55)) * pr.power;
+            }
+        };
+
+        struct ShellInline {
+            template <typename Real>
+            PrandtlTerms<Real> prandtlTerms(Real prandtl) const { return {prandtl, std::pow(prandtl, Real(0.36))}; }
+            template <typename Real>
+            Real nusselt(Real reynolds, const PrandtlTerms<Real>& pr) const {
+                return Real(0.27) * std::pow(reynolds, Real(0.63)) * pr.power;
+            }
+        };
+
+        using ShellPowerLaw = TubePowerLaw;
+
+        // Flow arrangements -----------------------------------------------------
+        // Written with expm1 / log1p so that float keeps its accuracy at small NTU and C_r near one
+
+        template <typename Real>
+        struct Outlets {
+            Real hot_outlet, cold_outlet, duty;
+        };
+
+        /**
+         * The segment recurrence has the same map on every segment with rows summing
+         * to one, so the hot-cold difference decays geometrically and the N-segment
+         * march has a closed form (identical to marching, up to rounding).
+         */
+        struct SegmentMarch {
+            int segments;
+
+            template <typename Real>
+            Outlets<Real> outlets(Real UA, Real C_hot, Real C_cold, Real hot_inlet, Real cold_inlet) const {
+                Real a = UA / (Real(segments) * C_hot);
+                Real b = UA / (Real(segments) * C_cold);
+                Real det = Real(1) - a * b / Real(4);
+                Real p = (a / Real(2) + (a / Real(2)) * (Real(1) - b)) / det;
+                Real q = ((b / Real(2)) * (Real(1) - a) + b / Real(2)) / det;
+                // 1 - (1 - p - q)^N
+                Real decay = -std::expm1(Real(segments) * std::log1p(-(p + q)));
+                Real sum = (hot_inlet - cold_inlet) * decay / (p + q);
+                return {hot_inlet - p * sum, cold_inlet + q * sum, C_hot * p * sum};
+            }
+        };
+
+        template <typename Derived>
+        struct EffectivenessArrangement {
+            template <typename Real>
+            Outlets<Real> outlets(Real UA, Real C_hot, Real C_cold, Real hot_inlet, Real cold_inlet) const {
+                Real C_min = std::min(C_hot, C_cold);
+                Real C_ratio = C_min / std::max(C_hot, C_cold);
+                Real duty = Derived::effectiveness(UA / C_min, C_ratio) * C_min * (hot_inlet - cold_inlet);
+                return {hot_inlet - duty / C_hot, cold_inlet + duty / C_cold, duty};
+            }
+        };
+
+        struct CounterFlow : EffectivenessArrangement<CounterFlow> {
+            template <typename Real>
+            static Real effectiveness(Real ntu, Real C_ratio) {
+                // (1 - e) / (1 - C_r e) with e = exp(-NTU (1 - C_r)); tends to NTU / (1 + NTU) as C_r -> 1
+                Real one_minus_e = -std::expm1(-ntu * (Real(1) - C_ratio));
+                Real denominator = (Real(1) - C_ratio) + C_ratio * one_minus_e;
+                return (denominator > Real(0)) ? one_minus_e / denominator : ntu / (Real(1) + ntu);
+            }
+        };
+
+        struct ParallelFlow : EffectivenessArrangement<ParallelFlow> {
+            template <typename Real>
+            static Real effectiveness(Real ntu, Real C_ratio) {
+                return -std::expm1(-ntu * (Real(1) + C_ratio)) / (Real(1) + C_ratio);
+            }
+        };
+
+        struct ShellAndTube1_2N : EffectivenessArrangement<ShellAndTube1_2N> {
+            template <typename Real>
+            static Real effectiveness(Real ntu, Real C_ratio) {
+                Real root = std::sqrt(Real(1) + C_ratio * C_ratio);
+                Real one_minus_e = -std::expm1(-ntu * root);
+                return Real(2) / (Real(1) + C_ratio + root * (Real(2) - one_minus_e) / one_minus_e);
+            }
+        };
+
+    } // namespace Policies
+
+    /**
+     * Rating kernel with every modelling choice fixed at compile time. The
+     * geometry terms are computed once at construction.
+     */
+    template <typename ArrangementPolicy, typename TubePolicy, typename ShellPolicy,
+              typename PropertyPolicy, typename Real>
+    class SpecializedSolver {
+    public:
+        SpecializedSolver(const GeometryProperties& geometry, const ArrangementPolicy& arrangement,
+                          const TubePolicy& tube, const ShellPolicy& shell, const PropertyPolicy& properties)
+            : arrangement(arrangement), tube(tube), shell(shell), properties(properties) {
+            const double pi = 3.14159265358979323846;
+            double inner_radius = geometry.tube_diameter / 2.0;
+            double outer_radius = inner_radius + geometry.tube_thickness;
+            double outer_diameter = geometry.tube_diameter + 2 * geometry.tube_thickness;
+            tube_diameter = Real(geometry.tube_diameter);
+            shell_diameter = Real(geometry.shell_diameter);
+            tube_flow_area = Real(pi * std::pow(geometry.tube_diameter / 2.0, 2) * geometry.num_tubes);
+            shell_flow_area = Real(pi * std::pow(geometry.shell_diameter / 2.0, 2) -
+                                   geometry.num_tubes * pi * std::pow(outer_diameter / 2.0, 2));
+            wall_resistance = Real(inner_radius * std::log(outer_radius / inner_radius) / geometry.wall_thermal_cond);
+            radius_ratio = Real(inner_radius / outer_radius);
+            area = Real(pi * geometry.tube_diameter * geometry.length * geometry.num_tubes);
+            if constexpr (PropertyPolicy::constant) {
+                tube_prandtl = tube.template prandtlTerms<Real>(properties.template cold<Real>(0, 0.0).prandtl);
+                shell_prandtl = shell.template prandtlTerms<Real>(properties.template hot<Real>(0, 0.0).prandtl);
+            }
+        }
+
+        /**
+         * Rate one operating point
+         * @param point Inlet temperatures and flows
+         * @param index Position of the point in its job (read by CachedProperties only)
+         * @return Outlets, duty and overall coefficient
+         */
+        Rating rate(const OperatingPoint& point, long long index = 0) const {
+            Policies::StreamProperties<Real> hot = properties.template hot<Real>(index, point.hot_inlet);
+            Policies::StreamProperties<Real> cold = properties.template cold<Real>(index, point.cold_inlet);
+
+            Real cold_velocity = Real(point.cold_flow) / (cold.density * tube_flow_area);
+            Real hot_velocity = Real(point.hot_flow) / (hot.density * shell_flow_area);
+            Real cold_reynolds = cold.density * cold_velocity * tube_diameter / cold.viscosity;
+            Real hot_reynolds = hot.density * hot_velocity * shell_diameter / hot.viscosity;
+
+            Policies::PrandtlTerms<Real> cold_pr, hot_pr;
+            if constexpr (PropertyPolicy::constant) {
+                cold_pr = tube_prandtl;
+                hot_pr = shell_prandtl;
+            } else {
+                cold_pr = tube.template prandtlTerms<Real>(cold.prandtl);
+                hot_pr = shell.template prandtlTerms<Real>(hot.prandtl);
+            }
+            Real cold_htc = tube.template nusselt<Real>(cold_reynolds, cold_pr) * cold.thermal_cond / tube_diameter;
+            Real hot_htc = shell.template nusselt<Real>(hot_reynolds, hot_pr) * hot.thermal_cond / shell_diameter;
+            Real overall_htc = Real(1) / (Real(1) / cold_htc + wall_resistance + radius_ratio / hot_htc);
+
+            Policies::Outlets<Real> out = arrangement.template outlets<Real>(
+                overall_htc * area, Real(point.hot_flow) * hot.specific_heat, Real(point.cold_flow) * cold.specific_heat,
+                Real(point.hot_inlet), Real(point.cold_inlet));
+            return {double(out.hot_outlet), double(out.cold_outlet), double(out.duty), double(overall_htc)};
+        }
+
+    private:
+        ArrangementPolicy arrangement;
+        TubePolicy tube;
+        ShellPolicy shell;
+        PropertyPolicy properties;
+        Real tube_diameter, shell_diameter;
+        Real tube_flow_area, shell_flow_area;
+        Real wall_resistance, radius_ratio;
+        Real area;
+        Policies::PrandtlTerms<Real> tube_prandtl{}, shell_prandtl{};     // Constant property models only
+    };
+
+    /**
+     * Rate every point with specialised kernels, choosing them once per regime bucket
+     * @param job Geometry, arrangement, correlations, property model and scalar type
+     * @param points Operating points
+     * @return Ratings in input order
+     */
+    JobResults rate(const RatingJob& job, const std::vector<OperatingPoint>& points);
+
+    /**
+     * Reference path: every point goes through the runtime-dispatched correlation and
+     * ε-NTU functions in double precision
+     * @param job Job description (scalar type ignored)
+     * @param points Operating points
+     * @return Ratings in input order
+     */
+    JobResults rateGeneric(const RatingJob& job, const std::vector<OperatingPoint>& points);
+
+} // namespace SolverVariants
+
+#endif // SOLVER_VARIANTS_H
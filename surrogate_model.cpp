@@ -0,0 +1,442 @@
+#include "surrogate_model.h"
+#include "numerical_solver.h"
+#include "thermal_calculations.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+namespace {
+    const int MAX_DEGREE = 30;
+
+    // Reynolds numbers where getTubeSideNusselt / getShellSideNusselt switch correlation
+    const double TUBE_REGIME_SWITCHES[] = {2300.0, 10000.0, 5e6};
+    const double SHELL_REGIME_SWITCHES[] = {2000.0};
+
+    double radicalInverse(unsigned long long index, unsigned base) {
+        double inverse = 1.0 / base, fraction = inverse, result = 0.0;
+        while (index > 0) {
+            result += (index % base) * fraction;
+            index /= base;
+            fraction *= inverse;
+        }
+        return result;
+    }
+
+    void legendre(double x, int degree, double* values) {
+        values[0] = 1.0;
+        if (degree > 0) {
+            values[1] = x;
+        }
+        for (int n = 1; n < degree; ++n) {
+            values[n + 1] = ((2.0 * n + 1.0) * x * values[n] - n * values[n - 1]) / (n + 1.0);
+        }
+    }
+
+    // Map a flow to [-1, 1] on a log scale (Reynolds number is proportional to flow)
+    double scaleLog(double value, double low, double high) {
+        if (high <= low) {
+            return 0.0;
+        }
+        return 2.0 * (std::log(value) - std::log(low)) / (std::log(high) - std::log(low)) - 1.0;
+    }
+
+    // Least squares min |A c - b| by Householder QR; A is rows x cols, row-major
+    std::vector<double> leastSquares(std::vector<double> A, std::vector<double> b, int rows, int cols) {
+        for (int k = 0; k < cols; ++k) {
+            double norm = 0.0;
+            for (int i = k; i < rows; ++i) {
+                norm += A[i * cols + k] * A[i * cols + k];
+            }
+            norm = std::sqrt(norm);
+            if (norm == 0.0) {
+                continue;
+            }
+            double alpha = (A[k * cols + k] > 0) ? -norm : norm;
+            std::vector<double> v(rows - k);
+            for (int i = k; i < rows; ++i) {
+                v[i - k] = A[i * cols + k];
+            }
+            v[0] -= alpha;
+            double v_norm2 = 0.0;
+            for (double vi : v) {
+                v_norm2 += vi * vi;
+            }
+            if (v_norm2 == 0.0) {
+                continue;
+            }
+            for (int j = k; j < cols; ++j) {
+                double dot = 0.0;
+                for (int i = k; i < rows; ++i) {
+                    dot += v[i - k] * A[i * cols + j];
+                }
+                double factor = 2.0 * dot / v_norm2;
+                for (int i = k; i < rows; ++i) {
+                    A[i * cols + j] -= factor * v[i - k];
+                }
+            }
+            double dot = 0.0;
+            for (int i = k; i < rows; ++i) {
+                dot += v[i - k] * b[i];
+            }
+            double factor = 2.0 * dot / v_norm2;
+            for (int i = k; i < rows; ++i) {
+                b[i] -= factor * v[i - k];
+            }
+        }
+
+        std::vector<double> c(cols, 0.0);
+        for (int k = cols - 1; k >= 0; --k) {
+            double sum = b[k];
+            for (int j = k + 1; j < cols; ++j) {
+                sum -= A[k * cols + j] * c[j];
+            }
+            double diag = A[k * cols + k];
+            c[k] = (std::abs(diag) > 1e-300) ? sum / diag : 0.0;
+        }
+        return c;
+    }
+}
+
+SurrogateModel::TrainingSettings::TrainingSettings()
+    : degree(8), samples(600), validation_samples(300), segments(50), tube_passes(1),
+      drop_tolerance(1e-7), seed(1), num_threads(0) {}
+
+SurrogateModel::SurrogateModel()
+    : trained(false), envelope(), degree(0), segments(50), tube_passes(1), stats() {}
+
+bool SurrogateModel::inEnvelope(double hot_inlet, double cold_inlet, double hot_flow, double cold_flow) const {
+    return trained &&
+           hot_flow >= envelope.hot_flow_min && hot_flow <= envelope.hot_flow_max &&
+           cold_flow >= envelope.cold_flow_min && cold_flow <= envelope.cold_flow_max &&
+           hot_inlet >= envelope.hot_inlet_min && hot_inlet <= envelope.hot_inlet_max &&
+           cold_inlet >= envelope.cold_inlet_min && cold_inlet <= envelope.cold_inlet_max;
+}
+
+const SurrogateModel::Cell& SurrogateModel::cellFor(double hot_flow, double cold_flow) const {
+    int hot_cells = static_cast<int>(hot_breaks.size()) - 1;
+    int cold_cells = static_cast<int>(cold_breaks.size()) - 1;
+    int i = static_cast<int>(std::upper_bound(hot_breaks.begin() + 1, hot_breaks.end() - 1, hot_flow) -
+                             (hot_breaks.begin() + 1));
+    int j = static_cast<int>(std::upper_bound(cold_breaks.begin() + 1, cold_breaks.end() - 1, cold_flow) -
+                             (cold_breaks.begin() + 1));
+    return cells[std::min(i, hot_cells - 1) * cold_cells + std::min(j, cold_cells - 1)];
+}
+
+double SurrogateModel::temperatureEffectiveness(const Cell& cell, double hot_flow, double cold_flow) const {
+    double x = scaleLog(hot_flow, cell.hot_low, cell.hot_high);
+    double y = scaleLog(cold_flow, cell.cold_low, cell.cold_high);
+    double px[MAX_DEGREE + 1], py[MAX_DEGREE + 1];
+    legendre(x, degree, px);
+    legendre(y, degree, py);
+    double sum = 0.0;
+    for (size_t k = 0; k < cell.coefficients.size(); ++k) {
+        sum += cell.coefficients[k] * px[cell.exponent_hot[k]] * py[cell.exponent_cold[k]];
+    }
+    return sum;
+}
+
+SurrogateModel::Rating SurrogateModel::fullSolve(double hot_inlet, double cold_inlet,
+                                                 double hot_flow, double cold_flow) const {
+    FluidProperties hot = hot_template;
+    hot.inlet_temp = hot_inlet;
+    hot.mass_flow = hot_flow;
+    FluidProperties cold = cold_template;
+    cold.inlet_temp = cold_inlet;
+    cold.mass_flow = cold_flow;
+
+    NumericalSolver solver(segments, geometry, hot, cold);
+    NumericalSolver::MultiPassResults solution = solver.solveMultiPass(tube_passes);
+    return {solution.hot_outlet, solution.cold_outlet, solution.heat_duty, solution.effectiveness, 0.0, false};
+}
+
+SurrogateModel::Rating SurrogateModel::rate(double hot_inlet, double cold_inlet,
+                                            double hot_flow, double cold_flow) const {
+    if (!inEnvelope(hot_inlet, cold_inlet, hot_flow, cold_flow)) {
+        return fullSolve(hot_inlet, cold_inlet, hot_flow, cold_flow);
+    }
+
+    double C_hot = ThermalCalculations::heatCapacityRate(hot_flow, hot_template.specific_heat);
+    double C_cold = ThermalCalculations::heatCapacityRate(cold_flow, cold_template.specific_heat);
+    double C_min = std::min(C_hot, C_cold);
+    const Cell& cell = cellFor(hot_flow, cold_flow);
+
+    Rating rating;
+    double P = temperatureEffectiveness(cell, hot_flow, cold_flow);
+    rating.duty = P * C_hot * (hot_inlet - cold_inlet);
+    rating.effectiveness = rating.duty / ThermalCalculations::maximumHeatTransfer(C_min, hot_inlet, cold_inlet);
+    rating.hot_outlet = hot_inlet - rating.duty / C_hot;
+    rating.cold_outlet = cold_inlet + rating.duty / C_cold;
+    // An error δ in P moves the hot outlet by δ ΔT and the cold outlet by δ ΔT C_hot / C_cold
+    rating.error_estimate = cell.max_error * (hot_inlet - cold_inlet) * std::max(1.0, C_hot / C_cold);
+    rating.from_surrogate = true;
+    return rating;
+}
+
+SurrogateModel::Validation SurrogateModel::train(const GeometryProperties& geom, const FluidProperties& hot,
+                                                 const FluidProperties& cold, const Envelope& env,
+                                                 const TrainingSettings& settings) {
+    auto start = std::chrono::steady_clock::now();
+    geometry = geom;
+    hot_template = hot;
+    cold_template = cold;
+    envelope = env;
+    degree = std::max(0, std::min(MAX_DEGREE, settings.degree));
+    segments = settings.segments;
+    tube_passes = settings.tube_passes;
+    trained = false;
+
+    // Reynolds numbers are proportional to flow: split the envelope where a regime switches
+    FluidProperties unit_hot = hot, unit_cold = cold;
+    unit_hot.mass_flow = 1.0;
+    unit_cold.mass_flow = 1.0;
+    NumericalSolver::SolutionResults unit = NumericalSolver(1, geometry, unit_hot, unit_cold)
+                                                .ratingCoefficients(tube_passes);
+    hot_breaks = {env.hot_flow_min};
+    for (double Re : SHELL_REGIME_SWITCHES) {
+        double flow = Re / unit.hot_reynolds;
+        if (flow > env.hot_flow_min && flow < env.hot_flow_max) {
+            hot_breaks.push_back(flow);
+        }
+    }
+    hot_breaks.push_back(env.hot_flow_max);
+    cold_breaks = {env.cold_flow_min};
+    for (double Re : TUBE_REGIME_SWITCHES) {
+        double flow = Re / unit.cold_reynolds;
+        if (flow > env.cold_flow_min && flow < env.cold_flow_max) {
+            cold_breaks.push_back(flow);
+        }
+    }
+    cold_breaks.push_back(env.cold_flow_max);
+
+    // Total-degree Legendre basis
+    std::vector<int> all_hot, all_cold;
+    for (int total = 0; total <= degree; ++total) {
+        for (int a = total; a >= 0; --a) {
+            all_hot.push_back(a);
+            all_cold.push_back(total - a);
+        }
+    }
+    int basis_size = static_cast<int>(all_hot.size());
+
+    // Samples per cell in proportion to its log-flow area, enough for a well-posed fit
+    int hot_cells = static_cast<int>(hot_breaks.size()) - 1;
+    int cold_cells = static_cast<int>(cold_breaks.size()) - 1;
+    double total_area = std::log(env.hot_flow_max / env.hot_flow_min) * std::log(env.cold_flow_max / env.cold_flow_min);
+    cells.assign(hot_cells * cold_cells, Cell());
+    std::vector<int> train_count(cells.size()), valid_count(cells.size()), offset(cells.size() + 1, 0);
+    for (int i = 0; i < hot_cells; ++i) {
+        for (int j = 0; j < cold_cells; ++j) {
+            int c = i * cold_cells + j;
+            cells[c].hot_low = hot_breaks[i];
+            cells[c].hot_high = hot_breaks[i + 1];
+            cells[c].cold_low = cold_breaks[j];
+            cells[c].cold_high = cold_breaks[j + 1];
+            double fraction = std::log(cells[c].hot_high / cells[c].hot_low) *
+                              std::log(cells[c].cold_high / cells[c].cold_low) / total_area;
+            train_count[c] = std::max(2 * basis_size, static_cast<int>(settings.samples * fraction));
+            valid_count[c] = std::max(16, static_cast<int>(settings.validation_samples * fraction));
+            offset[c + 1] = offset[c] + train_count[c] + valid_count[c];
+        }
+    }
+
+    // Flows: Halton points for training, pseudo-random points for validation
+    int total_samples = offset.back();
+    std::vector<double> hot_flows(total_samples), cold_flows(total_samples), eff(total_samples);
+    auto logLerp = [](double low, double high, double t) {
+        return std::exp(std::log(low) + t * (std::log(high) - std::log(low)));
+    };
+    std::mt19937_64 rng(settings.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (size_t c = 0; c < cells.size(); ++c) {
+        for (int k = 0; k < train_count[c] + valid_count[c]; ++k) {
+            double u, v;
+            if (k < train_count[c]) {
+                u = radicalInverse(k + settings.seed, 2);
+                v = radicalInverse(k + settings.seed, 3);
+            } else {
+                u = uniform(rng);
+                v = uniform(rng);
+            }
+            hot_flows[offset[c] + k] = logLerp(cells[c].hot_low, cells[c].hot_high, u);
+            cold_flows[offset[c] + k] = logLerp(cells[c].cold_low, cells[c].cold_high, v);
+        }
+    }
+
+    // P does not depend on the inlet temperatures; solve at the envelope centre
+    double hot_inlet = 0.5 * (env.hot_inlet_min + env.hot_inlet_max);
+    double cold_inlet = 0.5 * (env.cold_inlet_min + env.cold_inlet_max);
+    ParallelUtils::parallelFor(0, total_samples, settings.num_threads, [&](long long i) {
+        double hot_outlet = fullSolve(hot_inlet, cold_inlet, hot_flows[i], cold_flows[i]).hot_outlet;
+        eff[i] = (hot_inlet - hot_outlet) / (hot_inlet - cold_inlet);
+    });
+
+    stats.max_error = 0.0;
+    stats.terms = 0;
+    double sum_sq = 0.0;
+    long long validated = 0;
+    for (size_t c = 0; c < cells.size(); ++c) {
+        Cell& cell = cells[c];
+        int first = offset[c];
+        int n_train = train_count[c];
+
+        auto fit = [&](const std::vector<int>& eh, const std::vector<int>& ec) {
+            int cols = static_cast<int>(eh.size());
+            std::vector<double> A(static_cast<size_t>(n_train) * cols);
+            std::vector<double> b(eff.begin() + first, eff.begin() + first + n_train);
+            double px[MAX_DEGREE + 1], py[MAX_DEGREE + 1];
+            for (int i = 0; i < n_train; ++i) {
+                legendre(scaleLog(hot_flows[first + i], cell.hot_low, cell.hot_high), degree, px);
+                legendre(scaleLog(cold_flows[first + i], cell.cold_low, cell.cold_high), degree, py);
+                for (int k = 0; k < cols; ++k) {
+                    A[static_cast<size_t>(i) * cols + k] = px[eh[k]] * py[ec[k]];
+                }
+            }
+            return leastSquares(A, b, n_train, cols);
+        };
+
+        std::vector<double> full = fit(all_hot, all_cold);
+        double largest = 0.0;
+        for (double coefficient : full) {
+            largest = std::max(largest, std::abs(coefficient));
+        }
+        for (size_t k = 0; k < full.size(); ++k) {
+            if (std::abs(full[k]) >= settings.drop_tolerance * largest) {
+                cell.exponent_hot.push_back(all_hot[k]);
+                cell.exponent_cold.push_back(all_cold[k]);
+            }
+        }
+        cell.coefficients = fit(cell.exponent_hot, cell.exponent_cold);
+        stats.terms += static_cast<int>(cell.coefficients.size());
+
+        cell.max_error = 0.0;
+        for (int k = first + n_train; k < offset[c + 1]; ++k) {
+            double error = std::abs(temperatureEffectiveness(cell, hot_flows[k], cold_flows[k]) - eff[k]);
+            cell.max_error = std::max(cell.max_error, error);
+            sum_sq += error * error;
+            ++validated;
+        }
+        stats.max_error = std::max(stats.max_error, cell.max_error);
+    }
+    trained = true;
+
+    stats.cells = static_cast<int>(cells.size());
+    stats.rms_error = std::sqrt(sum_sq / std::max(1LL, validated));
+    double capacity_ratio_max = (env.hot_flow_max * hot.specific_heat) / (env.cold_flow_min * cold.specific_heat);
+    stats.max_temperature_error = stats.max_error * (env.hot_inlet_max - env.cold_inlet_min) *
+                                  std::max(1.0, capacity_ratio_max);
+    stats.training_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+bool SurrogateModel::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open() || !trained) {
+        return false;
+    }
+    file << std::setprecision(17);
+    file << "thermocore_surrogate " << FORMAT_VERSION << "\n";
+    file << "geometry " << geometry.length << " " << geometry.shell_diameter << " " << geometry.tube_diameter
+         << " " << geometry.tube_thickness << " " << geometry.num_tubes << " " << geometry.wall_thermal_cond << "\n";
+    for (const FluidProperties* fluid : {&hot_template, &cold_template}) {
+        file << "fluid " << fluid->specific_heat << " " << fluid->density << " " << fluid->thermal_cond
+             << " " << fluid->viscosity << " " << fluid->prandtl << "\n";
+    }
+    file << "envelope " << envelope.hot_flow_min << " " << envelope.hot_flow_max << " "
+         << envelope.cold_flow_min << " " << envelope.cold_flow_max << " "
+         << envelope.hot_inlet_min << " " << envelope.hot_inlet_max << " "
+         << envelope.cold_inlet_min << " " << envelope.cold_inlet_max << "\n";
+    file << "solver " << degree << " " << segments << " " << tube_passes << "\n";
+    file << "validation " << stats.max_error << " " << stats.rms_error << " " << stats.max_temperature_error << "\n";
+    for (const std::vector<double>* breaks : {&hot_breaks, &cold_breaks}) {
+        file << "breaks " << breaks->size();
+        for (double value : *breaks) {
+            file << " " << value;
+        }
+        file << "\n";
+    }
+    for (const Cell& cell : cells) {
+        file << "cell " << cell.max_error << " " << cell.coefficients.size() << "\n";
+        for (size_t k = 0; k < cell.coefficients.size(); ++k) {
+            file << cell.exponent_hot[k] << " " << cell.exponent_cold[k] << " " << cell.coefficients[k] << "\n";
+        }
+    }
+    return file.good();
+}
+
+bool SurrogateModel::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    trained = false;
+
+    std::string tag;
+    int version = 0;
+    if (!(file >> tag >> version) || tag != "thermocore_surrogate" || version != FORMAT_VERSION) {
+        return false;
+    }
+    file >> tag >> geometry.length >> geometry.shell_diameter >> geometry.tube_diameter
+         >> geometry.tube_thickness >> geometry.num_tubes >> geometry.wall_thermal_cond;
+    for (FluidProperties* fluid : {&hot_template, &cold_template}) {
+        *fluid = FluidProperties();
+        file >> tag >> fluid->specific_heat >> fluid->density >> fluid->thermal_cond
+             >> fluid->viscosity >> fluid->prandtl;
+    }
+    file >> tag >> envelope.hot_flow_min >> envelope.hot_flow_max >> envelope.cold_flow_min
+         >> envelope.cold_flow_max >> envelope.hot_inlet_min >> envelope.hot_inlet_max
+         >> envelope.cold_inlet_min >> envelope.cold_inlet_max;
+    file >> tag >> degree >> segments >> tube_passes;
+    file >> tag >> stats.max_error >> stats.rms_error >> stats.max_temperature_error;
+    if (!file || degree < 0 || degree > MAX_DEGREE) {
+        return false;
+    }
+    for (std::vector<double>* breaks : {&hot_breaks, &cold_breaks}) {
+        size_t count = 0;
+        file >> tag >> count;
+        if (!file || count < 2 || count > 64) {
+            return false;
+        }
+        breaks->resize(count);
+        for (double& value : *breaks) {
+            file >> value;
+        }
+    }
+
+    cells.assign((hot_breaks.size() - 1) * (cold_breaks.size() - 1), Cell());
+    stats.terms = 0;
+    for (size_t c = 0; c < cells.size(); ++c) {
+        Cell& cell = cells[c];
+        size_t i = c / (cold_breaks.size() - 1), j = c % (cold_breaks.size() - 1);
+        cell.hot_low = hot_breaks[i];
+        cell.hot_high = hot_breaks[i + 1];
+        cell.cold_low = cold_breaks[j];
+        cell.cold_high = cold_breaks[j + 1];
+        size_t terms = 0;
+        file >> tag >> cell.max_error >> terms;
+        if (!file || tag != "cell") {
+            return false;
+        }
+        cell.exponent_hot.resize(terms);
+        cell.exponent_cold.resize(terms);
+        cell.coefficients.resize(terms);
+        for (size_t k = 0; k < terms; ++k) {
+            file >> cell.exponent_hot[k] >> cell.exponent_cold[k] >> cell.coefficients[k];
+            if (cell.exponent_hot[k] < 0 || cell.exponent_hot[k] > degree ||
+                cell.exponent_cold[k] < 0 || cell.exponent_cold[k] > degree) {
+                return false;
+            }
+        }
+        stats.terms += static_cast<int>(terms);
+    }
+    if (!file) {
+        return false;
+    }
+    stats.cells = static_cast<int>(cells.size());
+    stats.training_seconds = 0.0;
+    trained = true;
+    return true;
+}
@@ -0,0 +1,138 @@
+#ifndef SURROGATE_MODEL_H
+#define SURROGATE_MODEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fluid_properties.h"
+
+/**
+ * @file surrogate_model.h
+ * @brief Polynomial chaos surrogate of the multi-pass solver for microsecond ratings
+ *
+ * The solver uses constant fluid properties, so the effectiveness depends on
+ * the operating point only through the two Reynolds numbers and the capacity
+ * ratio, which are all power laws of the flows. The envelope is split into
+ * cells at the flows where either Reynolds number crosses a regime switch
+ * of the built-in correlations. The fitted quantity is the hot-side
+ * temperature effectiveness P = (T_hot,in - T_hot,out) / (T_hot,in - T_cold,in),
+ * which unlike ε has no kink where C_min changes side, so each cell is
+ * smooth. In each cell P is expanded in Legendre polynomials of the log-scaled flows (total degree
+ * ≤ p); negligible terms are dropped and the rest refitted. Outlet
+ * temperatures and duty follow exactly from P and the inlet temperatures.
+ *
+ * Training solves the full model at Halton points in parallel. A separate
+ * random validation set in every cell gives the error estimate attached to
+ * each rating. Queries outside the trained envelope are passed to the full
+ * solver.
+ */
+
+class SurrogateModel {
+public:
+    struct Envelope {
+        double hot_flow_min, hot_flow_max;          // kg/s
+        double cold_flow_min, cold_flow_max;        // kg/s
+        double hot_inlet_min, hot_inlet_max;        // K
+        double cold_inlet_min, cold_inlet_max;      // K
+    };
+
+    struct TrainingSettings {
+        int degree;                 // Total polynomial degree
+        int samples;                // Training solves
+        int validation_samples;     // Independent solves for the error estimate
+        int segments;               // Solver segments
+        int tube_passes;
+        double drop_tolerance;      // Relative coefficient size below which a term is dropped
+        uint64_t seed;
+        int num_threads;            // 0 = hardware concurrency
+
+        TrainingSettings();
+    };
+
+    struct Validation {
+        int cells;
+        int terms;                  // Summed over cells
+        double max_error;           // Hot-side temperature effectiveness, over the validation set
+        double rms_error;
+        double max_temperature_error;   // K, worst outlet temperature error on the validation set
+        double training_seconds;
+    };
+
+    struct Rating {
+        double hot_outlet;          // K
+        double cold_outlet;         // K
+        double duty;                // W
+        double effectiveness;
+        double error_estimate;      // K, validated bound on the outlet temperature error (0 for the full solver)
+        bool from_surrogate;        // false when the full solver was used
+    };
+
+    SurrogateModel();
+
+    /**
+     * Sample the solver over the envelope and fit the expansion
+     * @param geometry Exchanger geometry
+     * @param hot Hot (shell-side) property template
+     * @param cold Cold (tube-side) property template
+     * @param envelope Trained operating range
+     * @param settings Degree, sample counts and threads
+     * @return Validation statistics
+     */
+    Validation train(const GeometryProperties& geometry, const FluidProperties& hot,
+                     const FluidProperties& cold, const Envelope& envelope,
+                     const TrainingSettings& settings = TrainingSettings());
+
+    /**
+     * Rate an operating point (surrogate inside the envelope, full solver outside)
+     * @param hot_inlet Hot inlet temperature (K)
+     * @param cold_inlet Cold inlet temperature (K)
+     * @param hot_flow Hot mass flow (kg/s)
+     * @param cold_flow Cold mass flow (kg/s)
+     * @return Outlet temperatures, duty and error estimate
+     */
+    Rating rate(double hot_inlet, double cold_inlet, double hot_flow, double cold_flow) const;
+
+    bool inEnvelope(double hot_inlet, double cold_inlet, double hot_flow, double cold_flow) const;
+
+    /**
+     * Save / load the model, including geometry and fluids for the fallback solver
+     * @param filename Model file
+     * @return false on I/O or format error
+     */
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    bool isTrained() const { return trained; }
+    const Validation& validation() const { return stats; }
+
+private:
+    static const int FORMAT_VERSION = 1;
+
+    struct Cell {
+        double hot_low, hot_high;           // Flow range (kg/s)
+        double cold_low, cold_high;
+        std::vector<int> exponent_hot;      // Legendre degree in the hot feature, per term
+        std::vector<int> exponent_cold;
+        std::vector<double> coefficients;
+        double max_error;                   // Validated error in P in this cell
+    };
+
+    bool trained;
+    GeometryProperties geometry;
+    FluidProperties hot_template;
+    FluidProperties cold_template;
+    Envelope envelope;
+    int degree;
+    int segments;
+    int tube_passes;
+    std::vector<double> hot_breaks;         // Cell boundaries in hot flow, ascending
+    std::vector<double> cold_breaks;
+    std::vector<Cell> cells;                // Hot index major
+    Validation stats;
+
+    const Cell& cellFor(double hot_flow, double cold_flow) const;
+    double temperatureEffectiveness(const Cell& cell, double hot_flow, double cold_flow) const;
+    Rating fullSolve(double hot_inlet, double cold_inlet, double hot_flow, double cold_flow) const;
+};
+
+#endif // SURROGATE_MODEL_H
@@ -0,0 +1,306 @@
+#include "sweep_runner.h"
+#include "checkpoint_journal.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace SweepRunner {
+
+    namespace {
+        // Payloads stay well below the journal's 4 GB record limit
+        constexpr long long MAX_RECORD_CASES = 1LL << 22;
+
+        // Side, name, validity policy and compiled program of a user correlation
+        std::uint64_t correlationHash(const UserCorrelations::Correlation& correlation, std::uint64_t hash) {
+            const std::int32_t policy[2] = {static_cast<std::int32_t>(correlation.side()),
+                                            static_cast<std::int32_t>(correlation.outsideRange())};
+            hash = CheckpointJournal::fnv1a(policy, sizeof(policy), hash);
+            hash = CheckpointJournal::fnv1a(correlation.name().data(), correlation.name().size(), hash);
+            for (int v = 0; v < UserCorrelations::VARIABLE_COUNT; ++v) {
+                const double range[2] = {correlation.validMin(static_cast<UserCorrelations::Variable>(v)),
+                                         correlation.validMax(static_cast<UserCorrelations::Variable>(v))};
+                hash = CheckpointJournal::fnv1a(range, sizeof(range), hash);
+            }
+            // Field by field: Instruction has padding between op and operand
+            for (const UserCorrelations::Instruction& instruction : correlation.program()) {
+                hash = CheckpointJournal::fnv1a(&instruction.op, sizeof(instruction.op), hash);
+                hash = CheckpointJournal::fnv1a(&instruction.operand, sizeof(instruction.operand), hash);
+            }
+            const std::vector<double>& constants = correlation.constantPool();
+            return CheckpointJournal::fnv1a(constants.data(), constants.size() * sizeof(double), hash);
+        }
+
+        // Everything BatchSolver reads, so a journal is only reused for the same sweep.
+        // FNV-1a steps over whole 64-bit words in four independent lanes keep the
+        // hash at a few nanoseconds per case.
+        std::uint64_t fingerprint(const std::vector<BatchSolver::BatchCase>& cases,
+                                  const BatchSolver::BatchSettings& batch) {
+            const std::uint64_t prime = 1099511628211ULL;
+            std::uint64_t lanes[4] = {static_cast<std::uint64_t>(cases.size()),
+                                      static_cast<std::uint64_t>(batch.segments),
+                                      static_cast<std::uint64_t>(batch.precision), 0};
+            for (std::uint64_t& lane : lanes) {
+                lane = (14695981039346656037ULL ^ lane) * prime;
+            }
+            for (const BatchSolver::BatchCase& c : cases) {
+                const GeometryProperties& g = c.geometry;
+                const double values[20] = {
+                    g.length, g.shell_diameter, g.tube_diameter, g.tube_thickness,
+                    static_cast<double>(g.num_tubes), g.wall_thermal_cond,
+                    c.hot.inlet_temp, c.hot.mass_flow, c.hot.specific_heat, c.hot.density,
+                    c.hot.thermal_cond, c.hot.viscosity, c.hot.prandtl,
+                    c.cold.inlet_temp, c.cold.mass_flow, c.cold.specific_heat, c.cold.density,
+                    c.cold.thermal_cond, c.cold.viscosity, c.cold.prandtl};
+                for (int k = 0; k < 20; k += 4) {
+                    for (int lane = 0; lane < 4; ++lane) {
+                        std::uint64_t bits;
+                        std::memcpy(&bits, &values[k + lane], sizeof(bits));
+                        lanes[lane] = (lanes[lane] ^ bits) * prime;
+                    }
+                }
+            }
+            // User correlations are folded in only when set, so journals of built-in sweeps stay valid
+            std::uint64_t hash = CheckpointJournal::fnv1a(lanes, sizeof(lanes));
+            if (batch.tube_correlation) {
+                hash = correlationHash(*batch.tube_correlation, CheckpointJournal::fnv1a("tube", 4, hash));
+            }
+            if (batch.shell_correlation) {
+                hash = correlationHash(*batch.shell_correlation, CheckpointJournal::fnv1a("shell", 5, hash));
+            }
+            return hash;
+        }
+
+        struct PendingRange {
+            long long begin;
+            long long end;
+            SweepAggregate aggregate;
+        };
+
+        // Record payload: aggregate, then hot outlets, cold outlets and duties of the range
+        bool writeRecord(CheckpointJournal& journal, const PendingRange& range, const SweepResults& results) {
+            size_t column = static_cast<size_t>(range.end - range.begin) * sizeof(double);
+            CheckpointJournal::Span parts[4] = {
+                {&range.aggregate, sizeof(SweepAggregate)},
+                {results.hot_outlet.data() + range.begin, column},
+                {results.cold_outlet.data() + range.begin, column},
+                {results.duty.data() + range.begin, column}};
+            return journal.append(range.begin, range.end, parts, 4);
+        }
+    }
+
+    SweepSettings::SweepSettings() : block_cases(65536), checkpoint_interval(5.0) {}
+
+    SweepAggregate::SweepAggregate()
+        : cases(0), valid_cases(0), total_duty(0.0), max_duty(-HUGE_VAL),
+          min_hot_outlet(HUGE_VAL), max_cold_outlet(-HUGE_VAL) {}
+
+    void SweepAggregate::add(double hot_outlet, double cold_outlet, double duty) {
+        ++cases;
+        if (!std::isfinite(hot_outlet) || !std::isfinite(cold_outlet) || !std::isfinite(duty)) {
+            return;
+        }
+        ++valid_cases;
+        total_duty += duty;
+        max_duty = std::max(max_duty, duty);
+        min_hot_outlet = std::min(min_hot_outlet, hot_outlet);
+        max_cold_outlet = std::max(max_cold_outlet, cold_outlet);
+    }
+
+    void SweepAggregate::merge(const SweepAggregate& other) {
+        cases += other.cases;
+        valid_cases += other.valid_cases;
+        total_duty += other.total_duty;
+        max_duty = std::max(max_duty, other.max_duty);
+        min_hot_outlet = std::min(min_hot_outlet, other.min_hot_outlet);
+        max_cold_outlet = std::max(max_cold_outlet, other.max_cold_outlet);
+    }
+
+    std::vector<BatchSolver::BatchCase> expandGrid(const SweepGrid& grid) {
+        const BatchSolver::BatchCase& base = grid.base;
+        auto axis = [](const std::vector<double>& values, double fallback) {
+            return values.empty() ? std::vector<double>{fallback} : values;
+        };
+        std::vector<double> lengths = axis(grid.lengths, base.geometry.length);
+        std::vector<int> tube_counts = grid.tube_counts.empty() ? std::vector<int>{base.geometry.num_tubes}
+                                                                : grid.tube_counts;
+        std::vector<double> hot_inlets = axis(grid.hot_inlets, base.hot.inlet_temp);
+        std::vector<double> cold_inlets = axis(grid.cold_inlets, base.cold.inlet_temp);
+        std::vector<double> hot_flows = axis(grid.hot_flows, base.hot.mass_flow);
+        std::vector<double> cold_flows = axis(grid.cold_flows, base.cold.mass_flow);
+
+        std::vector<BatchSolver::BatchCase> cases;
+        cases.reserve(lengths.size() * tube_counts.size() * hot_inlets.size() * cold_inlets.size() *
+                      hot_flows.size() * cold_flows.size());
+        BatchSolver::BatchCase c = base;
+        for (double length : lengths) {
+            c.geometry.length = length;
+            for (int tubes : tube_counts) {
+                c.geometry.num_tubes = tubes;
+                for (double hot_inlet : hot_inlets) {
+                    c.hot.inlet_temp = hot_inlet;
+                    for (double cold_inlet : cold_inlets) {
+                        c.cold.inlet_temp = cold_inlet;
+                        for (double hot_flow : hot_flows) {
+                            c.hot.mass_flow = hot_flow;
+                            for (double cold_flow : cold_flows) {
+                                c.cold.mass_flow = cold_flow;
+                                cases.push_back(c);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return cases;
+    }
+
+    SweepResults run(const std::vector<BatchSolver::BatchCase>& cases, const SweepSettings& settings) {
+        if (settings.block_cases < 1) {
+            throw std::invalid_argument("Block size must be at least one case");
+        }
+        if (settings.batch.segments < 1) {
+            throw std::invalid_argument("Number of segments must be at least 1");
+        }
+        auto start = std::chrono::steady_clock::now();
+        long long n = static_cast<long long>(cases.size());
+
+        SweepResults results;
+        results.hot_outlet.assign(cases.size(), 0.0);
+        results.cold_outlet.assign(cases.size(), 0.0);
+        results.duty.assign(cases.size(), 0.0);
+        results.resumed_cases = 0;
+        results.computed_cases = 0;
+        results.checkpoints = 0;
+        results.checkpoint_seconds = 0.0;
+        results.ok = true;
+        std::vector<char> done(cases.size(), 0);
+
+        CheckpointJournal journal;
+        bool journaling = !settings.journal_path.empty();
+        if (journaling) {
+            bool opened = journal.open(settings.journal_path, fingerprint(cases, settings.batch),
+                [&](const CheckpointJournal::Record& record) {
+                    long long count = record.end - record.begin;
+                    if (record.begin < 0 || count <= 0 || record.end > n ||
+                        record.bytes != sizeof(SweepAggregate) + 3 * count * sizeof(double)) {
+                        return;     // Not a record this sweep writes
+                    }
+                    for (long long i = record.begin; i < record.end; ++i) {
+                        if (done[i]) {
+                            return;
+                        }
+                    }
+                    SweepAggregate aggregate;
+                    std::memcpy(&aggregate, record.payload, sizeof(SweepAggregate));
+                    const char* columns = record.payload + sizeof(SweepAggregate);
+                    size_t column = static_cast<size_t>(count) * sizeof(double);
+                    std::memcpy(results.hot_outlet.data() + record.begin, columns, column);
+                    std::memcpy(results.cold_outlet.data() + record.begin, columns + column, column);
+                    std::memcpy(results.duty.data() + record.begin, columns + 2 * column, column);
+                    std::fill(done.begin() + record.begin, done.begin() + record.end, 1);
+                    results.aggregate.merge(aggregate);
+                    results.resumed_cases += count;
+                });
+            if (!opened) {
+                results.ok = false;
+                results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return results;
+            }
+        }
+
+        BatchSolver::BatchSettings batch = settings.batch;
+        batch.store_profiles = false;
+        PendingRange pending{0, 0, SweepAggregate()};
+        auto last_checkpoint = std::chrono::steady_clock::now();
+
+        // One record at a time is written in the background while later blocks are
+        // rated. The ranges it reads are final, so it needs no copy of the results.
+        std::thread writer;
+        PendingRange writing{0, 0, SweepAggregate()};
+        bool write_failed = false;
+        // Joins a writer still running when BatchSolver::solve throws
+        struct WriterGuard {
+            std::thread& thread;
+            ~WriterGuard() {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+        } writer_guard{writer};
+        auto waitForWriter = [&]() {
+            if (!writer.joinable()) {
+                return;
+            }
+            auto wait_start = std::chrono::steady_clock::now();
+            writer.join();
+            results.checkpoint_seconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - wait_start).count();
+            if (write_failed) {
+                std::cerr << "Error: Could not append to journal " << settings.journal_path << "\n";
+                results.ok = false;
+            } else {
+                ++results.checkpoints;
+            }
+        };
+
+        // Fold the pending range into the aggregate and journal it
+        auto flush = [&]() {
+            results.aggregate.merge(pending.aggregate);
+            if (pending.end > pending.begin && journaling) {
+                waitForWriter();
+                if (results.ok) {
+                    writing = pending;
+                    writer = std::thread([&]() { write_failed = !writeRecord(journal, writing, results); });
+                }
+                last_checkpoint = std::chrono::steady_clock::now();
+            }
+            pending = PendingRange{0, 0, SweepAggregate()};
+        };
+
+        long long i = 0;
+        while (i < n) {
+            if (done[i]) {
+                ++i;
+                continue;
+            }
+            // Next block of cases no record covers
+            long long end = i;
+            while (end < n && end - i < settings.block_cases && !done[end]) {
+                ++end;
+            }
+            if (pending.end != i) {
+                flush();
+                pending.begin = pending.end = i;
+            }
+
+            std::vector<BatchSolver::BatchCase> block(cases.begin() + i, cases.begin() + end);
+            BatchSolver::BatchResults rated = BatchSolver::solve(block, batch);
+            for (long long k = i; k < end; ++k) {
+                results.hot_outlet[k] = rated.hot_outlet[k - i];
+                results.cold_outlet[k] = rated.cold_outlet[k - i];
+                results.duty[k] = rated.duty[k - i];
+                pending.aggregate.add(results.hot_outlet[k], results.cold_outlet[k], results.duty[k]);
+            }
+            pending.end = end;
+            results.computed_cases += end - i;
+            i = end;
+
+            double since_checkpoint = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - last_checkpoint).count();
+            if (since_checkpoint >= settings.checkpoint_interval || pending.end - pending.begin >= MAX_RECORD_CASES) {
+                flush();
+                pending.begin = pending.end = i;
+            }
+        }
+        flush();
+        waitForWriter();
+
+        results.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return results;
+    }
+
+} // namespace SweepRunner
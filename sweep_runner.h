@@ -0,0 +1,92 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include <string>
+#include <vector>
+#include "batch_solver.h"
+
+/**
+ * @file sweep_runner.h
+ * @brief Resumable batch sweeps with an append-only checkpoint journal
+ *
+ * Cases are rated in blocks with BatchSolver. Finished blocks are collected
+ * and, once the checkpoint interval has passed, each contiguous range of
+ * them is appended to a CheckpointJournal. The record holds the range's
+ * outlets and duties and its partial aggregate. Records are checksummed and
+ * fsync'd on a background thread while rating continues. A restarted run with the
+ * same cases and settings replays the journal, keeps the recorded results
+ * and rates only the cases no record covers. The journal fingerprint
+ * covers every case input, the segment count, the precision and any user
+ * correlation (side, name, validity ranges and compiled program), so a
+ * journal from a different sweep is rejected rather than mixed in.
+ */
+
+namespace SweepRunner {
+
+    /**
+     * Cartesian grid around a base case; an empty axis keeps the base value
+     */
+    struct SweepGrid {
+        BatchSolver::BatchCase base;
+        std::vector<double> lengths;            // m
+        std::vector<int> tube_counts;
+        std::vector<double> hot_inlets;         // K
+        std::vector<double> cold_inlets;        // K
+        std::vector<double> hot_flows;          // kg/s
+        std::vector<double> cold_flows;         // kg/s
+    };
+
+    struct SweepSettings {
+        std::string journal_path;               // Empty = no checkpointing
+        BatchSolver::BatchSettings batch;       // Segments, precision and threads (profiles are not kept)
+        long long block_cases;                  // Cases per BatchSolver call
+        double checkpoint_interval;             // Seconds between journal appends
+
+        SweepSettings();
+    };
+
+    struct SweepAggregate {
+        long long cases;
+        long long valid_cases;                  // Finite outlets
+        double total_duty;                      // W, over valid cases
+        double max_duty;                        // W
+        double min_hot_outlet;                  // K
+        double max_cold_outlet;                 // K
+
+        SweepAggregate();
+
+        void add(double hot_outlet, double cold_outlet, double duty);
+        void merge(const SweepAggregate& other);
+    };
+
+    struct SweepResults {
+        std::vector<double> hot_outlet;         // K, per case
+        std::vector<double> cold_outlet;        // K
+        std::vector<double> duty;               // W
+        SweepAggregate aggregate;
+        long long resumed_cases;                // Taken from the journal
+        long long computed_cases;               // Rated in this run
+        int checkpoints;                        // Records appended in this run
+        double checkpoint_seconds;              // Time the sweep waited for journal writes
+        double elapsed_seconds;
+        bool ok;                                // false if the journal could not be opened or written
+    };
+
+    /**
+     * Expand a grid (lengths vary slowest, cold flows fastest)
+     * @param grid Base case and axes
+     * @return One case per grid point
+     */
+    std::vector<BatchSolver::BatchCase> expandGrid(const SweepGrid& grid);
+
+    /**
+     * Rate every case, resuming from the journal if it holds earlier progress
+     * @param cases Cases in a fixed order (the order is part of the fingerprint)
+     * @param settings Journal, batch settings and checkpoint cadence
+     * @return Per-case results, aggregate and checkpoint statistics
+     */
+    SweepResults run(const std::vector<BatchSolver::BatchCase>& cases, const SweepSettings& settings);
+
+} // namespace SweepRunner
+
+#endif // SWEEP_RUNNER_H
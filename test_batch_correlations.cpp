@@ -0,0 +1,133 @@
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch_solver.h"
+#include "numerical_solver.h"
+#include "user_correlations.h"
+
+/**
+ * @file test_batch_correlations.cpp
+ * @brief Checks BatchSolver's user-correlation hook against the built-in path and NumericalSolver
+ *
+ * Built and run by "make test"; exits non-zero if any check fails.
+ */
+
+namespace {
+    // Copies of the built-in turbulent branches: Gnielinski above Re 10^4 on the
+    // tube side and the staggered bundle above Re 2000 on the shell side. Below
+    // those ranges both fall back to the same built-in correlations.
+    const char* BUILTIN_COPIES =
+        "correlation Builtin Tube\n"
+        "side tube\n"
+        "valid Re 10000 5e6\n"
+        "outside builtin\n"
+        "let f = (0.79 * log(Re) - 1.64)^-2\n"
+        "nu = (f / 8) * (Re - 1000) * Pr / (1 + 12.7 * sqrt(f / 8) * (Pr^(2/3) - 1))\n"
+        "end\n"
+        "correlation Builtin Shell\n"
+        "side shell\n"
+        "valid Re 2000 1e9\n"
+        "outside builtin\n"
+        "nu = 0.36 * Re^0.55 * Pr^0.36\n"
+        "end\n";
+
+    int failures = 0;
+
+    void check(bool passed, const std::string& name) {
+        std::cout << (passed ? "PASS " : "FAIL ") << name << "\n";
+        if (!passed) {
+            failures++;
+        }
+    }
+
+    /**
+     * Cases spanning laminar to turbulent flow on both sides, with the geometry
+     * changing every few cases so correlations that read geometry ratios are
+     * evaluated in several runs per lane block
+     */
+    std::vector<BatchSolver::BatchCase> sweepCases(int count) {
+        std::vector<BatchSolver::BatchCase> cases;
+        for (int i = 0; i < count; ++i) {
+            double shell_diameter = 0.3 + 0.05 * ((i / 5) % 6);
+            int num_tubes = 60 + 20 * ((i / 7) % 4);
+            GeometryProperties geometry(3.0 + (i % 3), shell_diameter, 0.019, 0.0015, num_tubes, 16.0);
+            double hot_flow = 0.05 * std::pow(1.12, i % 60);
+            double cold_flow = 0.5 * std::pow(1.1, (i * 7) % 70);
+            FluidProperties hot(360.0 + (i % 11), 0.0, hot_flow, 4190.0, 970.0, 0.67, 0.00035, 2.2);
+            FluidProperties cold(290.0 + (i % 13), 0.0, cold_flow, 4180.0, 998.0, 0.60, 0.0010, 7.0);
+            cases.push_back({geometry, hot, cold});
+        }
+        return cases;
+    }
+
+    bool identical(const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    std::vector<BatchSolver::BatchCase> cases = sweepCases(2000);
+
+    UserCorrelations::CorrelationLibrary library;
+    std::string error;
+    if (!library.compile(BUILTIN_COPIES, "builtin copies", error) || !library.load("correlations.txt", error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    BatchSolver::BatchSettings settings;
+    settings.segments = 50;
+    settings.precision = BatchSolver::Precision::Double;
+    settings.num_threads = 2;
+
+    // Correlations equal to the built-in ones must not change a single bit
+    BatchSolver::BatchResults builtin = BatchSolver::solve(cases, settings);
+    BatchSolver::BatchSettings copies = settings;
+    copies.tube_correlation = library.find("Builtin Tube");
+    copies.shell_correlation = library.find("Builtin Shell");
+    BatchSolver::BatchResults copied = BatchSolver::solve(cases, copies);
+    check(identical(builtin.overall_htc, copied.overall_htc), "built-in copies give the built-in U");
+    check(identical(builtin.hot_outlet, copied.hot_outlet) && identical(builtin.cold_outlet, copied.cold_outlet),
+          "built-in copies give the built-in outlets");
+
+    // Batch evaluation must match NumericalSolver's scalar path case by case
+    BatchSolver::BatchSettings user = settings;
+    user.tube_correlation = library.find("Gnielinski Entrance");
+    user.shell_correlation = library.find("Vendor Bundle");
+    BatchSolver::BatchResults batch = BatchSolver::solve(cases, user);
+    bool matches = true;
+    bool differs = false;
+    for (size_t i = 0; i < cases.size(); ++i) {
+        NumericalSolver solver(1, cases[i].geometry, cases[i].hot, cases[i].cold);
+        solver.setUserCorrelations(user.tube_correlation, user.shell_correlation);
+        double scalar = solver.ratingCoefficients().overall_htc;
+        matches = matches && batch.overall_htc[i] == scalar;
+        differs = differs || batch.overall_htc[i] != builtin.overall_htc[i];
+    }
+    check(matches, "batch user correlations match NumericalSolver::setUserCorrelations");
+    check(differs, "user correlations change U");
+
+    bool rejected = false;
+    try {
+        BatchSolver::BatchSettings swapped = settings;
+        swapped.tube_correlation = user.shell_correlation;
+        BatchSolver::solve(cases, swapped);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    check(rejected, "shell correlation rejected on the tube side");
+
+    std::cout << (failures == 0 ? "All checks passed" : "Checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "profile_stream.h"
+
+/**
+ * @file test_profile_stream.cpp
+ * @brief Checks that FileSink writes every row at its largest precision, diverged values included
+ *
+ * Built and run by "make test"; exits non-zero if any check fails.
+ */
+
+namespace {
+    int failures = 0;
+
+    void check(bool passed, const std::string& name) {
+        std::cout << (passed ? "PASS " : "FAIL ") << name << "\n";
+        if (!passed) {
+            failures++;
+        }
+    }
+
+    bool sameValue(double written, double expected) {
+        return std::isnan(expected) ? std::isnan(written) : written == expected;
+    }
+
+    bool rejectsPrecision(const std::string& filename, int precision) {
+        try {
+            ProfileStream::FileSink sink(filename, precision);
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main() {
+    const std::string filename =
+        (std::filesystem::temp_directory_path() / "test_profile_stream.csv").string();
+    const int stations = 100000;
+    const double dx = 1.0e-4;
+
+    // A solve that diverged: every 997th station holds a huge or non-finite value
+    const double diverged[] = {1.0e300, -DBL_MAX, DBL_MAX, std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN()};
+    std::vector<double> hot(stations);
+    std::vector<double> cold(stations);
+    for (int k = 0; k < stations; ++k) {
+        hot[k] = 360.0 - 1.0e-4 * k;
+        cold[k] = 290.0 + 7.0e-5 * k;
+        if (k % 997 == 0) {
+            hot[k] = diverged[(k / 997) % 6];
+            cold[k] = -diverged[(k / 997 + 1) % 6];
+        }
+    }
+
+    bool delivered = false;
+    bool closed = false;
+    {
+        ProfileStream::FileSink sink(filename, ProfileStream::FileSink::MAX_PRECISION);
+        ProfileStream::ProfileChunk chunk{0, stations, dx, hot.data(), cold.data(), nullptr, true};
+        delivered = sink.isOpen() && sink(chunk);
+        closed = sink.close();
+    }
+    check(delivered && closed, "a 100000-station chunk with diverged values is written at precision 64");
+
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line);
+    int rows = 0;
+    bool round_trip = true;
+    while (std::getline(in, line)) {
+        const double expected[5] = {rows * dx, hot[rows], hot[rows] - 273.15, cold[rows], cold[rows] - 273.15};
+        const char* text = line.c_str();
+        for (int v = 0; v < 5 && round_trip; ++v) {
+            char* next = nullptr;
+            double written = std::strtod(text, &next);
+            round_trip = next != text && sameValue(written, expected[v]) && *next == (v < 4 ? ',' : '\0');
+            text = next + 1;
+        }
+        ++rows;
+        if (!round_trip || rows == stations) {
+            break;
+        }
+    }
+    check(rows == stations && !std::getline(in, line), "one row per station");
+    check(round_trip, "every value reads back exactly");
+    in.close();
+
+    check(rejectsPrecision(filename, ProfileStream::FileSink::MAX_PRECISION + 1), "precision above 64 rejected");
+    check(rejectsPrecision(filename, -1), "negative precision rejected");
+    std::remove(filename.c_str());
+
+    std::cout << (failures == 0 ? "All checks passed" : "Checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "batch_solver.h"
+#include "sharded_sweep.h"
+
+#if !defined(_WIN32)
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file test_sharded_sweep.cpp
+ * @brief Checks that a sharded sweep survives a worker killed mid-sweep
+ *
+ * Built and run by "make test"; exits non-zero if any check fails. The
+ * program is its own worker executable, so main() forwards worker
+ * invocations to ShardedSweep::workerMain().
+ */
+
+#if !defined(_WIN32)
+
+namespace {
+    int failures = 0;
+
+    void check(bool passed, const std::string& name) {
+        std::cout << (passed ? "PASS " : "FAIL ") << name << "\n";
+        if (!passed) {
+            failures++;
+        }
+    }
+
+    bool identical(const std::vector<double>& a, const std::vector<double>& b) {
+        return a.size() == b.size() &&
+               (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+    }
+
+    // True once the worker has flushed at least one shard record after the magic
+    bool holdsShard(const std::string& path) {
+        std::error_code error;
+        return std::filesystem::file_size(path, error) > 8 + 24 && !error;
+    }
+
+    // A process spawned by this one, or 0
+    pid_t findChild() {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator("/proc", error)) {
+            std::string name = entry.path().filename().string();
+            if (name.find_first_not_of("0123456789") != std::string::npos) {
+                continue;
+            }
+            std::FILE* stat = std::fopen((entry.path() / "stat").c_str(), "r");
+            if (!stat) {
+                continue;
+            }
+            // pid (comm) state ppid ...; comm may hold spaces, so parse after the last ')'
+            char line[512] = "";
+            size_t length = std::fread(line, 1, sizeof(line) - 1, stat);
+            std::fclose(stat);
+            line[length] = '\0';
+            const char* close = std::strrchr(line, ')');
+            char state;
+            int ppid;
+            if (close && std::sscanf(close + 1, " %c %d", &state, &ppid) == 2 && ppid == getpid()) {
+                return static_cast<pid_t>(std::stol(name));
+            }
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (ShardedSweep::isWorkerInvocation(argc, argv)) {
+        return ShardedSweep::workerMain(argc, argv);
+    }
+
+    // Fine segmentation keeps each shard busy for several milliseconds, so a
+    // worker killed while the queue is still open is almost always mid-shard
+    std::vector<BatchSolver::BatchCase> cases;
+    for (int i = 0; i < 10000; ++i) {
+        cases.push_back({GeometryProperties(3.0 + (i % 3), 0.4, 0.019, 0.0015, 80, 16.0),
+                         FluidProperties(360.0 + (i % 11), 0.0, 1.0 + 0.001 * i, 4190.0, 970.0, 0.67, 0.00035, 2.2),
+                         FluidProperties(290.0 + (i % 13), 0.0, 2.0, 4180.0, 998.0, 0.60, 0.0010, 7.0)});
+    }
+
+    ShardedSweep::ShardSettings settings;
+    settings.workers = 2;
+    settings.shard_cases = 100;
+    settings.batch.segments = 20000;
+    settings.output_prefix =
+        (std::filesystem::temp_directory_path() / ("test_sharded_sweep-" + std::to_string(getpid()))).string();
+
+    ShardedSweep::ShardedResults sharded;
+    std::thread coordinator([&]() { sharded = ShardedSweep::run(cases, settings); });
+
+    // Kill one worker once both have written a shard
+    bool killed = false;
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (std::chrono::steady_clock::now() < give_up) {
+        if (holdsShard(settings.output_prefix + ".worker0") && holdsShard(settings.output_prefix + ".worker1")) {
+            pid_t child = findChild();
+            killed = child > 0 && kill(child, SIGKILL) == 0;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    coordinator.join();
+    check(killed, "one of two workers killed mid-sweep");
+    check(sharded.ok && sharded.workers_attached == 2, "both workers attached to the queue");
+    check(sharded.recovered_shards >= 1, "the coordinator rated the killed worker's unfinished shards");
+
+    // Workers rate each shard with these settings (see shardSettings)
+    BatchSolver::BatchSettings batch = settings.batch;
+    batch.store_profiles = false;
+    BatchSolver::BatchResults reference = BatchSolver::solve(cases, batch);
+    check(identical(sharded.hot_outlet, reference.hot_outlet) && identical(sharded.cold_outlet, reference.cold_outlet) &&
+          identical(sharded.duty, reference.duty) && identical(sharded.overall_htc, reference.overall_htc),
+          "merged results equal a single BatchSolver::solve bit for bit");
+
+    std::cout << (failures == 0 ? "All checks passed" : "Checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+#else
+
+int main() {
+    std::cout << "Sharded sweeps need POSIX shared memory; nothing to check" << std::endl;
+    return 0;
+}
+
+#endif
@@ -79,11 +79,43 @@ namespace ThermalCalculations {
                                      (std::exp(-C_ratio * std::pow(NTU, 0.78)) - 1.0));
                 break;
                 
+            case 3: { // One shell pass, 2N tube passes
+                double root = std::sqrt(1.0 + C_ratio * C_ratio);
+                double exp_term = std::exp(-NTU * root);
+                return 2.0 / (1.0 + C_ratio + root * (1.0 + exp_term) / (1.0 - exp_term));
+            }
+                
             default:
                 return effectiveness_NTU(NTU, C_ratio, 0); // Default to counter-current
         }
     }
     
+    double correctionFactor_1_2N(double P, double R) {
+        if (P <= 0.0) {
+            return 1.0;
+        }
+        
+        double root = std::sqrt(R * R + 1.0);
+        double denominator_arg_num = 2.0 - P * (R + 1.0 - root);
+        double denominator_arg_den = 2.0 - P * (R + 1.0 + root);
+        if (denominator_arg_den <= 0.0 || denominator_arg_num <= 0.0) {
+            return 0.0; // Temperature cross beyond what a single shell can deliver
+        }
+        
+        if (std::abs(R - 1.0) < 1e-6) {
+            // Limit R -> 1
+            double ratio = (2.0 - P * (2.0 - std::sqrt(2.0))) / (2.0 - P * (2.0 + std::sqrt(2.0)));
+            return (P * std::sqrt(2.0) / (1.0 - P)) / std::log(ratio);
+        }
+        
+        double ratio_num = (1.0 - P) / (1.0 - R * P);
+        if (ratio_num <= 0.0) {
+            return 0.0;
+        }
+        return (root * std::log(ratio_num)) /
+               ((R - 1.0) * std::log(denominator_arg_num / denominator_arg_den));
+    }
+    
     double calculateNTU(double UA, double C_min) {
         return UA / C_min;
     }
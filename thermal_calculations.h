@@ -63,11 +63,21 @@ namespace ThermalCalculations {
      * Calculate heat exchanger effectiveness using NTU method
      * @param NTU Number of Transfer Units
      * @param C_ratio Ratio of minimum to maximum heat capacity rates
-     * @param flow_arrangement 0 = counter-current, 1 = parallel, 2 = cross-flow
+     * @param flow_arrangement 0 = counter-current, 1 = parallel, 2 = cross-flow,
+     *                         3 = one shell pass with 2, 4, ... tube passes (TEMA E)
      * @return Effectiveness (dimensionless)
      */
     double effectiveness_NTU(double NTU, double C_ratio, int flow_arrangement = 0);
     
+    /**
+     * LMTD correction factor F for one shell pass and 2, 4, ... tube passes
+     * (Bowman-Mueller-Nagle closed form, shell fluid mixed)
+     * @param P Temperature effectiveness of the tube-side fluid (t_out - t_in) / (T_in - t_in)
+     * @param R Capacity ratio (T_in - T_out) / (t_out - t_in)
+     * @return Correction factor F (0 if the specified duty is infeasible)
+     */
+    double correctionFactor_1_2N(double P, double R);
+    
     /**
      * Calculate Number of Transfer Units (NTU)
      * @param UA Overall heat transfer coefficient times area (W/K)
@@ -0,0 +1,354 @@
+#include "thermocore.h"
+#include "numerical_solver.h"
+#include "heat_exchanger_geometry.h"
+#include "solver_variants.h"
+#include "parallel_utils.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+struct tc_geometry {
+    GeometryProperties geometry;
+};
+
+struct tc_fluid {
+    FluidProperties fluid;
+};
+
+struct tc_solver {
+    int segments;
+    GeometryProperties geometry;
+    FluidProperties hot;
+    FluidProperties cold;
+};
+
+namespace {
+    // Fixed-size so that recording an error never allocates
+    thread_local char last_error[256] = "";
+
+    void setError(const char* message) {
+        std::snprintf(last_error, sizeof(last_error), "%s", message);
+    }
+
+    tc_status fail(tc_status status, const char* message) {
+        setError(message);
+        return status;
+    }
+
+    /**
+     * Run an API body, translating exceptions into status codes
+     * @param body Callable returning tc_status
+     */
+    template <typename Body>
+    tc_status guarded(Body body) {
+        try {
+            return body();
+        } catch (const std::invalid_argument& e) {
+            return fail(TC_INVALID_ARGUMENT, e.what());
+        } catch (const std::bad_alloc&) {
+            return fail(TC_OUT_OF_MEMORY, "Out of memory");
+        } catch (const std::exception& e) {
+            return fail(TC_INTERNAL_ERROR, e.what());
+        } catch (...) {
+            return fail(TC_INTERNAL_ERROR, "Unknown error");
+        }
+    }
+
+    bool positive(double value) {
+        return std::isfinite(value) && value > 0.0;
+    }
+
+    // Film coefficients and closed-form segment march for one operating point
+    tc_rating rate(const tc_solver& solver, const FluidProperties& hot, const FluidProperties& cold) {
+        NumericalSolver::SolutionResults coefficients =
+            NumericalSolver(solver.segments, solver.geometry, hot, cold).ratingCoefficients();
+        double area = HeatExchangerGeometry::totalTubeArea(
+            solver.geometry.tube_diameter, solver.geometry.length, solver.geometry.num_tubes);
+        SolverVariants::Policies::Outlets<double> outlets = SolverVariants::Policies::SegmentMarch{solver.segments}
+            .outlets<double>(coefficients.overall_htc * area, hot.mass_flow * hot.specific_heat,
+                             cold.mass_flow * cold.specific_heat, hot.inlet_temp, cold.inlet_temp);
+
+        tc_rating rating;
+        rating.hot_outlet = outlets.hot_outlet;
+        rating.cold_outlet = outlets.cold_outlet;
+        rating.duty = outlets.duty;
+        rating.overall_htc = coefficients.overall_htc;
+        rating.hot_htc = coefficients.hot_htc;
+        rating.cold_htc = coefficients.cold_htc;
+        rating.hot_reynolds = coefficients.hot_reynolds;
+        rating.cold_reynolds = coefficients.cold_reynolds;
+        return rating;
+    }
+}
+
+extern "C" {
+
+int tc_api_version(void) {
+    return TC_API_VERSION;
+}
+
+const char* tc_status_string(tc_status status) {
+    switch (status) {
+        case TC_OK:               return "OK";
+        case TC_INVALID_ARGUMENT: return "Invalid argument";
+        case TC_BUFFER_TOO_SMALL: return "Buffer too small";
+        case TC_OUT_OF_MEMORY:    return "Out of memory";
+        case TC_INTERNAL_ERROR:   return "Internal error";
+    }
+    return "Unknown status";
+}
+
+const char* tc_last_error(void) {
+    return last_error;
+}
+
+tc_status tc_geometry_create(double length, double shell_diameter, double tube_diameter,
+                             double tube_thickness, int num_tubes, double wall_conductivity,
+                             tc_geometry** out) {
+    return guarded([&] {
+        if (!out) {
+            return fail(TC_INVALID_ARGUMENT, "Output handle pointer is null");
+        }
+        *out = nullptr;
+        if (!positive(length) || !positive(shell_diameter) || !positive(tube_diameter) ||
+            !std::isfinite(tube_thickness) || tube_thickness < 0.0 || num_tubes < 1 ||
+            !positive(wall_conductivity)) {
+            return fail(TC_INVALID_ARGUMENT, "Geometry dimensions, tube count and wall conductivity must be positive");
+        }
+        if (!(HeatExchangerGeometry::shellFlowArea(shell_diameter, tube_diameter + 2.0 * tube_thickness,
+                                                   num_tubes) > 0.0)) {
+            return fail(TC_INVALID_ARGUMENT, "Tubes do not fit in the shell (no shell-side flow area)");
+        }
+        *out = new tc_geometry{GeometryProperties(length, shell_diameter, tube_diameter, tube_thickness,
+                                                  num_tubes, wall_conductivity)};
+        return TC_OK;
+    });
+}
+
+void tc_geometry_destroy(tc_geometry* geometry) {
+    delete geometry;
+}
+
+tc_status tc_fluid_create(double inlet_temp, double mass_flow, double specific_heat, double density,
+                          double conductivity, double viscosity, double prandtl, tc_fluid** out) {
+    return guarded([&] {
+        if (!out) {
+            return fail(TC_INVALID_ARGUMENT, "Output handle pointer is null");
+        }
+        *out = nullptr;
+        if (!positive(inlet_temp) || !positive(mass_flow) || !positive(specific_heat) || !positive(density) ||
+            !positive(conductivity) || !positive(viscosity) || !positive(prandtl)) {
+            return fail(TC_INVALID_ARGUMENT, "Fluid temperature, flow and properties must be positive");
+        }
+        *out = new tc_fluid{FluidProperties(inlet_temp, inlet_temp, mass_flow, specific_heat, density,
+                                            conductivity, viscosity, prandtl)};
+        return TC_OK;
+    });
+}
+
+tc_status tc_fluid_create_common(const char* name, double temperature, double mass_flow, tc_fluid** out) {
+    return guarded([&] {
+        if (!out || !name) {
+            return fail(TC_INVALID_ARGUMENT, "Fluid name or output handle pointer is null");
+        }
+        *out = nullptr;
+        if (!positive(temperature) || !positive(mass_flow)) {
+            return fail(TC_INVALID_ARGUMENT, "Temperature and mass flow must be positive");
+        }
+        FluidProperties fluid;
+        if (std::strcmp(name, "water") == 0) {
+            fluid = CommonFluids::getWaterProperties(temperature);
+        } else if (std::strcmp(name, "air") == 0) {
+            fluid = CommonFluids::getAirProperties(temperature);
+        } else if (std::strcmp(name, "oil") == 0) {
+            fluid = CommonFluids::getOilProperties(temperature);
+        } else {
+            return fail(TC_INVALID_ARGUMENT, "Unknown fluid (expected water, air or oil)");
+        }
+        if (!positive(fluid.density) || !positive(fluid.viscosity) || !positive(fluid.thermal_cond)) {
+            return fail(TC_INVALID_ARGUMENT, "Temperature outside the range of the built-in property data");
+        }
+        fluid.inlet_temp = temperature;
+        fluid.outlet_temp = temperature;
+        fluid.mass_flow = mass_flow;
+        *out = new tc_fluid{fluid};
+        return TC_OK;
+    });
+}
+
+tc_status tc_fluid_set_inlet(tc_fluid* fluid, double inlet_temp) {
+    if (!fluid || !positive(inlet_temp)) {
+        return fail(TC_INVALID_ARGUMENT, "Null fluid or non-positive inlet temperature");
+    }
+    fluid->fluid.inlet_temp = inlet_temp;
+    return TC_OK;
+}
+
+tc_status tc_fluid_set_mass_flow(tc_fluid* fluid, double mass_flow) {
+    if (!fluid || !positive(mass_flow)) {
+        return fail(TC_INVALID_ARGUMENT, "Null fluid or non-positive mass flow");
+    }
+    fluid->fluid.mass_flow = mass_flow;
+    return TC_OK;
+}
+
+void tc_fluid_destroy(tc_fluid* fluid) {
+    delete fluid;
+}
+
+tc_status tc_solver_create(const tc_geometry* geometry, const tc_fluid* hot, const tc_fluid* cold,
+                           int segments, tc_solver** out) {
+    return guarded([&] {
+        if (!out) {
+            return fail(TC_INVALID_ARGUMENT, "Output handle pointer is null");
+        }
+        *out = nullptr;
+        if (!geometry || !hot || !cold) {
+            return fail(TC_INVALID_ARGUMENT, "Geometry or fluid handle is null");
+        }
+        if (segments < 1) {
+            return fail(TC_INVALID_ARGUMENT, "Number of segments must be at least 1");
+        }
+        *out = new tc_solver{segments, geometry->geometry, hot->fluid, cold->fluid};
+        return TC_OK;
+    });
+}
+
+tc_status tc_solver_set_operating_point(tc_solver* solver, double hot_inlet, double cold_inlet,
+                                        double hot_flow, double cold_flow) {
+    if (!solver) {
+        return fail(TC_INVALID_ARGUMENT, "Solver handle is null");
+    }
+    if (!positive(hot_inlet) || !positive(cold_inlet) || !positive(hot_flow) || !positive(cold_flow)) {
+        return fail(TC_INVALID_ARGUMENT, "Inlet temperatures and mass flows must be positive");
+    }
+    solver->hot.inlet_temp = hot_inlet;
+    solver->cold.inlet_temp = cold_inlet;
+    solver->hot.mass_flow = hot_flow;
+    solver->cold.mass_flow = cold_flow;
+    return TC_OK;
+}
+
+void tc_solver_destroy(tc_solver* solver) {
+    delete solver;
+}
+
+size_t tc_solver_stations(const tc_solver* solver) {
+    return solver ? static_cast<size_t>(solver->segments) + 1 : 0;
+}
+
+tc_status tc_solver_rate(const tc_solver* solver, tc_rating* out) {
+    if (!solver || !out) {
+        return fail(TC_INVALID_ARGUMENT, "Solver handle or output pointer is null");
+    }
+    return guarded([&] {
+        *out = rate(*solver, solver->hot, solver->cold);
+        return TC_OK;
+    });
+}
+
+tc_status tc_solver_profile(const tc_solver* solver, double* positions, double* hot, double* cold,
+                            size_t capacity) {
+    if (!solver || !hot || !cold) {
+        return fail(TC_INVALID_ARGUMENT, "Solver handle or profile array is null");
+    }
+    int n = solver->segments;
+    if (capacity < static_cast<size_t>(n) + 1) {
+        return fail(TC_BUFFER_TOO_SMALL, "Profile arrays need tc_solver_stations() elements");
+    }
+    return guarded([&] {
+        NumericalSolver::SolutionResults coefficients =
+            NumericalSolver(n, solver->geometry, solver->hot, solver->cold).ratingCoefficients();
+        double area = HeatExchangerGeometry::totalTubeArea(
+            solver->geometry.tube_diameter, solver->geometry.length, solver->geometry.num_tubes);
+        double UA_segment = coefficients.overall_htc * area / n;
+
+        // Segment map in increment form (rows sum to one), as in BatchSolver
+        double a = UA_segment / (solver->hot.mass_flow * solver->hot.specific_heat);
+        double b = UA_segment / (solver->cold.mass_flow * solver->cold.specific_heat);
+        double det = 1.0 - a * b / 4.0;
+        double p = (a / 2.0 + (a / 2.0) * (1.0 - b)) / det;
+        double q = ((b / 2.0) * (1.0 - a) + b / 2.0) / det;
+
+        double dx = solver->geometry.length / n;
+        double h = solver->hot.inlet_temp;
+        double c = solver->cold.inlet_temp;
+        for (int i = 0; i <= n; ++i) {
+            if (i > 0) {
+                double d = h - c;
+                h -= p * d;
+                c += q * d;
+            }
+            hot[i] = h;
+            cold[n - i] = c;
+            if (positions) {
+                positions[i] = i * dx;
+            }
+        }
+        return TC_OK;
+    });
+}
+
+tc_status tc_solver_rate_batch(const tc_solver* solver, size_t count,
+                               const double* hot_inlet, const double* cold_inlet,
+                               const double* hot_flow, const double* cold_flow,
+                               double* hot_outlet, double* cold_outlet, double* duty,
+                               int num_threads) {
+    if (!solver) {
+        return fail(TC_INVALID_ARGUMENT, "Solver handle is null");
+    }
+    if (num_threads < 0) {
+        return fail(TC_INVALID_ARGUMENT, "Number of threads must not be negative");
+    }
+    // Same checks as tc_solver_set_operating_point, before any output is written
+    for (size_t i = 0; i < count; ++i) {
+        if ((hot_inlet && !positive(hot_inlet[i])) || (cold_inlet && !positive(cold_inlet[i])) ||
+            (hot_flow && !positive(hot_flow[i])) || (cold_flow && !positive(cold_flow[i]))) {
+            std::snprintf(last_error, sizeof(last_error),
+                          "Point %zu: inlet temperatures and mass flows must be positive", i);
+            return TC_INVALID_ARGUMENT;
+        }
+    }
+    return guarded([&] {
+        // Workers keep the first exception; it is rethrown here so that the
+        // status and tc_last_error() are set on the calling thread
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto ratePoints = [&](long long begin, long long end) {
+            try {
+                FluidProperties hot = solver->hot;
+                FluidProperties cold = solver->cold;
+                for (long long i = begin; i < end; ++i) {
+                    if (hot_inlet) hot.inlet_temp = hot_inlet[i];
+                    if (cold_inlet) cold.inlet_temp = cold_inlet[i];
+                    if (hot_flow) hot.mass_flow = hot_flow[i];
+                    if (cold_flow) cold.mass_flow = cold_flow[i];
+                    tc_rating rating = rate(*solver, hot, cold);
+                    if (hot_outlet) hot_outlet[i] = rating.hot_outlet;
+                    if (cold_outlet) cold_outlet[i] = rating.cold_outlet;
+                    if (duty) duty[i] = rating.duty;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        if (num_threads == 1) {
+            ratePoints(0, static_cast<long long>(count));
+        } else {
+            ParallelUtils::parallelForBlocks(0, static_cast<long long>(count), num_threads, ratePoints, 1024);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return TC_OK;
+    });
+}
+
+} // extern "C"
@@ -0,0 +1,189 @@
+#ifndef THERMOCORE_H
+#define THERMOCORE_H
+
+#include <stddef.h>
+
+/**
+ * @file thermocore.h
+ * @brief Stable C API of libthermocore (shared and static library)
+ *
+ * Geometry, fluids and solvers are opaque handles created and destroyed
+ * through this API. A solver copies the geometry and fluids it is created
+ * from, so those handles may be destroyed straight afterwards. Rating,
+ * profile and batch functions write into arrays owned by the caller and
+ * never allocate result storage.
+ *
+ * Every function returning tc_status reports failures through it; no C++
+ * exception crosses the API. tc_last_error() gives the message of the
+ * calling thread's most recent failure.
+ *
+ * Thread safety: different handles may be used concurrently from any
+ * threads. Functions taking a const handle (rating, profile, batch, queries)
+ * may also run concurrently on the same handle. Functions taking a non-const
+ * handle (setters, destroy) need exclusive access to that handle.
+ *
+ * Ratings use the co-current segment march of
+ * NumericalSolver::solveTemperatureDistributionScan() in closed form. Hot is
+ * the shell-side stream and cold the tube-side stream.
+ */
+
+#ifdef _WIN32
+#  ifdef THERMOCORE_BUILD
+#    define TC_EXPORT __declspec(dllexport)
+#  else
+#    define TC_EXPORT
+#  endif
+#else
+#  define TC_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented only for incompatible changes; additions keep the version */
+#define TC_API_VERSION 1
+
+typedef struct tc_geometry tc_geometry;
+typedef struct tc_fluid tc_fluid;
+typedef struct tc_solver tc_solver;
+
+typedef enum tc_status {
+    TC_OK = 0,
+    TC_INVALID_ARGUMENT = 1,    /* Null handle or pointer, or a non-physical value */
+    TC_BUFFER_TOO_SMALL = 2,    /* Caller array shorter than required */
+    TC_OUT_OF_MEMORY = 3,
+    TC_INTERNAL_ERROR = 4
+} tc_status;
+
+typedef struct tc_rating {
+    double hot_outlet;          /* K */
+    double cold_outlet;         /* K */
+    double duty;                /* W */
+    double overall_htc;         /* W/m²·K */
+    double hot_htc;             /* W/m²·K, shell side */
+    double cold_htc;            /* W/m²·K, tube side */
+    double hot_reynolds;
+    double cold_reynolds;
+} tc_rating;
+
+/** @return TC_API_VERSION the library was built with */
+TC_EXPORT int tc_api_version(void);
+
+/** @return Static description of a status code */
+TC_EXPORT const char* tc_status_string(tc_status status);
+
+/** @return Message of the calling thread's last failure ("" if none) */
+TC_EXPORT const char* tc_last_error(void);
+
+/**
+ * Create a shell-and-tube geometry (TC_INVALID_ARGUMENT if the tubes, at
+ * their outer diameter, leave no shell-side flow area)
+ * @param length Exchanger length (m)
+ * @param shell_diameter Shell inner diameter (m)
+ * @param tube_diameter Tube inner diameter (m)
+ * @param tube_thickness Tube wall thickness (m)
+ * @param num_tubes Number of tubes
+ * @param wall_conductivity Tube wall conductivity (W/m·K)
+ * @param out Receives the handle
+ */
+TC_EXPORT tc_status tc_geometry_create(double length, double shell_diameter, double tube_diameter,
+                                       double tube_thickness, int num_tubes, double wall_conductivity,
+                                       tc_geometry** out);
+TC_EXPORT void tc_geometry_destroy(tc_geometry* geometry);
+
+/**
+ * Create a fluid stream with constant properties
+ * @param inlet_temp Inlet temperature (K)
+ * @param mass_flow Mass flow rate (kg/s)
+ * @param specific_heat Specific heat (J/kg·K)
+ * @param density Density (kg/m³)
+ * @param conductivity Thermal conductivity (W/m·K)
+ * @param viscosity Dynamic viscosity (Pa·s)
+ * @param prandtl Prandtl number
+ * @param out Receives the handle
+ */
+TC_EXPORT tc_status tc_fluid_create(double inlet_temp, double mass_flow, double specific_heat, double density,
+                                    double conductivity, double viscosity, double prandtl, tc_fluid** out);
+
+/**
+ * Create a stream from the built-in property data (CommonFluids)
+ * @param name "water", "air" or "oil"
+ * @param temperature Property and inlet temperature (K)
+ * @param mass_flow Mass flow rate (kg/s)
+ * @param out Receives the handle
+ */
+TC_EXPORT tc_status tc_fluid_create_common(const char* name, double temperature, double mass_flow,
+                                           tc_fluid** out);
+TC_EXPORT tc_status tc_fluid_set_inlet(tc_fluid* fluid, double inlet_temp);
+TC_EXPORT tc_status tc_fluid_set_mass_flow(tc_fluid* fluid, double mass_flow);
+TC_EXPORT void tc_fluid_destroy(tc_fluid* fluid);
+
+/**
+ * Create a solver (copies the geometry and both fluids)
+ * @param geometry Exchanger geometry
+ * @param hot Shell-side stream
+ * @param cold Tube-side stream
+ * @param segments Axial segments (at least 1)
+ * @param out Receives the handle
+ */
+TC_EXPORT tc_status tc_solver_create(const tc_geometry* geometry, const tc_fluid* hot, const tc_fluid* cold,
+                                     int segments, tc_solver** out);
+
+/** Change the inlet temperatures (K) and mass flows (kg/s) of both streams */
+TC_EXPORT tc_status tc_solver_set_operating_point(tc_solver* solver, double hot_inlet, double cold_inlet,
+                                                  double hot_flow, double cold_flow);
+TC_EXPORT void tc_solver_destroy(tc_solver* solver);
+
+/** @return Profile stations (segments + 1), or 0 for a null handle */
+TC_EXPORT size_t tc_solver_stations(const tc_solver* solver);
+
+/**
+ * Rate the current operating point
+ * @param solver Solver
+ * @param out Outlets, duty and film coefficients
+ */
+TC_EXPORT tc_status tc_solver_rate(const tc_solver* solver, tc_rating* out);
+
+/**
+ * Temperature profile at every station. The cold array uses the layout of
+ * NumericalSolver results (cold outlet at index 0).
+ * @param solver Solver
+ * @param positions Receives station positions (m); may be NULL
+ * @param hot Receives hot temperatures (K)
+ * @param cold Receives cold temperatures (K)
+ * @param capacity Length of each array; at least tc_solver_stations()
+ */
+TC_EXPORT tc_status tc_solver_profile(const tc_solver* solver, double* positions, double* hot, double* cold,
+                                      size_t capacity);
+
+/**
+ * Rate many operating points of the solver's geometry and fluids.
+ * A NULL input array keeps the solver's value for every point; a NULL output
+ * array is not written. Every point is checked as in
+ * tc_solver_set_operating_point() before any output is written; on
+ * TC_INVALID_ARGUMENT, tc_last_error() names the first bad point. An error
+ * while rating is returned as a status from the calling thread; the outputs
+ * are then partly written.
+ * @param solver Solver
+ * @param count Number of points
+ * @param hot_inlet Hot inlet temperatures (K)
+ * @param cold_inlet Cold inlet temperatures (K)
+ * @param hot_flow Hot mass flows (kg/s)
+ * @param cold_flow Cold mass flows (kg/s)
+ * @param hot_outlet Receives hot outlets (K)
+ * @param cold_outlet Receives cold outlets (K)
+ * @param duty Receives duties (W)
+ * @param num_threads Worker threads (0 = hardware concurrency, 1 = calling thread only)
+ */
+TC_EXPORT tc_status tc_solver_rate_batch(const tc_solver* solver, size_t count,
+                                         const double* hot_inlet, const double* cold_inlet,
+                                         const double* hot_flow, const double* cold_flow,
+                                         double* hot_outlet, double* cold_outlet, double* duty,
+                                         int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THERMOCORE_H */
@@ -0,0 +1,273 @@
+#include "tube_layout.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    const double EPS = 1e-9;
+
+    struct Lattice {
+        double row_pitch;       // Between rows (y)
+        double spacing;         // Between tubes in a row (x)
+        double offset;          // x shift of odd rows
+        double x0;              // Lattice alignment
+        double y0;
+    };
+
+    // Layout geometry shared by counting and coordinate generation
+    struct Bundle {
+        double centre_limit;            // Max radius of a tube centre
+        double lane_half_width;         // Min distance of a tube centre from a lane centre line
+        std::vector<double> horizontal_lanes;
+        bool vertical_lane;
+    };
+
+    Lattice baseLattice(HeatExchangerGeometry::TubeLayout layout, double pitch) {
+        using HeatExchangerGeometry::TubeLayout;
+        switch (layout) {
+            case TubeLayout::RotatedTriangular60:
+                return {0.5 * pitch, std::sqrt(3.0) * pitch, 0.5 * std::sqrt(3.0) * pitch, 0.0, 0.0};
+            case TubeLayout::Square90:
+                return {pitch, pitch, 0.0, 0.0, 0.0};
+            case TubeLayout::RotatedSquare45:
+                return {pitch / std::sqrt(2.0), std::sqrt(2.0) * pitch, pitch / std::sqrt(2.0), 0.0, 0.0};
+            case TubeLayout::Triangular30:
+            default:
+                return {0.5 * std::sqrt(3.0) * pitch, pitch, 0.5 * pitch, 0.0, 0.0};
+        }
+    }
+
+    double rowY(const Lattice& lattice, long long j) {
+        return lattice.y0 + j * lattice.row_pitch;
+    }
+
+    double rowShift(const Lattice& lattice, long long j) {
+        return lattice.x0 + ((j & 1) ? lattice.offset : 0.0);
+    }
+
+    double tubeX(const Lattice& lattice, long long j, long long i) {
+        return rowShift(lattice, j) + i * lattice.spacing;
+    }
+
+    bool inHorizontalLane(const Bundle& bundle, double y) {
+        for (double lane : bundle.horizontal_lanes) {
+            if (std::abs(y - lane) < bundle.lane_half_width - EPS) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Index ranges [first, last] of tubes in row j (up to two when a vertical lane splits the row)
+    int rowRanges(const Lattice& lattice, const Bundle& bundle, long long j, long long ranges[2][2]) {
+        double y = rowY(lattice, j);
+        double R = bundle.centre_limit;
+        if (std::abs(y) > R + EPS || inHorizontalLane(bundle, y)) {
+            return 0;
+        }
+        double chord = std::sqrt(std::max(0.0, R * R - y * y));
+        double shift = rowShift(lattice, j);
+        double s = lattice.spacing;
+        long long first = static_cast<long long>(std::ceil((-chord - shift) / s - EPS));
+        long long last = static_cast<long long>(std::floor((chord - shift) / s + EPS));
+        if (first > last) {
+            return 0;
+        }
+        if (!bundle.vertical_lane) {
+            ranges[0][0] = first;
+            ranges[0][1] = last;
+            return 1;
+        }
+
+        double h = bundle.lane_half_width;
+        long long left_last = static_cast<long long>(std::floor((-h - shift) / s + EPS));
+        long long right_first = static_cast<long long>(std::ceil((h - shift) / s - EPS));
+        int count = 0;
+        if (first <= std::min(last, left_last)) {
+            ranges[count][0] = first;
+            ranges[count][1] = std::min(last, left_last);
+            ++count;
+        }
+        if (std::max(first, right_first) <= last) {
+            ranges[count][0] = std::max(first, right_first);
+            ranges[count][1] = last;
+            ++count;
+        }
+        return count;
+    }
+
+    long long rowLimit(const Lattice& lattice, const Bundle& bundle, bool upper) {
+        double bound = upper ? (bundle.centre_limit - lattice.y0) / lattice.row_pitch
+                             : (-bundle.centre_limit - lattice.y0) / lattice.row_pitch;
+        return upper ? static_cast<long long>(std::floor(bound + EPS))
+                     : static_cast<long long>(std::ceil(bound - EPS));
+    }
+
+    long long countLattice(const Lattice& lattice, const Bundle& bundle) {
+        long long total = 0;
+        long long ranges[2][2];
+        for (long long j = rowLimit(lattice, bundle, false); j <= rowLimit(lattice, bundle, true); ++j) {
+            int n = rowRanges(lattice, bundle, j, ranges);
+            for (int r = 0; r < n; ++r) {
+                total += ranges[r][1] - ranges[r][0] + 1;
+            }
+        }
+        return total;
+    }
+}
+
+TubeLayoutSpec::TubeLayoutSpec()
+    : shell_diameter(0), tube_outer_diameter(0), pitch_ratio(1.25),
+      layout(HeatExchangerGeometry::TubeLayout::Triangular30), bundle_clearance(0.015),
+      tube_passes(1), pass_lane_width(0.016), tie_rods(-1) {}
+
+TubeLayoutSpec::TubeLayoutSpec(double D_shell, double tube_od, double ratio,
+                               HeatExchangerGeometry::TubeLayout pattern)
+    : shell_diameter(D_shell), tube_outer_diameter(tube_od), pitch_ratio(ratio), layout(pattern),
+      bundle_clearance(0.015), tube_passes(1), pass_lane_width(0.016), tie_rods(-1) {}
+
+namespace TubeLayoutGenerator {
+
+    int minimumTieRods(double shell_diameter) {
+        // TEMA R-4.71 (shell diameter converted from inches)
+        double inches = shell_diameter / 0.0254;
+        if (inches < 15.0) return 4;
+        if (inches < 33.0) return 6;
+        if (inches < 49.0) return 8;
+        if (inches < 61.0) return 10;
+        return 12;
+    }
+
+    TubeLayoutResult generate(const TubeLayoutSpec& spec, bool with_coordinates) {
+        if (spec.shell_diameter <= 0.0 || spec.tube_outer_diameter <= 0.0 || spec.pitch_ratio < 1.0) {
+            throw std::invalid_argument("Tube layout needs positive diameters and a pitch ratio of at least 1");
+        }
+        if (spec.tube_passes < 1 || (spec.tube_passes > 1 && spec.tube_passes % 2 != 0)) {
+            throw std::invalid_argument("Tube passes must be 1 or an even number");
+        }
+
+        TubeLayoutResult result;
+        result.num_tubes = 0;
+        result.tie_rods = 0;
+        result.rows = 0;
+        result.outer_tube_limit = spec.shell_diameter - spec.bundle_clearance;
+
+        Bundle bundle;
+        bundle.centre_limit = (result.outer_tube_limit - spec.tube_outer_diameter) / 2.0;
+        bundle.lane_half_width = (spec.pass_lane_width + spec.tube_outer_diameter) / 2.0;
+        if (bundle.centre_limit <= 0.0) {
+            return result;
+        }
+
+        // Partition lanes: 2 passes split top/bottom; 4+ passes add a vertical lane and
+        // split each half into passes/2 bands
+        int horizontal = 0;
+        bundle.vertical_lane = spec.tube_passes >= 4;
+        if (spec.tube_passes == 2) {
+            horizontal = 1;
+        } else if (spec.tube_passes >= 4) {
+            horizontal = spec.tube_passes / 2 - 1;
+        }
+        for (int k = 1; k <= horizontal; ++k) {
+            bundle.horizontal_lanes.push_back(-bundle.centre_limit + 2.0 * bundle.centre_limit * k / (horizontal + 1));
+        }
+
+        // Densest of the four lattice alignments
+        double pitch = HeatExchangerGeometry::tubePitch(spec.tube_outer_diameter, spec.pitch_ratio);
+        Lattice best = baseLattice(spec.layout, pitch);
+        long long best_count = -1;
+        for (int a = 0; a < 4; ++a) {
+            Lattice candidate = baseLattice(spec.layout, pitch);
+            candidate.x0 = (a & 1) ? 0.5 * candidate.spacing : 0.0;
+            candidate.y0 = (a & 2) ? 0.5 * candidate.row_pitch : 0.0;
+            long long count = countLattice(candidate, bundle);
+            if (count > best_count) {
+                best_count = count;
+                best = candidate;
+            }
+        }
+
+        // Tie rods take the row-end holes closest to evenly spaced angles
+        struct Hole {
+            double x, y, angle;
+            bool taken;
+        };
+        std::vector<Hole> row_ends;
+        long long ranges[2][2];
+        long long j_min = rowLimit(best, bundle, false);
+        long long j_max = rowLimit(best, bundle, true);
+        for (long long j = j_min; j <= j_max; ++j) {
+            int n = rowRanges(best, bundle, j, ranges);
+            if (n == 0) {
+                continue;
+            }
+            ++result.rows;
+            double y = rowY(best, j);
+            double x_left = tubeX(best, j, ranges[0][0]);
+            double x_right = tubeX(best, j, ranges[n - 1][1]);
+            row_ends.push_back({x_left, y, std::atan2(y, x_left), false});
+            if (ranges[n - 1][1] != ranges[0][0] || n > 1) {
+                row_ends.push_back({x_right, y, std::atan2(y, x_right), false});
+            }
+        }
+
+        int rods = (spec.tie_rods < 0) ? minimumTieRods(spec.shell_diameter) : spec.tie_rods;
+        rods = static_cast<int>(std::min<long long>(rods, static_cast<long long>(row_ends.size())));
+        for (int k = 0; k < rods; ++k) {
+            double target = -M_PI + (2.0 * k + 1.0) * M_PI / rods;
+            int chosen = -1;
+            double chosen_gap = 1e300;
+            for (size_t h = 0; h < row_ends.size(); ++h) {
+                if (row_ends[h].taken) {
+                    continue;
+                }
+                double gap = std::abs(std::remainder(row_ends[h].angle - target, 2.0 * M_PI));
+                if (gap < chosen_gap) {
+                    chosen_gap = gap;
+                    chosen = static_cast<int>(h);
+                }
+            }
+            row_ends[chosen].taken = true;
+            result.tie_rod_x.push_back(row_ends[chosen].x);
+            result.tie_rod_y.push_back(row_ends[chosen].y);
+        }
+        result.tie_rods = rods;
+        result.num_tubes = static_cast<int>(best_count) - rods;
+
+        if (with_coordinates) {
+            result.x.reserve(result.num_tubes);
+            result.y.reserve(result.num_tubes);
+            for (long long j = j_min; j <= j_max; ++j) {
+                int n = rowRanges(best, bundle, j, ranges);
+                double y = rowY(best, j);
+                for (int r = 0; r < n; ++r) {
+                    for (long long i = ranges[r][0]; i <= ranges[r][1]; ++i) {
+                        double x = tubeX(best, j, i);
+                        bool tie_rod = false;
+                        for (int k = 0; k < rods && !tie_rod; ++k) {
+                            tie_rod = (result.tie_rod_x[k] == x && result.tie_rod_y[k] == y);
+                        }
+                        if (!tie_rod) {
+                            result.x.push_back(x);
+                            result.y.push_back(y);
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    int countTubes(const TubeLayoutSpec& spec) {
+        return generate(spec, false).num_tubes;
+    }
+
+    int maxTubes(double shell_diameter, double tube_outer_diameter, double pitch_ratio) {
+        return countTubes(TubeLayoutSpec(shell_diameter, tube_outer_diameter, pitch_ratio));
+    }
+
+} // namespace TubeLayoutGenerator
@@ -0,0 +1,86 @@
+#ifndef TUBE_LAYOUT_H
+#define TUBE_LAYOUT_H
+
+#include <vector>
+#include "heat_exchanger_geometry.h"
+
+/**
+ * @file tube_layout.h
+ * @brief Exact tube counts and coordinates for a shell tubesheet
+ *
+ * Tubes are placed on the chosen pitch pattern within the outer tube limit
+ * (OTL). Horizontal and vertical pass-partition lanes are kept clear, and tie
+ * rods replace tubes on the periphery. Cross flow runs along y. Each pattern
+ * is a set of rows parallel to x:
+ *   30° triangular        rows 0.866 Pt apart, tubes Pt apart, alternate rows offset Pt/2
+ *   60° rotated triangular rows 0.5 Pt apart, tubes 1.732 Pt apart, offset 0.866 Pt
+ *   90° square            rows Pt apart, tubes Pt apart
+ *   45° rotated square    rows 0.707 Pt apart, tubes 1.414 Pt apart, offset 0.707 Pt
+ * Counting takes O(rows) using the exact chord of each row, so it is cheap
+ * enough for sizing loops. The four lattice alignments (tube or gap on each
+ * centre line) are tried and the densest is kept.
+ */
+
+struct TubeLayoutSpec {
+    double shell_diameter;          // Shell inner diameter (m)
+    double tube_outer_diameter;     // m
+    double pitch_ratio;             // Pitch / tube OD
+    HeatExchangerGeometry::TubeLayout layout;
+    double bundle_clearance;        // Shell ID minus OTL diameter (m)
+    int tube_passes;                // 1, 2, 4, 6, 8, ... (sets the pass-partition lanes)
+    double pass_lane_width;         // Clear gap between tube walls across a partition lane (m)
+    int tie_rods;                   // -1 = TEMA minimum for the shell diameter
+
+    TubeLayoutSpec();
+    TubeLayoutSpec(double D_shell, double tube_od, double ratio = 1.25,
+                   HeatExchangerGeometry::TubeLayout pattern = HeatExchangerGeometry::TubeLayout::Triangular30);
+};
+
+struct TubeLayoutResult {
+    int num_tubes;                  // Tube holes excluding tie rods
+    int tie_rods;
+    int rows;                       // Rows holding at least one tube or tie rod
+    double outer_tube_limit;        // OTL diameter (m)
+    std::vector<double> x;          // Tube centres (m), shell centre at the origin
+    std::vector<double> y;
+    std::vector<double> tie_rod_x;
+    std::vector<double> tie_rod_y;
+};
+
+namespace TubeLayoutGenerator {
+
+    /**
+     * Lay out tubes in the shell
+     * @param spec Shell, tube, pitch, lanes and tie rods
+     * @param with_coordinates false to count only (no per-tube storage)
+     * @return Exact tube count, and coordinates when requested
+     */
+    TubeLayoutResult generate(const TubeLayoutSpec& spec, bool with_coordinates = true);
+
+    /**
+     * Exact tube count (same as generate(spec, false).num_tubes)
+     * @param spec Shell, tube, pitch, lanes and tie rods
+     * @return Number of tubes
+     */
+    int countTubes(const TubeLayoutSpec& spec);
+
+    /**
+     * Exact replacement for HeatExchangerGeometry::estimateMaxTubes(): single-pass
+     * 30° triangular layout with the default clearance and TEMA tie rods
+     * @param shell_diameter Shell diameter (m)
+     * @param tube_outer_diameter Tube outer diameter (m)
+     * @param pitch_ratio Pitch to diameter ratio
+     * @return Number of tubes
+     */
+    int maxTubes(double shell_diameter, double tube_outer_diameter, double pitch_ratio = 1.25);
+
+    /**
+     * TEMA minimum number of tie rods for a shell diameter
+     * @param shell_diameter Shell inner diameter (m)
+     * @return Tie rod count
+     */
+    int minimumTieRods(double shell_diameter);
+
+} // namespace TubeLayoutGenerator
+
+#endif // TUBE_LAYOUT_H
@@ -0,0 +1,778 @@
+#include "user_correlations.h"
+#include "heat_transfer_correlations.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace UserCorrelations {
+
+    namespace {
+        enum Op : std::uint8_t {
+            OP_LOAD_VAR, OP_LOAD_TEMP, OP_LOAD_CONST, OP_STORE_TEMP,
+            OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_MIN, OP_MAX,
+            OP_ADD_C, OP_SUB_C, OP_RSUB_C, OP_MUL_C, OP_DIV_C, OP_RDIV_C, OP_POW_C, OP_RPOW_C, OP_MIN_C, OP_MAX_C,
+            OP_NEG, OP_SQUARE, OP_SQRT, OP_RECIP, OP_EXP, OP_LOG, OP_LOG10, OP_ABS
+        };
+
+        const char* const OP_NAMES[] = {
+            "load_var", "load_temp", "load_const", "store_temp",
+            "add", "sub", "mul", "div", "pow", "min", "max",
+            "add_c", "sub_c", "rsub_c", "mul_c", "div_c", "rdiv_c", "pow_c", "rpow_c", "min_c", "max_c",
+            "neg", "square", "sqrt", "recip", "exp", "log", "log10", "abs"
+        };
+
+        const char* const VARIABLE_NAMES[VARIABLE_COUNT] = {"Re", "Pr", "d_L", "do_di", "Ds_d", "Nt"};
+
+        // Shared by constant folding and the interpreter so folded and run-time results agree
+        double applyBinary(Op op, double a, double b) {
+            switch (op) {
+                case OP_ADD: return a + b;
+                case OP_SUB: return a - b;
+                case OP_MUL: return a * b;
+                case OP_DIV: return a / b;
+                case OP_POW: return std::pow(a, b);
+                case OP_MIN: return std::min(a, b);
+                case OP_MAX: return std::max(a, b);
+                default: return std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+
+        double applyUnary(Op op, double a) {
+            switch (op) {
+                case OP_NEG: return -a;
+                case OP_SQUARE: return a * a;
+                case OP_SQRT: return std::sqrt(a);
+                case OP_RECIP: return 1.0 / a;
+                case OP_EXP: return std::exp(a);
+                case OP_LOG: return std::log(a);
+                case OP_LOG10: return std::log10(a);
+                case OP_ABS: return std::fabs(a);
+                default: return std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+
+        double builtinNusselt(Side side, double reynolds, double prandtl) {
+            return side == Side::Tube ? HeatTransferCorrelations::getTubeSideNusselt(reynolds, prandtl, true)
+                                      : HeatTransferCorrelations::getShellSideNusselt(reynolds, prandtl);
+        }
+
+        void geometryValues(const GeometryRatios& ratios, double values[VARIABLE_COUNT]) {
+            values[REYNOLDS] = 0.0;
+            values[PRANDTL] = 0.0;
+            values[DIAMETER_OVER_LENGTH] = ratios.diameter_over_length;
+            values[OUTER_OVER_INNER] = ratios.outer_over_inner;
+            values[SHELL_OVER_TUBE] = ratios.shell_over_tube;
+            values[TUBE_COUNT] = ratios.tube_count;
+        }
+
+        struct CompileError : std::runtime_error {
+            explicit CompileError(const std::string& message) : std::runtime_error(message) {}
+        };
+
+        // Expression tree; constant subtrees are folded as they are built
+        struct Node {
+            enum Kind { NUMBER, VARIABLE, TEMPORARY, UNARY, BINARY } kind;
+            double value;
+            int index;
+            Op op;
+            std::unique_ptr<Node> left, right;
+
+            bool isNumber() const { return kind == NUMBER; }
+        };
+
+        std::unique_ptr<Node> number(double value) {
+            std::unique_ptr<Node> node(new Node());
+            node->kind = Node::NUMBER;
+            node->value = value;
+            return node;
+        }
+
+        std::unique_ptr<Node> unary(Op op, std::unique_ptr<Node> operand) {
+            if (operand->isNumber()) {
+                return number(applyUnary(op, operand->value));
+            }
+            std::unique_ptr<Node> node(new Node());
+            node->kind = Node::UNARY;
+            node->op = op;
+            node->left = std::move(operand);
+            return node;
+        }
+
+        std::unique_ptr<Node> binary(Op op, std::unique_ptr<Node> a, std::unique_ptr<Node> b) {
+            if (a->isNumber() && b->isNumber()) {
+                return number(applyBinary(op, a->value, b->value));
+            }
+            std::unique_ptr<Node> node(new Node());
+            node->kind = Node::BINARY;
+            node->op = op;
+            node->left = std::move(a);
+            node->right = std::move(b);
+            return node;
+        }
+
+        /**
+         * Recursive-descent parser for one expression:
+         *   sum     = product { (+|-) product }
+         *   product = signed { (*|/) signed }
+         *   signed  = - signed | power
+         *   power   = primary [ ^ signed ]
+         *   primary = number | name | name ( args ) | ( sum )
+         */
+        class Parser {
+        public:
+            Parser(const std::string& text, const std::vector<std::string>& temporaries,
+                   const std::vector<std::unique_ptr<Node>>& temporary_values)
+                : text(text), pos(0), temporaries(temporaries), temporary_values(temporary_values) {}
+
+            std::unique_ptr<Node> parse() {
+                std::unique_ptr<Node> node = sum();
+                skipSpace();
+                if (pos != text.size()) {
+                    throw CompileError("unexpected '" + text.substr(pos) + "'");
+                }
+                return node;
+            }
+
+        private:
+            const std::string& text;
+            size_t pos;
+            const std::vector<std::string>& temporaries;
+            const std::vector<std::unique_ptr<Node>>& temporary_values;
+
+            void skipSpace() {
+                while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                    ++pos;
+                }
+            }
+
+            bool accept(char c) {
+                skipSpace();
+                if (pos < text.size() && text[pos] == c) {
+                    ++pos;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c) {
+                if (!accept(c)) {
+                    throw CompileError(std::string("expected '") + c + "'");
+                }
+            }
+
+            std::unique_ptr<Node> sum() {
+                std::unique_ptr<Node> node = product();
+                for (;;) {
+                    if (accept('+')) {
+                        node = binary(OP_ADD, std::move(node), product());
+                    } else if (accept('-')) {
+                        node = binary(OP_SUB, std::move(node), product());
+                    } else {
+                        return node;
+                    }
+                }
+            }
+
+            std::unique_ptr<Node> product() {
+                std::unique_ptr<Node> node = signedTerm();
+                for (;;) {
+                    if (accept('*')) {
+                        node = binary(OP_MUL, std::move(node), signedTerm());
+                    } else if (accept('/')) {
+                        node = binary(OP_DIV, std::move(node), signedTerm());
+                    } else {
+                        return node;
+                    }
+                }
+            }
+
+            std::unique_ptr<Node> signedTerm() {
+                if (accept('-')) {
+                    return unary(OP_NEG, signedTerm());
+                }
+                accept('+');
+                return power();
+            }
+
+            std::unique_ptr<Node> power() {
+                std::unique_ptr<Node> base = primary();
+                if (accept('^')) {
+                    return binary(OP_POW, std::move(base), signedTerm());
+                }
+                return base;
+            }
+
+            std::unique_ptr<Node> primary() {
+                skipSpace();
+                if (pos >= text.size()) {
+                    throw CompileError("expression ends early");
+                }
+                if (accept('(')) {
+                    std::unique_ptr<Node> node = sum();
+                    expect(')');
+                    return node;
+                }
+                char c = text[pos];
+                if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                    const char* start = text.c_str() + pos;
+                    char* end = nullptr;
+                    double value = std::strtod(start, &end);
+                    if (end == start) {
+                        throw CompileError("bad number");
+                    }
+                    pos += static_cast<size_t>(end - start);
+                    return number(value);
+                }
+                if (!std::isalpha(static_cast<unsigned char>(c)) && c != '_') {
+                    throw CompileError(std::string("unexpected '") + c + "'");
+                }
+                size_t start = pos;
+                while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) {
+                    ++pos;
+                }
+                std::string name = text.substr(start, pos - start);
+                if (accept('(')) {
+                    return call(name);
+                }
+                for (int v = 0; v < VARIABLE_COUNT; ++v) {
+                    if (name == VARIABLE_NAMES[v]) {
+                        std::unique_ptr<Node> node(new Node());
+                        node->kind = Node::VARIABLE;
+                        node->index = v;
+                        return node;
+                    }
+                }
+                for (size_t t = 0; t < temporaries.size(); ++t) {
+                    if (name == temporaries[t]) {
+                        if (temporary_values[t]) {
+                            return number(temporary_values[t]->value);    // Constant let binding
+                        }
+                        std::unique_ptr<Node> node(new Node());
+                        node->kind = Node::TEMPORARY;
+                        node->index = static_cast<int>(t);
+                        return node;
+                    }
+                }
+                throw CompileError("unknown variable '" + name + "'");
+            }
+
+            std::unique_ptr<Node> call(const std::string& name) {
+                std::unique_ptr<Node> first = sum();
+                if (name == "pow" || name == "min" || name == "max") {
+                    expect(',');
+                    std::unique_ptr<Node> second = sum();
+                    expect(')');
+                    Op op = name == "pow" ? OP_POW : (name == "min" ? OP_MIN : OP_MAX);
+                    return binary(op, std::move(first), std::move(second));
+                }
+                expect(')');
+                if (name == "exp") return unary(OP_EXP, std::move(first));
+                if (name == "log") return unary(OP_LOG, std::move(first));
+                if (name == "log10") return unary(OP_LOG10, std::move(first));
+                if (name == "sqrt") return unary(OP_SQRT, std::move(first));
+                if (name == "abs") return unary(OP_ABS, std::move(first));
+                throw CompileError("unknown function '" + name + "'");
+            }
+        };
+
+        thread_local std::vector<double> interpreter_scratch;
+    }
+
+    GeometryRatios::GeometryRatios()
+        : diameter_over_length(0.0), outer_over_inner(1.0), shell_over_tube(0.0), tube_count(0.0) {}
+
+    GeometryRatios GeometryRatios::fromGeometry(const GeometryProperties& geometry) {
+        GeometryRatios ratios;
+        ratios.diameter_over_length = geometry.tube_diameter / geometry.length;
+        ratios.outer_over_inner = (geometry.tube_diameter + 2.0 * geometry.tube_thickness) / geometry.tube_diameter;
+        ratios.shell_over_tube = geometry.shell_diameter / geometry.tube_diameter;
+        ratios.tube_count = geometry.num_tubes;
+        return ratios;
+    }
+
+    /**
+     * Turns expression trees into stack bytecode, folding constant operands into
+     * the instruction that uses them
+     */
+    class Compiler {
+    public:
+        explicit Compiler(Correlation& target) : target(target), depth(0) {}
+
+        void emitStore(const Node& node, int temporary) {
+            emit(node);
+            push(OP_STORE_TEMP, temporary);
+            --depth;
+        }
+
+        void emitResult(const Node& node) {
+            emit(node);
+        }
+
+    private:
+        Correlation& target;
+        int depth;
+
+        void push(Op op, std::int32_t operand = 0) {
+            target.code.push_back(Instruction{static_cast<std::uint8_t>(op), operand});
+        }
+
+        void grow() {
+            ++depth;
+            target.stack_depth = std::max(target.stack_depth, depth);
+        }
+
+        std::int32_t constant(double value) {
+            target.constants.push_back(value);
+            return static_cast<std::int32_t>(target.constants.size() - 1);
+        }
+
+        void emitConstantOperand(Op op, double value) {
+            if (op == OP_POW_C) {
+                if (value == 1.0) return;
+                if (value == 2.0) { push(OP_SQUARE); return; }
+                if (value == 0.5) { push(OP_SQRT); return; }
+                if (value == -1.0) { push(OP_RECIP); return; }
+            }
+            if (op == OP_RDIV_C && value == 1.0) {
+                push(OP_RECIP);
+                return;
+            }
+            push(op, constant(value));
+        }
+
+        void emit(const Node& node) {
+            switch (node.kind) {
+                case Node::NUMBER:
+                    push(OP_LOAD_CONST, constant(node.value));
+                    grow();
+                    return;
+                case Node::VARIABLE:
+                    target.uses_variable[node.index] = true;
+                    push(OP_LOAD_VAR, node.index);
+                    grow();
+                    return;
+                case Node::TEMPORARY:
+                    push(OP_LOAD_TEMP, node.index);
+                    grow();
+                    return;
+                case Node::UNARY:
+                    emit(*node.left);
+                    push(node.op);
+                    return;
+                case Node::BINARY:
+                    break;
+            }
+
+            const Node& a = *node.left;
+            const Node& b = *node.right;
+            if (b.isNumber()) {
+                static const Op with_constant[] = {
+                    OP_ADD_C, OP_SUB_C, OP_MUL_C, OP_DIV_C, OP_POW_C, OP_MIN_C, OP_MAX_C
+                };
+                emit(a);
+                emitConstantOperand(with_constant[node.op - OP_ADD], b.value);
+                return;
+            }
+            if (a.isNumber()) {
+                static const Op constant_first[] = {
+                    OP_ADD_C, OP_RSUB_C, OP_MUL_C, OP_RDIV_C, OP_RPOW_C, OP_MIN_C, OP_MAX_C
+                };
+                emit(b);
+                emitConstantOperand(constant_first[node.op - OP_ADD], a.value);
+                return;
+            }
+            emit(a);
+            emit(b);
+            push(node.op);
+            --depth;
+        }
+    };
+
+    Correlation::Correlation()
+        : correlation_side(Side::Tube), outside(OutsideRange::Builtin), temporaries(0), stack_depth(0) {
+        for (int v = 0; v < VARIABLE_COUNT; ++v) {
+            valid_min[v] = -HUGE_VAL;
+            valid_max[v] = HUGE_VAL;
+            uses_variable[v] = false;
+        }
+    }
+
+    bool Correlation::usesGeometry() const {
+        for (int v = DIAMETER_OVER_LENGTH; v < VARIABLE_COUNT; ++v) {
+            if (uses_variable[v] || valid_min[v] > -HUGE_VAL || valid_max[v] < HUGE_VAL) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Correlation::inRange(double reynolds, double prandtl, const GeometryRatios& ratios) const {
+        double values[VARIABLE_COUNT];
+        geometryValues(ratios, values);
+        values[REYNOLDS] = reynolds;
+        values[PRANDTL] = prandtl;
+        for (int v = 0; v < VARIABLE_COUNT; ++v) {
+            if (!(values[v] >= valid_min[v] && values[v] <= valid_max[v])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double Correlation::evaluate(double reynolds, double prandtl, const GeometryRatios& ratios) const {
+        double nusselt;
+        evaluate(&reynolds, &prandtl, 1, ratios, &nusselt);
+        return nusselt;
+    }
+
+    void Correlation::evaluate(const double* reynolds, const double* prandtl, std::size_t count,
+                               const GeometryRatios& ratios, double* nusselt) const {
+        // Operand stack, temporaries, clamped Re and Pr, and one block per geometry variable
+        size_t blocks = static_cast<size_t>(stack_depth + temporaries + 2 + VARIABLE_COUNT);
+        std::vector<double>& scratch = interpreter_scratch;
+        if (scratch.size() < blocks * BLOCK) {
+            scratch.resize(blocks * BLOCK);
+        }
+        for (std::size_t start = 0; start < count; start += BLOCK) {
+            int n = static_cast<int>(std::min<std::size_t>(BLOCK, count - start));
+            evaluateBlock(reynolds + start, prandtl + start, n, ratios, nusselt + start, scratch.data());
+        }
+    }
+
+    void Correlation::evaluateBlock(const double* reynolds, const double* prandtl, int n,
+                                    const GeometryRatios& ratios, double* nusselt, double* scratch) const {
+        double* stack = scratch;
+        double* temps = stack + static_cast<size_t>(stack_depth) * BLOCK;
+        double* clamped = temps + static_cast<size_t>(temporaries) * BLOCK;
+        double* geometry_blocks = clamped + 2 * BLOCK;
+
+        double scalars[VARIABLE_COUNT];
+        geometryValues(ratios, scalars);
+        bool geometry_valid = true;
+        for (int v = DIAMETER_OVER_LENGTH; v < VARIABLE_COUNT; ++v) {
+            if (!(scalars[v] >= valid_min[v] && scalars[v] <= valid_max[v])) {
+                geometry_valid = false;
+                scalars[v] = std::max(valid_min[v], std::min(valid_max[v], scalars[v]));
+            }
+        }
+        if (!geometry_valid && outside == OutsideRange::Builtin) {
+            for (int i = 0; i < n; ++i) {
+                nusselt[i] = builtinNusselt(correlation_side, reynolds[i], prandtl[i]);
+            }
+            return;
+        }
+
+        // Columns the program reads; inputs are used in place unless clamped
+        const double* columns[VARIABLE_COUNT] = {reynolds, prandtl};
+        if (outside == OutsideRange::Clamp) {
+            for (int i = 0; i < n; ++i) {
+                clamped[i] = std::max(valid_min[REYNOLDS], std::min(valid_max[REYNOLDS], reynolds[i]));
+                clamped[BLOCK + i] = std::max(valid_min[PRANDTL], std::min(valid_max[PRANDTL], prandtl[i]));
+            }
+            columns[REYNOLDS] = clamped;
+            columns[PRANDTL] = clamped + BLOCK;
+        }
+        for (int v = DIAMETER_OVER_LENGTH; v < VARIABLE_COUNT; ++v) {
+            if (uses_variable[v]) {
+                double* block = geometry_blocks + static_cast<size_t>(v) * BLOCK;
+                std::fill(block, block + n, scalars[v]);
+                columns[v] = block;
+            }
+        }
+
+        // Each stack level is a block; top[] points at the level's values, which
+        // may be an input column that has not been copied
+        const double* top[64];
+        int level = -1;
+        const double* k = constants.data();
+        for (const Instruction& instruction : code) {
+            double* out = stack + static_cast<size_t>(level < 0 ? 0 : level) * BLOCK;
+            const double* a = level >= 0 ? top[level] : nullptr;
+            switch (instruction.op) {
+                case OP_LOAD_VAR:
+                    top[++level] = columns[instruction.operand];
+                    break;
+                case OP_LOAD_TEMP:
+                    top[++level] = temps + static_cast<size_t>(instruction.operand) * BLOCK;
+                    break;
+                case OP_LOAD_CONST: {
+                    double* slot = stack + static_cast<size_t>(++level) * BLOCK;
+                    std::fill(slot, slot + n, k[instruction.operand]);
+                    top[level] = slot;
+                    break;
+                }
+                case OP_STORE_TEMP: {
+                    double* slot = temps + static_cast<size_t>(instruction.operand) * BLOCK;
+                    std::copy(a, a + n, slot);
+                    --level;
+                    break;
+                }
+                case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_POW: case OP_MIN: case OP_MAX: {
+                    const double* x = top[level - 1];
+                    const double* y = a;
+                    out = stack + static_cast<size_t>(level - 1) * BLOCK;
+                    switch (instruction.op) {
+                        case OP_ADD: for (int i = 0; i < n; ++i) out[i] = x[i] + y[i]; break;
+                        case OP_SUB: for (int i = 0; i < n; ++i) out[i] = x[i] - y[i]; break;
+                        case OP_MUL: for (int i = 0; i < n; ++i) out[i] = x[i] * y[i]; break;
+                        case OP_DIV: for (int i = 0; i < n; ++i) out[i] = x[i] / y[i]; break;
+                        case OP_POW: for (int i = 0; i < n; ++i) out[i] = std::pow(x[i], y[i]); break;
+                        case OP_MIN: for (int i = 0; i < n; ++i) out[i] = std::min(x[i], y[i]); break;
+                        default: for (int i = 0; i < n; ++i) out[i] = std::max(x[i], y[i]); break;
+                    }
+                    top[--level] = out;
+                    break;
+                }
+                case OP_ADD_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = a[i] + c; top[level] = out; break; }
+                case OP_SUB_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = a[i] - c; top[level] = out; break; }
+                case OP_RSUB_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = c - a[i]; top[level] = out; break; }
+                case OP_MUL_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = a[i] * c; top[level] = out; break; }
+                case OP_DIV_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = a[i] / c; top[level] = out; break; }
+                case OP_RDIV_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = c / a[i]; top[level] = out; break; }
+                case OP_POW_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = std::pow(a[i], c); top[level] = out; break; }
+                case OP_RPOW_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = std::pow(c, a[i]); top[level] = out; break; }
+                case OP_MIN_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = std::min(a[i], c); top[level] = out; break; }
+                case OP_MAX_C: { double c = k[instruction.operand]; for (int i = 0; i < n; ++i) out[i] = std::max(a[i], c); top[level] = out; break; }
+                case OP_NEG: for (int i = 0; i < n; ++i) out[i] = -a[i]; top[level] = out; break;
+                case OP_SQUARE: for (int i = 0; i < n; ++i) out[i] = a[i] * a[i]; top[level] = out; break;
+                case OP_SQRT: for (int i = 0; i < n; ++i) out[i] = std::sqrt(a[i]); top[level] = out; break;
+                case OP_RECIP: for (int i = 0; i < n; ++i) out[i] = 1.0 / a[i]; top[level] = out; break;
+                case OP_EXP: for (int i = 0; i < n; ++i) out[i] = std::exp(a[i]); top[level] = out; break;
+                case OP_LOG: for (int i = 0; i < n; ++i) out[i] = std::log(a[i]); top[level] = out; break;
+                case OP_LOG10: for (int i = 0; i < n; ++i) out[i] = std::log10(a[i]); top[level] = out; break;
+                case OP_ABS: for (int i = 0; i < n; ++i) out[i] = std::fabs(a[i]); top[level] = out; break;
+            }
+        }
+        std::copy(top[0], top[0] + n, nusselt);
+
+        if (outside == OutsideRange::Builtin) {
+            for (int i = 0; i < n; ++i) {
+                if (!(reynolds[i] >= valid_min[REYNOLDS] && reynolds[i] <= valid_max[REYNOLDS] &&
+                      prandtl[i] >= valid_min[PRANDTL] && prandtl[i] <= valid_max[PRANDTL])) {
+                    nusselt[i] = builtinNusselt(correlation_side, reynolds[i], prandtl[i]);
+                }
+            }
+        }
+    }
+
+    bool CorrelationLibrary::load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "Could not open correlation file " + path;
+            return false;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+        return compile(text.str(), path, error);
+    }
+
+    bool CorrelationLibrary::compile(const std::string& source, const std::string& source_name, std::string& error) {
+        std::vector<std::shared_ptr<const Correlation>> compiled;
+        std::istringstream lines(source);
+        std::string line;
+        int line_number = 0;
+
+        std::shared_ptr<Correlation> current;
+        std::unique_ptr<Compiler> compiler;
+        std::vector<std::string> temporary_names;
+        std::vector<std::unique_ptr<Node>> temporary_values;    // Folded constant, or null if computed per point
+        bool side_given = false;
+        bool result_given = false;
+
+        try {
+            while (std::getline(lines, line)) {
+                ++line_number;
+                size_t comment = line.find('#');
+                if (comment != std::string::npos) {
+                    line.erase(comment);
+                }
+                std::istringstream fields(line);
+                std::string keyword;
+                if (!(fields >> keyword)) {
+                    continue;
+                }
+
+                if (keyword == "correlation") {
+                    if (current) {
+                        throw CompileError("missing 'end' before 'correlation'");
+                    }
+                    std::string name;
+                    std::getline(fields >> std::ws, name);
+                    while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back()))) {
+                        name.pop_back();
+                    }
+                    if (name.empty()) {
+                        throw CompileError("correlation needs a name");
+                    }
+                    for (const auto& existing : correlations) {
+                        if (existing->name() == name) throw CompileError("correlation '" + name + "' is already loaded");
+                    }
+                    for (const auto& existing : compiled) {
+                        if (existing->name() == name) throw CompileError("correlation '" + name + "' is defined twice");
+                    }
+                    current.reset(new Correlation());
+                    current->correlation_name = name;
+                    compiler.reset(new Compiler(*current));
+                    temporary_names.clear();
+                    temporary_values.clear();
+                    side_given = false;
+                    result_given = false;
+                    continue;
+                }
+                if (!current) {
+                    throw CompileError("'" + keyword + "' outside a correlation block");
+                }
+                if (result_given && keyword != "end") {
+                    throw CompileError("'" + keyword + "' after 'nu'");
+                }
+
+                if (keyword == "side") {
+                    std::string side;
+                    fields >> side;
+                    if (side == "tube") current->correlation_side = Side::Tube;
+                    else if (side == "shell") current->correlation_side = Side::Shell;
+                    else throw CompileError("side must be 'tube' or 'shell'");
+                    side_given = true;
+                } else if (keyword == "valid") {
+                    std::string name;
+                    double low, high;
+                    if (!(fields >> name >> low >> high) || !(low <= high)) {
+                        throw CompileError("expected 'valid <variable> <min> <max>' with min <= max");
+                    }
+                    int variable = -1;
+                    for (int v = 0; v < VARIABLE_COUNT; ++v) {
+                        if (name == VARIABLE_NAMES[v]) variable = v;
+                    }
+                    if (variable < 0) {
+                        throw CompileError("unknown variable '" + name + "'");
+                    }
+                    current->valid_min[variable] = low;
+                    current->valid_max[variable] = high;
+                } else if (keyword == "outside") {
+                    std::string policy;
+                    fields >> policy;
+                    if (policy == "builtin") current->outside = OutsideRange::Builtin;
+                    else if (policy == "clamp") current->outside = OutsideRange::Clamp;
+                    else throw CompileError("outside must be 'builtin' or 'clamp'");
+                } else if (keyword == "let" || keyword == "nu") {
+                    std::string rest;
+                    std::getline(fields, rest);
+                    std::string name = keyword;
+                    if (keyword == "let") {
+                        std::istringstream binding(rest);
+                        binding >> name;
+                        std::getline(binding, rest);
+                        bool reserved = name == "nu" || name == "exp" || name == "log" || name == "log10" ||
+                                        name == "sqrt" || name == "abs" || name == "pow" || name == "min" || name == "max";
+                        for (int v = 0; v < VARIABLE_COUNT; ++v) {
+                            reserved = reserved || name == VARIABLE_NAMES[v];
+                        }
+                        if (name.empty() || reserved ||
+                            std::find(temporary_names.begin(), temporary_names.end(), name) != temporary_names.end()) {
+                            throw CompileError("'" + name + "' cannot be bound by let");
+                        }
+                    }
+                    size_t equals = rest.find('=');
+                    if (equals == std::string::npos || rest.find_first_not_of(" \t") != equals) {
+                        throw CompileError("expected '" + keyword + (keyword == "let" ? " <name>" : "") + " = <expression>'");
+                    }
+                    std::string expression = rest.substr(equals + 1);
+                    std::unique_ptr<Node> tree = Parser(expression, temporary_names, temporary_values).parse();
+                    if (keyword == "nu") {
+                        compiler->emitResult(*tree);
+                        result_given = true;
+                    } else if (tree->isNumber()) {
+                        temporary_names.push_back(name);
+                        temporary_values.push_back(std::move(tree));
+                    } else {
+                        compiler->emitStore(*tree, current->temporaries++);
+                        temporary_names.push_back(name);
+                        temporary_values.push_back(nullptr);
+                    }
+                } else if (keyword == "end") {
+                    if (!side_given) {
+                        throw CompileError("correlation '" + current->name() + "' has no 'side'");
+                    }
+                    if (!result_given) {
+                        throw CompileError("correlation '" + current->name() + "' has no 'nu = ...'");
+                    }
+                    if (current->stack_depth > 64) {
+                        throw CompileError("expression is nested too deeply");
+                    }
+                    compiled.push_back(current);
+                    current.reset();
+                    compiler.reset();
+                } else {
+                    throw CompileError("unknown keyword '" + keyword + "'");
+                }
+            }
+            if (current) {
+                ++line_number;
+                throw CompileError("correlation '" + current->name() + "' has no 'end'");
+            }
+        } catch (const CompileError& e) {
+            error = source_name + ":" + std::to_string(line_number) + ": " + e.what();
+            return false;
+        }
+
+        correlations.insert(correlations.end(), compiled.begin(), compiled.end());
+        return true;
+    }
+
+    std::shared_ptr<const Correlation> CorrelationLibrary::find(const std::string& name) const {
+        for (const auto& correlation : correlations) {
+            if (correlation->name() == name) {
+                return correlation;
+            }
+        }
+        return nullptr;
+    }
+
+    double getTubeSideNusselt(double reynolds, double prandtl, const Correlation& correlation,
+                              const GeometryRatios& ratios) {
+        if (correlation.side() != Side::Tube) {
+            throw std::invalid_argument("Correlation " + correlation.name() + " is not a tube-side correlation");
+        }
+        return correlation.evaluate(reynolds, prandtl, ratios);
+    }
+
+    double getShellSideNusselt(double reynolds, double prandtl, const Correlation& correlation,
+                               const GeometryRatios& ratios) {
+        if (correlation.side() != Side::Shell) {
+            throw std::invalid_argument("Correlation " + correlation.name() + " is not a shell-side correlation");
+        }
+        return correlation.evaluate(reynolds, prandtl, ratios);
+    }
+
+    std::string disassemble(const Correlation& correlation) {
+        std::ostringstream text;
+        text.precision(17);
+        for (const Instruction& instruction : correlation.program()) {
+            text << OP_NAMES[instruction.op];
+            switch (instruction.op) {
+                case OP_LOAD_VAR:
+                    text << " " << VARIABLE_NAMES[instruction.operand];
+                    break;
+                case OP_LOAD_TEMP:
+                case OP_STORE_TEMP:
+                    text << " t" << instruction.operand;
+                    break;
+                case OP_LOAD_CONST:
+                case OP_ADD_C: case OP_SUB_C: case OP_RSUB_C: case OP_MUL_C: case OP_DIV_C:
+                case OP_RDIV_C: case OP_POW_C: case OP_RPOW_C: case OP_MIN_C: case OP_MAX_C:
+                    text << " " << correlation.constantPool()[instruction.operand];
+                    break;
+                default:
+                    break;
+            }
+            text << "\n";
+        }
+        return text.str();
+    }
+
+} // namespace UserCorrelations
@@ -0,0 +1,195 @@
+#ifndef USER_CORRELATIONS_H
+#define USER_CORRELATIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fluid_properties.h"
+
+/**
+ * @file user_correlations.h
+ * @brief Nusselt correlations defined in a text file and compiled to bytecode at load time
+ *
+ * Text format (see correlations.txt):
+ *   correlation <name>
+ *   side tube | shell
+ *   valid <variable> <min> <max>      (optional, any number)
+ *   outside builtin | clamp           (optional, default builtin)
+ *   let <name> = <expression>         (optional intermediate values)
+ *   nu = <expression>
+ *   end
+ *
+ * Variables:
+ *   Re      Reynolds number
+ *   Pr      Prandtl number
+ *   d_L     tube inner diameter / tube length
+ *   do_di   tube outer / inner diameter
+ *   Ds_d    shell diameter / tube inner diameter
+ *   Nt      number of tubes
+ * Expressions use + - * / ^ (right associative), parentheses, numbers and
+ * exp, log, log10, sqrt, abs, pow(a, b), min(a, b) and max(a, b).
+ *
+ * Expressions are parsed and constant-folded. They are then compiled to a
+ * stack bytecode in which operations with a constant operand (x * c, x ^ c,
+ * c - x, ...) are single instructions, and x^2, x^0.5 and x^-1 become
+ * square, sqrt and reciprocal. The interpreter runs each instruction over a
+ * block of up to 256 points before moving on to the next, so decoding and
+ * dispatch are paid once per block rather than once per point. Points outside
+ * a validity range either fall back to the built-in correlation of the side
+ * (getTubeSideNusselt / getShellSideNusselt) or are clamped into the range.
+ */
+
+namespace UserCorrelations {
+
+    enum Variable {
+        REYNOLDS, PRANDTL, DIAMETER_OVER_LENGTH, OUTER_OVER_INNER, SHELL_OVER_TUBE, TUBE_COUNT,
+        VARIABLE_COUNT
+    };
+
+    enum class Side { Tube, Shell };
+
+    enum class OutsideRange {
+        Builtin,    // Use the side's built-in correlation
+        Clamp       // Evaluate at the nearest point of the validity box
+    };
+
+    /**
+     * Geometry variables of a correlation, shared by every point of a batch
+     */
+    struct GeometryRatios {
+        double diameter_over_length;    // d_L
+        double outer_over_inner;        // do_di
+        double shell_over_tube;         // Ds_d
+        double tube_count;              // Nt
+
+        GeometryRatios();
+        static GeometryRatios fromGeometry(const GeometryProperties& geometry);
+    };
+
+    struct Instruction {
+        std::uint8_t op;
+        std::int32_t operand;           // Variable, temporary or constant index
+    };
+
+    class Correlation {
+    public:
+        /** Points per interpreter block */
+        static const int BLOCK = 256;
+
+        const std::string& name() const { return correlation_name; }
+        Side side() const { return correlation_side; }
+        OutsideRange outsideRange() const { return outside; }
+        double validMin(Variable variable) const { return valid_min[variable]; }
+        double validMax(Variable variable) const { return valid_max[variable]; }
+        const std::vector<Instruction>& program() const { return code; }
+        const std::vector<double>& constantPool() const { return constants; }
+
+        /** @return true if the program or a validity range depends on a geometry variable */
+        bool usesGeometry() const;
+
+        /** @return true if every variable lies inside its validity range */
+        bool inRange(double reynolds, double prandtl, const GeometryRatios& ratios) const;
+
+        /**
+         * Nusselt number at one point
+         * @param reynolds Reynolds number
+         * @param prandtl Prandtl number
+         * @param ratios Geometry variables
+         * @return Nusselt number (validity policy applied)
+         */
+        double evaluate(double reynolds, double prandtl, const GeometryRatios& ratios = GeometryRatios()) const;
+
+        /**
+         * Nusselt numbers of a batch of points, one instruction at a time per block
+         * @param reynolds Reynolds numbers
+         * @param prandtl Prandtl numbers
+         * @param count Points
+         * @param ratios Geometry variables shared by the batch
+         * @param nusselt Receives count Nusselt numbers
+         */
+        void evaluate(const double* reynolds, const double* prandtl, std::size_t count,
+                      const GeometryRatios& ratios, double* nusselt) const;
+
+    private:
+        friend class Compiler;
+        friend class CorrelationLibrary;
+
+        std::string correlation_name;
+        Side correlation_side;
+        OutsideRange outside;
+        double valid_min[VARIABLE_COUNT];
+        double valid_max[VARIABLE_COUNT];
+        std::vector<Instruction> code;
+        std::vector<double> constants;
+        int temporaries;                // let bindings
+        int stack_depth;                // Largest operand stack the program needs
+        bool uses_variable[VARIABLE_COUNT];
+
+        Correlation();
+        void evaluateBlock(const double* reynolds, const double* prandtl, int count,
+                           const GeometryRatios& ratios, double* nusselt, double* scratch) const;
+    };
+
+    /**
+     * Correlations compiled from one or more text files
+     */
+    class CorrelationLibrary {
+    public:
+        /**
+         * Compile every correlation of a file and add it to the library
+         * @param path Correlation definitions
+         * @param error Receives "file:line: message" on failure
+         * @return false if the file cannot be read or does not compile (nothing is added)
+         */
+        bool load(const std::string& path, std::string& error);
+
+        /**
+         * Compile definitions held in a string
+         * @param source Correlation definitions
+         * @param source_name Name used in error messages
+         */
+        bool compile(const std::string& source, const std::string& source_name, std::string& error);
+
+        /** @return The named correlation, or nullptr */
+        std::shared_ptr<const Correlation> find(const std::string& name) const;
+
+        int size() const { return static_cast<int>(correlations.size()); }
+        std::shared_ptr<const Correlation> correlation(int index) const { return correlations[index]; }
+
+    private:
+        std::vector<std::shared_ptr<const Correlation>> correlations;
+    };
+
+    /**
+     * Tube side Nusselt number from a user correlation, the counterpart of
+     * HeatTransferCorrelations::getTubeSideNusselt() (throws std::invalid_argument
+     * for a shell-side correlation)
+     * @param reynolds Reynolds number
+     * @param prandtl Prandtl number
+     * @param correlation Tube-side user correlation
+     * @param ratios Geometry variables the correlation may use
+     * @return Nusselt number
+     */
+    double getTubeSideNusselt(double reynolds, double prandtl, const Correlation& correlation,
+                              const GeometryRatios& ratios);
+
+    /**
+     * Shell side Nusselt number from a user correlation (throws std::invalid_argument
+     * for a tube-side correlation)
+     * @param reynolds Reynolds number
+     * @param prandtl Prandtl number
+     * @param correlation Shell-side user correlation
+     * @param ratios Geometry variables the correlation may use
+     * @return Nusselt number
+     */
+    double getShellSideNusselt(double reynolds, double prandtl, const Correlation& correlation,
+                               const GeometryRatios& ratios);
+
+    /** @return Text of a compiled program, one instruction per line */
+    std::string disassemble(const Correlation& correlation);
+
+} // namespace UserCorrelations
+
+#endif // USER_CORRELATIONS_H